@@ -0,0 +1,303 @@
+#include "JupiterAllocationTrace.h"
+
+#include "JupiterAllocatorExceptions.h"
+
+#include <atomic>
+#include <bit>
+#include <iterator>
+#include <new>
+
+namespace Jupiter {
+
+	namespace {
+
+		constexpr uint8 trace_magic[4] = { 'J', 'T', 'R', 'C' };
+		constexpr size_t header_size = sizeof(trace_magic) + 1;
+
+		std::atomic<uint32> s_NextThread = 0;					// The index the next thread making a recorded call gets
+		thread_local uint32 t_ThreadIndex = ~(uint32)0;			// The index of the calling thread, assigned on its first recorded call
+
+		uint32 thread_index() {
+			if (t_ThreadIndex == ~(uint32)0) t_ThreadIndex = s_NextThread.fetch_add(1, std::memory_order_relaxed);
+			return t_ThreadIndex;
+		}
+
+		// Log2 of the alignment rounded up, every alignment the allocators support is a power of two
+		uint8 alignment_log2(size_t allignment) {
+			return allignment <= 1 ? 0 : (uint8)std::bit_width(allignment - 1);
+		}
+
+		// LEB128, seven bits per byte with the high bit set on every byte but the last
+		void write_varint(std::vector<uint8>& data, uint64 value) {
+			while (value >= 0x80) {
+				data.push_back((uint8)(value | 0x80));
+				value >>= 7;
+			}
+			data.push_back((uint8)value);
+		}
+
+		uint64 read_varint(const uint8*& data, const uint8* end) {
+			uint64 value = 0;
+			for (uint32 shift = 0; shift < 64; shift += 7) {
+				if (data == end) throw jpt_bad_trace("Allocation trace ends in the middle of an event!");
+				uint8 byte = *data++;
+				value |= (uint64)(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) return value;
+			}
+			throw jpt_bad_trace("Allocation trace contains a varint longer than 64 bits!");
+		}
+
+		// Writes to the first byte of every page of a block, so the allocator has to commit its memory
+		void touch_pages(void* p, size_t size) {
+			size_t pageSize = virtual_memory::page_size();
+			for (size_t offset = 0; offset < size; offset += pageSize) {
+				*reinterpret_cast<volatile uint8*>(pointer_functions::shift_forward(p, offset)) = 0;
+			}
+		}
+	}
+
+	// ----- TraceRecorder Start -----
+
+	TraceRecorder::TraceRecorder(IAllocator& allocator) :
+		m_Allocator(allocator), m_NextBlock(0), m_Events(0), m_Last(std::chrono::steady_clock::now())
+	{
+		m_Data.insert(m_Data.end(), std::begin(trace_magic), std::end(trace_magic));
+		m_Data.push_back(Version);
+	}
+
+	void* TraceRecorder::allocate(size_t size, size_t allignment) {
+		void* p = m_Allocator.allocate(size, allignment);
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Blocks[p] = { m_NextBlock, allignment };
+		record(EnumTraceOp::Allocate, allignment, m_NextBlock++, size);
+		return p;
+	}
+
+	void TraceRecorder::deallocate(void* p) {
+		uint64 block;
+		if (takeBlock(p, block)) {
+			// The free is recorded before the block is handed back, so another thread cannot get the same address first
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			record(EnumTraceOp::Deallocate, 1, block, 0);
+		}
+		m_Allocator.deallocate(p);
+	}
+
+	void TraceRecorder::deallocate(void* p, size_t size) {
+		uint64 block;
+		if (takeBlock(p, block)) {
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			record(EnumTraceOp::Deallocate, 1, block, 0);
+		}
+		m_Allocator.deallocate(p, size);
+	}
+
+	bool TraceRecorder::tryResize(void* p, size_t newSize) {
+		if (!m_Allocator.tryResize(p, newSize)) return false;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Blocks.find(p);
+		if (it != m_Blocks.end()) {
+			record(EnumTraceOp::Reallocate, it->second.allignment, it->second.id, newSize);
+			it->second.id = m_NextBlock++;
+		}
+		return true;
+	}
+
+	void* TraceRecorder::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		if (p == nullptr) return allocate(newSize, allignment);
+
+		// The old block is taken out before it can be freed, a block that moves frees its old address
+		uint64 block;
+		bool recorded = takeBlock(p, block);
+		void* moved;
+		try {
+			moved = m_Allocator.reallocate(p, oldSize, newSize, allignment);
+		}
+		catch (...) {
+			if (recorded) {
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Blocks[p] = { block, allignment };
+			}
+			throw;
+		}
+
+		if (recorded) {
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Blocks[moved] = { m_NextBlock, allignment };
+			record(EnumTraceOp::Reallocate, allignment, block, newSize);
+			m_NextBlock++;
+		}
+		return moved;
+	}
+
+	void TraceRecorder::write(std::ostream& stream) const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		stream.write(reinterpret_cast<const char*>(m_Data.data()), m_Data.size());
+	}
+
+	std::vector<uint8> TraceRecorder::getData() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Data;
+	}
+
+	size_t TraceRecorder::getEventCount() const {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Events;
+	}
+
+	void TraceRecorder::record(EnumTraceOp op, size_t allignment, uint64 block, size_t size) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		uint64 delta = (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_Last).count();
+		m_Last = now;
+
+		m_Data.push_back((uint8)((uint8)op | (alignment_log2(allignment) << 2)));
+		write_varint(m_Data, thread_index());
+		write_varint(m_Data, delta);
+		if (op != EnumTraceOp::Allocate) write_varint(m_Data, m_NextBlock - 1 - block);
+		if (op != EnumTraceOp::Deallocate) write_varint(m_Data, size);
+		m_Events++;
+	}
+
+	bool TraceRecorder::takeBlock(void* p, uint64& block) {
+		if (p == nullptr) return false;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		auto it = m_Blocks.find(p);
+		if (it == m_Blocks.end()) return false;
+
+		block = it->second.id;
+		m_Blocks.erase(it);
+		return true;
+	}
+
+	// ----- TraceRecorder End -----
+
+	std::vector<trace_event> allocation_trace::decode(const uint8* data, size_t size) {
+		if (size < header_size || !std::equal(std::begin(trace_magic), std::end(trace_magic), data)) {
+			throw jpt_bad_trace("Data is not an allocation trace!");
+		}
+		if (data[sizeof(trace_magic)] != TraceRecorder::Version) {
+			throw jpt_bad_trace("Allocation trace has an unsupported version!");
+		}
+
+		std::vector<trace_event> events;
+		const uint8* end = data + size;
+		data += header_size;
+		uint64 nextBlock = 0;
+
+		while (data != end) {
+			uint8 first = *data++;
+			trace_event event = {};
+			event.op = (EnumTraceOp)(first & 0x3);
+			event.allignment = (size_t)1 << (first >> 2);
+			if (event.op != EnumTraceOp::Allocate && event.op != EnumTraceOp::Deallocate && event.op != EnumTraceOp::Reallocate) {
+				throw jpt_bad_trace("Allocation trace contains an unknown op!");
+			}
+
+			event.thread = (uint32)read_varint(data, end);
+			event.timeDelta = read_varint(data, end);
+
+			if (event.op == EnumTraceOp::Allocate) {
+				event.block = nextBlock++;
+			}
+			else {
+				uint64 distance = read_varint(data, end);
+				if (distance >= nextBlock) throw jpt_bad_trace("Allocation trace refers to a block that was never allocated!");
+				event.block = nextBlock - 1 - distance;
+				if (event.op == EnumTraceOp::Reallocate) nextBlock++;
+			}
+			if (event.op != EnumTraceOp::Deallocate) event.size = (size_t)read_varint(data, end);
+
+			events.push_back(event);
+		}
+		return events;
+	}
+
+	std::vector<trace_event> allocation_trace::decode(const std::vector<uint8>& data) {
+		return decode(data.data(), data.size());
+	}
+
+	std::vector<trace_event> allocation_trace::read(std::istream& stream) {
+		std::vector<uint8> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		return decode(data);
+	}
+
+	allocation_trace::replay_result allocation_trace::replay(const std::vector<trace_event>& events, IAllocator& allocator) {
+		replay_result result = {};
+		std::vector<void*> blocks;
+		std::vector<size_t> sizes;
+		size_t live = 0;
+
+		// Both vectors are indexed by block id, sized up front so the replay itself does not touch the heap
+		size_t blockCount = 0;
+		for (const trace_event& event : events) {
+			if (event.op != EnumTraceOp::Deallocate) blockCount++;
+		}
+		blocks.resize(blockCount, nullptr);
+		sizes.resize(blockCount, 0);
+
+		allocator.resetStats();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		size_t nextBlock = 0;
+
+		for (const trace_event& event : events) {
+			switch (event.op) {
+			case EnumTraceOp::Allocate: {
+				size_t block = nextBlock++;
+				try {
+					blocks[block] = allocator.allocate(event.size, event.allignment);
+				}
+				catch (std::bad_alloc&) {
+					result.failedAllocations++;
+					break;
+				}
+				touch_pages(blocks[block], event.size);
+				sizes[block] = event.size;
+				live += event.size;
+				break;
+			}
+			case EnumTraceOp::Deallocate: {
+				void* p = blocks[event.block];
+				if (p == nullptr) break;
+				allocator.deallocate(p, sizes[event.block]);
+				blocks[event.block] = nullptr;
+				live -= sizes[event.block];
+				break;
+			}
+			case EnumTraceOp::Reallocate: {
+				size_t block = nextBlock++;
+				void* p = blocks[event.block];
+				if (p == nullptr) break;
+
+				// When the reallocation fails the old block stays live under its old id
+				try {
+					blocks[block] = allocator.reallocate(p, sizes[event.block], event.size, event.allignment);
+				}
+				catch (std::bad_alloc&) {
+					result.failedAllocations++;
+					break;
+				}
+				touch_pages(blocks[block], event.size);
+				blocks[event.block] = nullptr;
+				sizes[block] = event.size;
+				live = live - sizes[event.block] + event.size;
+				break;
+			}
+			}
+
+			if (live > result.peakRequestedBytes) result.peakRequestedBytes = live;
+		}
+
+		for (size_t block = 0; block < blocks.size(); block++) {
+			if (blocks[block] != nullptr) allocator.deallocate(blocks[block], sizes[block]);
+		}
+		result.nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+		result.operations = events.size();
+		const AllocatorStats* stats = allocator.getStats();
+		result.peakAllocatorBytes = stats != nullptr ? stats->getPeakBytes() : 0;
+		return result;
+	}
+}
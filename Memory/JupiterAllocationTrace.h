@@ -0,0 +1,153 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// The kind of call a trace event records
+	/// </summary>
+	enum class EnumTraceOp : uint8 {
+		Allocate = 0,			// A new block, it gets the next block id
+		Deallocate = 1,			// A block is freed
+		Reallocate = 2			// A block is resized, the result gets the next block id even when it did not move
+	};
+
+	/// <summary>
+	/// A single decoded event of an allocation trace.
+	/// Blocks are identified by the order they were allocated in, so a trace does not depend on the addresses of the recording process
+	/// </summary>
+	struct trace_event {
+		EnumTraceOp op;				// The kind of call
+		uint32 thread;				// Index of the thread that made the call, threads are numbered in the order of their first recorded call
+		uint64 timeDelta;			// Nanoseconds since the previous event
+		uint64 block;				// The id of the block that is allocated, freed or resized
+		size_t size;				// The size of a new or resized block, zero for a deallocation
+		size_t allignment;			// The alignment of a new or resized block
+	};
+
+	/// <summary>
+	/// Opt in layer over any IAllocator that records every call in a compact binary trace, eg. in a production build,
+	/// so the same sequence can be replayed against other allocators with allocation_trace::replay.
+	///
+	/// Every event starts with a byte holding the op in the low two bits and log2 of the alignment in the high six bits,
+	/// followed by LEB128 varints: the thread index, the nanoseconds since the previous event, and then per op
+	///		Allocate:	the size
+	///		Deallocate:	the distance of the block id to the newest block id
+	///		Reallocate:	the distance of the block id to the newest block id and the new size
+	/// Recent blocks are freed most often, so the distance is mostly a single byte. The trace starts with the magic bytes JTRC
+	/// and a version byte. Recording is thread safe as long as the wrapped allocator is, the events are appended under a lock.
+	///
+	/// Blocks that were not allocated through the recorder are passed on to the wrapped allocator without being recorded.
+	/// </summary>
+	class TraceRecorder final : public IAllocator {
+
+		/// <summary>
+		/// A live block allocated through the recorder
+		/// </summary>
+		struct recorded_block {
+			uint64 id;					// The id of the block, the order it was allocated in
+			size_t allignment;			// The alignment of the block, recorded again when the block is resized in place
+		};
+
+	public:
+		static constexpr uint8 Version = 1;				// The version of the trace format written by the recorder
+
+	public:
+		TraceRecorder() = delete;
+
+		/// <summary>
+		/// Creates a recorder around an allocator, the allocator needs to outlive the recorder
+		/// </summary>
+		/// <param name="allocator">The allocator every call is passed on to</param>
+		TraceRecorder(IAllocator& allocator);
+
+		TraceRecorder(const TraceRecorder&) = delete;					// Delete copy constructor, a trace belongs to a single recorder
+		TraceRecorder& operator=(const TraceRecorder&) = delete;		// Delete copy assignment operator
+
+		virtual ~TraceRecorder() override = default;
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Passes the allocation on and records it
+		virtual void deallocate(void* p) override;								// Passes the deallocation on and records it
+		virtual void deallocate(void* p, size_t size) override;					// Passes the deallocation on and records it
+		virtual bool tryResize(void* p, size_t newSize) override;				// Passes the resize on, a resize that succeeds is recorded as a reallocation
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;	// Passes the reallocation on and records it
+
+		virtual const AllocatorStats* getStats() const override { return m_Allocator.getStats(); }		// The statistics of the wrapped allocator
+		virtual void resetStats() override { m_Allocator.resetStats(); }								// Resets the statistics of the wrapped allocator
+
+		/// <summary>
+		/// Writes the trace recorded so far, eg. to a file opened in binary mode
+		/// </summary>
+		void write(std::ostream& stream) const;
+
+		/// <summary>
+		/// Gets a copy of the trace recorded so far, including the header
+		/// </summary>
+		std::vector<uint8> getData() const;
+
+		inline IAllocator& getAllocator() const { return m_Allocator; }		// The wrapped allocator
+		size_t getEventCount() const;										// The amount of events recorded so far
+
+	private:
+		void record(EnumTraceOp op, size_t allignment, uint64 block, size_t size);		// Appends an event, the lock needs to be held
+		bool takeBlock(void* p, uint64& block);											// Removes a block from the live blocks, false when it was not recorded
+
+	private:
+		IAllocator& m_Allocator;							// The allocator every call is passed on to
+
+		mutable std::mutex m_Mutex;							// Serializes the recording of events
+		std::vector<uint8> m_Data;							// The encoded trace, including the header
+		std::unordered_map<void*, recorded_block> m_Blocks;	// Every live block allocated through the recorder
+		uint64 m_NextBlock;									// The id the next new block gets
+		size_t m_Events;									// The amount of events recorded
+		std::chrono::steady_clock::time_point m_Last;		// The time of the previous event
+	};
+
+	/// <summary>
+	/// Namespace containing the functions to decode and replay allocation traces
+	/// </summary>
+	namespace allocation_trace {
+
+		/// <summary>
+		/// The outcome of replaying a trace against an allocator
+		/// </summary>
+		struct replay_result {
+			size_t operations;				// The amount of events replayed
+			size_t failedAllocations;		// The amount of allocations that threw std::bad_alloc, later events on those blocks are skipped
+			double nanoseconds;				// The time the replay took, including writing to every page of the new blocks
+			size_t peakRequestedBytes;		// The highest amount of bytes live at the same time, as requested by the trace
+			size_t peakAllocatorBytes;		// The peak bytes according to the statistics of the allocator, zero when it has none
+
+			/// <summary>
+			/// The share of the peak memory of the allocator that was not requested by the trace, lost to alignment and rounding up to
+			/// slot or block sizes. Free memory between blocks is not counted, it only shows in the resident memory of the process.
+			/// Zero when the allocator does not keep statistics
+			/// </summary>
+			inline double getFragmentation() const {
+				return peakAllocatorBytes > peakRequestedBytes ? 1.0 - (double)peakRequestedBytes / peakAllocatorBytes : 0.0;
+			}
+		};
+
+		/// <summary>
+		/// Decodes a trace written by a TraceRecorder
+		/// Throws jpt_bad_trace when the data is not a valid trace
+		/// </summary>
+		std::vector<trace_event> decode(const uint8* data, size_t size);
+		std::vector<trace_event> decode(const std::vector<uint8>& data);	// Decodes a trace written by a TraceRecorder
+		std::vector<trace_event> read(std::istream& stream);				// Reads and decodes a trace, eg. from a file opened in binary mode
+
+		/// <summary>
+		/// Drives an allocator through the calls of a trace, in the order they were recorded and without the delays between them.
+		/// The first byte of every page of a new block is written, so the memory is committed like in the recording process.
+		/// Blocks the trace never frees are freed at the end. The statistics of the allocator are reset before the replay starts
+		/// </summary>
+		/// <param name="events">The decoded trace</param>
+		/// <param name="allocator">The allocator the calls are made on</param>
+		replay_result replay(const std::vector<trace_event>& events, IAllocator& allocator);
+	}
+}
@@ -1,11 +1,75 @@
 #include "JupiterAllocator.h"
 
 #include "JupiterAllocatorExceptions.h"
+#include "JupiterVirtualMemory.h"
 
 #include <stdlib.h>
+#include <bit>
+#include <cstddef>
+#include <cstring>
 
 namespace Jupiter {
 
+	void* IAllocator::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		if (p == nullptr) return allocate(newSize, allignment);
+		if (tryResize(p, newSize)) return p;
+
+		// Move the block, the old block is only freed once the new block is allocated
+		void* moved = allocate(newSize, allignment);
+		memcpy(moved, p, oldSize < newSize ? oldSize : newSize);
+		deallocate(p, oldSize);
+		return moved;
+	}
+
+	// ----- MallocAllocator Start -----
+
+	void* MallocAllocator::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	void* MallocAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
+#ifdef _WIN32
+		// Blocks from _aligned_malloc can only be released with _aligned_free, so every block goes through it
+		return _aligned_malloc(size > 0 ? size : 1, allignment > alignof(void*) ? allignment : alignof(void*));
+#else
+		if (allignment <= alignof(std::max_align_t)) return malloc(size > 0 ? size : 1);
+
+		void* p = nullptr;
+		if (posix_memalign(&p, allignment, size > 0 ? size : 1) != 0) return nullptr;
+		return p;
+#endif
+	}
+
+	void MallocAllocator::deallocate(void* p) {
+#ifdef _WIN32
+		_aligned_free(p);
+#else
+		free(p);
+#endif
+	}
+
+	void MallocAllocator::deallocate(void* p, size_t size) {
+		deallocate(p);
+	}
+
+	void* MallocAllocator::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+#ifdef _WIN32
+		void* moved = _aligned_realloc(p, newSize > 0 ? newSize : 1, allignment > alignof(void*) ? allignment : alignof(void*));
+#else
+		// realloc only keeps the alignment malloc guarantees, larger alignments move the block by hand
+		if (allignment > alignof(std::max_align_t)) return IAllocator::reallocate(p, oldSize, newSize, allignment);
+		void* moved = realloc(p, newSize > 0 ? newSize : 1);
+#endif
+		if (moved == nullptr) throw std::bad_alloc();
+		return moved;
+	}
+
+	// ----- MallocAllocator End -----
+
 	// This construct is kindoff a mess, clean this up soontm
 	StackAllocator::StackAllocator(size_t size) {
 		void* data = nullptr;
@@ -31,31 +95,88 @@ namespace Jupiter {
 			// Set the top of the stack to the start of the stack
 			m_Top = m_Start;
 		}
+
+		// A heap backed stack is committed entirely
+		m_Committed = pointer_functions::shift_forward(m_Start, m_Size);
+	}
+
+	StackAllocator::StackAllocator(size_t size, EnumStackBacking backing, size_t decommitWatermark) {
+		m_Backing = backing;
+		m_DecommitWatermark = decommitWatermark;
+
+		switch (backing) {
+			case EnumStackBacking::Heap: {
+				// Allocate and commit the entire memory block up front
+				m_Start = malloc(size);
+				m_Size = size;
+				m_Committed = pointer_functions::shift_forward(m_Start, m_Size);
+				break;
+			}
+			case EnumStackBacking::Virtual: {
+				// Reserve the address range, no memory is committed until the top reaches it
+				size_t pageSize = virtual_memory::page_size();
+				m_Size = (size + pageSize - 1) & ~(pageSize - 1);
+				m_Start = virtual_memory::reserve(m_Size);
+				m_Committed = m_Start;
+				break;
+			}
+			case EnumStackBacking::HugePages: {
+				// Allocate and commit the entire memory block up front, rounded up to whole huge pages
+				m_Size = (size + virtual_memory::HugePageSize - 1) & ~(virtual_memory::HugePageSize - 1);
+				m_Start = virtual_memory::allocate_huge(m_Size, m_PageBacking);
+				m_Committed = pointer_functions::shift_forward(m_Start, m_Size);
+				break;
+			}
+			case EnumStackBacking::VirtualHugePages: {
+				// Reserve the address range rounded up to whole huge pages, pages are committed a huge page at a time
+				m_Size = (size + virtual_memory::HugePageSize - 1) & ~(virtual_memory::HugePageSize - 1);
+				m_Start = virtual_memory::reserve_huge(m_Size, m_PageBacking);
+				m_Committed = m_Start;
+				break;
+			}
+		}
+
+		if (m_Start == nullptr) throw std::bad_alloc();
+		m_Top = m_Start;
 	}
 
 	StackAllocator::~StackAllocator() {
-		if (m_Allocations != 0) {
-			// Warn the user that the allocator was deleted but not all allocations were freed
+		if (m_Allocations != 0 || m_UsedMemory != 0) {
+			allocator_stats::reportLeak("StackAllocator", m_Allocations, m_UsedMemory);
 		}
-		if (m_UsedMemory != 0) {
-			// Warn the user that the allocator was deleted but not all memory was freed
+		if (m_Backing == EnumStackBacking::Heap) free(m_Start);
+		else virtual_memory::release(m_Start, m_Size);
+	}
+
+	void* StackAllocator::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
 		}
-		free(m_Start);
+		return p;
 	}
 
-	void* StackAllocator::allocate(size_t size, uint8 allignment) {
+	void* StackAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
 		// Calculate the adjustment based on the current top of the stack and the desired allignment
-		uint8 adjustment = pointer_functions::calc_forward_alignment_adjustment(m_Top, allignment);
+		size_t adjustment = pointer_functions::calc_forward_alignment_adjustment(m_Top, allignment);
 
 		// Calculate the total size of the block by adding the adjustment and the payload size
 		size_t totalSize = size + adjustment;
 
+		// The new size exceeded the amount allocated memory in this allocator!
+		size_t available = reinterpret_cast<uintptr_t>(m_Start) + m_Size - reinterpret_cast<uintptr_t>(m_Top);
+		if (totalSize > available) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+
 		// Get the new top of the stack by adding the total size of the allocated memory to the current top of the stack
 		void* top = pointer_functions::shift_forward(m_Top, totalSize);
 
-		// The new size exceeded the amount allocated memory in this allocator!
-		if (!(reinterpret_cast<uintptr_t>(top) < m_Size)) {
-			throw std::bad_alloc();
+		// Commit the pages the block spans when the stack is virtual backed
+		if (top > m_Committed && !commit(top)) {
+			m_Stats.recordFailure();
+			return nullptr;
 		}
 
 		// Get the start of the newly allocated block of memory adjusted for alignment
@@ -63,8 +184,10 @@ namespace Jupiter {
 
 		// Set the new top, increment the number of allocations and add the total size to used memory
 		m_Top = top;
+		m_Last = start;
 		m_Allocations++;
 		m_UsedMemory += totalSize;
+		m_Stats.recordAllocation(size, totalSize);
 
 		// Return the start of the allocated memory block
 		return start;
@@ -83,10 +206,43 @@ namespace Jupiter {
 		throw jpt_bad_free("Stack allocator cannot deallocate memory using this function, use clear or free instead!");
 	}
 
+	bool StackAllocator::tryResize(void* p, size_t newSize) {
+		// Only the most recent allocation ends at the top of the stack
+		if (p == nullptr || p != m_Last) return false;
+
+		size_t available = reinterpret_cast<uintptr_t>(m_Start) + m_Size - reinterpret_cast<uintptr_t>(p);
+		if (newSize > available) return false;
+
+		void* top = pointer_functions::shift_forward(p, newSize);
+		if (top > m_Committed && !commit(top)) return false;
+
+		// Moving the top changes the used memory by the same amount, the alignment adjustment of the block stays counted
+		m_Stats.recordResize(reinterpret_cast<uintptr_t>(m_Top) - reinterpret_cast<uintptr_t>(p), newSize);
+		m_UsedMemory = m_UsedMemory + reinterpret_cast<uintptr_t>(top) - reinterpret_cast<uintptr_t>(m_Top);
+		m_Top = top;
+		return true;
+	}
+
+	void* StackAllocator::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		if (p == nullptr) return allocate(newSize, allignment);
+		if (tryResize(p, newSize)) return p;
+
+		// The old block stays on the stack until it is freed together with the blocks around it
+		void* moved = allocate(newSize, allignment);
+		memcpy(moved, p, oldSize < newSize ? oldSize : newSize);
+		return moved;
+	}
+
+	bool StackAllocator::owns(void* p) const {
+		uintptr_t address = reinterpret_cast<uintptr_t>(p);
+		uintptr_t start = reinterpret_cast<uintptr_t>(m_Start);
+		return address >= start && address < start + m_Size;
+	}
+
 	StackAllocator::stack_marker StackAllocator::mark() {
 		// Calculate the block size and get the alignment value of the stack_marker
 		size_t blockSize = sizeof(m_UsedMemory) + sizeof(m_Allocations);
-		uint8 alignment = __alignof(m_UsedMemory);
+		size_t alignment = __alignof(m_UsedMemory);
 
 		// Allocate the marker, and get the the memory addresses of the values to set
 		void* marker = allocate(blockSize, alignment);
@@ -113,11 +269,645 @@ namespace Jupiter {
 		// Set the top of the stack to the address after the marker
 		size_t blockSize = sizeof(m_UsedMemory) + sizeof(m_Allocations);
 		m_Top = pointer_functions::shift_forward(marker, blockSize);
+		m_Last = nullptr;
+		m_Stats.recordRewind(m_UsedMemory, m_Allocations);
+
+		decommit();
 	}
 
 	void StackAllocator::clear() {
 		m_Top = m_Start;
+		m_Last = nullptr;
 		m_UsedMemory = 0;
 		m_Allocations = 0;
+		m_Stats.recordRewind(0, 0);
+
+		decommit();
+	}
+
+	StackAllocator::stack_state StackAllocator::getState() {
+		stack_state state = { m_Top, m_Last, m_UsedMemory, m_Allocations };
+
+		// The snapshot keeps the most recent allocation, restoring it makes the block resizable again
+		m_Last = nullptr;
+		return state;
+	}
+
+	void StackAllocator::restore(const stack_state& state) {
+		m_Top = state.top;
+		m_Last = state.last;
+		m_UsedMemory = state.usedMemory;
+		m_Allocations = state.allocations;
+		m_Stats.recordRewind(m_UsedMemory, m_Allocations);
+
+		decommit();
+	}
+
+	bool StackAllocator::commit(void* top) {
+		// Commit at least the commit granularity at once, so a stack that grows slowly does not commit page by page
+		// Huge page backed stacks commit whole huge pages, so the system can back them with a single huge page
+		size_t granularity = m_Backing == EnumStackBacking::VirtualHugePages ? virtual_memory::HugePageSize : CommitGranularity;
+		uintptr_t start = reinterpret_cast<uintptr_t>(m_Start);
+		uintptr_t committed = reinterpret_cast<uintptr_t>(m_Committed);
+		uintptr_t end = start + m_Size;
+
+		uintptr_t target = reinterpret_cast<uintptr_t>(top);
+		if (target - committed < granularity) target = committed + granularity;
+		target = start + ((target - start + granularity - 1) & ~(granularity - 1));
+		if (target > end) target = end;
+
+		if (!virtual_memory::commit(m_Committed, target - committed)) return false;
+		m_Committed = reinterpret_cast<void*>(target);
+		return true;
+	}
+
+	void StackAllocator::decommit() {
+		bool virtualBacked = m_Backing == EnumStackBacking::Virtual || m_Backing == EnumStackBacking::VirtualHugePages;
+		if (!virtualBacked || m_DecommitWatermark == NoDecommit) return;
+
+		// Keep everything below the top and the watermark committed, rounded up to whole (huge) pages
+		size_t pageSize = m_Backing == EnumStackBacking::VirtualHugePages ? virtual_memory::HugePageSize : virtual_memory::page_size();
+		uintptr_t start = reinterpret_cast<uintptr_t>(m_Start);
+		size_t keep = reinterpret_cast<uintptr_t>(m_Top) - start;
+		if (keep < m_DecommitWatermark) keep = m_DecommitWatermark;
+		keep = (keep + pageSize - 1) & ~(pageSize - 1);
+
+		uintptr_t committed = reinterpret_cast<uintptr_t>(m_Committed);
+		if (start + keep < committed) {
+			virtual_memory::decommit(reinterpret_cast<void*>(start + keep), committed - (start + keep));
+			m_Committed = reinterpret_cast<void*>(start + keep);
+		}
+	}
+
+	ConcurrentStackAllocator::ConcurrentStackAllocator(size_t size) :
+		m_Start(nullptr), m_Size(0), m_Top(0), m_Allocations(0)
+	{
+		// Allocate the memory
+		m_Start = malloc(size);
+		if (m_Start == nullptr) throw std::bad_alloc();
+
+		m_Size = size;
+		m_Top.store(reinterpret_cast<uintptr_t>(m_Start), std::memory_order_relaxed);
+	}
+
+	ConcurrentStackAllocator::~ConcurrentStackAllocator() {
+		free(m_Start);
+	}
+
+	void* ConcurrentStackAllocator::allocate(size_t size, size_t allignment) {
+		uintptr_t end = reinterpret_cast<uintptr_t>(m_Start) + m_Size;
+		uintptr_t top = m_Top.load(std::memory_order_relaxed);
+		uintptr_t start;
+		uintptr_t newTop;
+
+		// Every thread calculates its block from the top it has seen, the compare and swap only succeeds when no other thread
+		// moved the top in the meantime, otherwise the block is recalculated from the new top
+		do {
+			start = top + pointer_functions::calc_forward_alignment_adjustment(reinterpret_cast<void*>(top), allignment);
+			if (start > end || size > end - start) {
+				throw std::bad_alloc();
+			}
+			newTop = start + size;
+		} while (!m_Top.compare_exchange_weak(top, newTop, std::memory_order_relaxed, std::memory_order_relaxed));
+
+		m_Allocations.fetch_add(1, std::memory_order_relaxed);
+		return reinterpret_cast<void*>(start);
+	}
+
+	void ConcurrentStackAllocator::deallocate(void* p) {
+		throw jpt_bad_free("Concurrent stack allocator cannot deallocate memory using this function, use clear instead!");
+	}
+
+	void ConcurrentStackAllocator::deallocate(void* p, size_t size) {
+		throw jpt_bad_free("Concurrent stack allocator cannot deallocate memory using this function, use clear instead!");
+	}
+
+	void* ConcurrentStackAllocator::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		// Another thread may have moved the top past the block, so the block is always copied
+		void* moved = allocate(newSize, allignment);
+		if (p != nullptr) memcpy(moved, p, oldSize < newSize ? oldSize : newSize);
+		return moved;
+	}
+
+	void ConcurrentStackAllocator::clear() {
+		m_Top.store(reinterpret_cast<uintptr_t>(m_Start), std::memory_order_relaxed);
+		m_Allocations.store(0, std::memory_order_relaxed);
+	}
+
+	// ----- DoubleEndedStackAllocator Start -----
+
+	DoubleEndedStackAllocator::DoubleEndedStackAllocator(size_t size) :
+		m_Start(nullptr), m_Size(0), m_Bottom(nullptr), m_Top(nullptr), m_UsedMemory{}, m_Allocations{}
+	{
+		// Allocate the memory
+		m_Start = malloc(size);
+		if (m_Start == nullptr) throw std::bad_alloc();
+
+		m_Size = size;
+		m_Bottom = m_Start;
+		m_Top = pointer_functions::shift_forward(m_Start, m_Size);
+	}
+
+	DoubleEndedStackAllocator::~DoubleEndedStackAllocator() {
+		if (m_Allocations[0] != 0 || m_Allocations[1] != 0) {
+			allocator_stats::reportLeak("DoubleEndedStackAllocator", m_Allocations[0] + m_Allocations[1], m_UsedMemory[0] + m_UsedMemory[1]);
+		}
+		free(m_Start);
+	}
+
+	void* DoubleEndedStackAllocator::allocate(size_t size, size_t allignment) {
+		return allocate(EnumStackSide::Bottom, size, allignment);
+	}
+
+	void* DoubleEndedStackAllocator::allocate(EnumStackSide side, size_t size, size_t allignment) {
+		void* p = tryAllocate(side, size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	void* DoubleEndedStackAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
+		return tryAllocate(EnumStackSide::Bottom, size, allignment);
+	}
+
+	void* DoubleEndedStackAllocator::tryAllocate(EnumStackSide side, size_t size, size_t allignment) noexcept {
+		// Every byte between the two tops is free, a block that does not fit in it would collide with the other stack
+		size_t available = getFreeMemory();
+		if (size > available) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+
+		void* start;
+		size_t totalSize;
+		if (side == EnumStackSide::Bottom) {
+			// The bottom stack moves its top forward, the block starts after the forward alignment adjustment
+			size_t adjustment = pointer_functions::calc_forward_alignment_adjustment(m_Bottom, allignment);
+			totalSize = size + adjustment;
+			if (totalSize > available) {
+				m_Stats.recordFailure();
+				return nullptr;
+			}
+
+			start = pointer_functions::shift_forward(m_Bottom, adjustment);
+			m_Bottom = pointer_functions::shift_forward(m_Bottom, totalSize);
+		}
+		else {
+			// The top stack moves its top backward, the block starts at the new top after the backward alignment adjustment
+			start = pointer_functions::shift_back(m_Top, size);
+			size_t adjustment = pointer_functions::calc_backward_alignment_adjustment(start, allignment);
+			totalSize = size + adjustment;
+			if (totalSize > available) {
+				m_Stats.recordFailure();
+				return nullptr;
+			}
+
+			start = pointer_functions::shift_back(start, adjustment);
+			m_Top = start;
+		}
+
+		m_Allocations[(int)side]++;
+		m_UsedMemory[(int)side] += totalSize;
+		m_Stats.recordAllocation(size, totalSize);
+		return start;
+	}
+
+	void DoubleEndedStackAllocator::deallocate(void* p) {
+		throw jpt_bad_free("Double ended stack allocator cannot deallocate memory using this function, use clear or free instead!");
+	}
+
+	void DoubleEndedStackAllocator::deallocate(void* p, size_t size) {
+		throw jpt_bad_free("Double ended stack allocator cannot deallocate memory using this function, use clear or free instead!");
+	}
+
+	void* DoubleEndedStackAllocator::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		// The old block stays on its stack until it is freed together with the blocks around it
+		void* moved = allocate(newSize, allignment);
+		if (p != nullptr) memcpy(moved, p, oldSize < newSize ? oldSize : newSize);
+		return moved;
+	}
+
+	bool DoubleEndedStackAllocator::owns(void* p) const {
+		uintptr_t address = reinterpret_cast<uintptr_t>(p);
+		uintptr_t start = reinterpret_cast<uintptr_t>(m_Start);
+		return address >= start && address < start + m_Size;
+	}
+
+	DoubleEndedStackAllocator::stack_marker DoubleEndedStackAllocator::mark(EnumStackSide side) {
+		// Snapshot the used memory and allocations of the side before the marker itself is allocated
+		size_t usedMemory = m_UsedMemory[(int)side];
+		size_t allocations = m_Allocations[(int)side];
+
+		void* marker = allocate(side, sizeof(usedMemory) + sizeof(allocations), __alignof(size_t));
+		reinterpret_cast<size_t*>(marker)[0] = usedMemory;
+		reinterpret_cast<size_t*>(marker)[1] = allocations;
+		return marker;
+	}
+
+	void DoubleEndedStackAllocator::freeForward(EnumStackSide side, stack_marker marker) {
+		// Everything allocated after the marker lies above it on the bottom stack and below it on the top stack,
+		// so the marker is freed together with the blocks allocated after it
+		m_UsedMemory[(int)side] = reinterpret_cast<size_t*>(marker)[0];
+		m_Allocations[(int)side] = reinterpret_cast<size_t*>(marker)[1];
+
+		size_t used = m_UsedMemory[(int)side];
+		if (side == EnumStackSide::Bottom) m_Bottom = pointer_functions::shift_forward(m_Start, used);
+		else m_Top = pointer_functions::shift_forward(m_Start, m_Size - used);
+		m_Stats.recordRewind(m_UsedMemory[0] + m_UsedMemory[1], m_Allocations[0] + m_Allocations[1]);
+	}
+
+	void DoubleEndedStackAllocator::clear(EnumStackSide side) {
+		if (side == EnumStackSide::Bottom) m_Bottom = m_Start;
+		else m_Top = pointer_functions::shift_forward(m_Start, m_Size);
+
+		m_UsedMemory[(int)side] = 0;
+		m_Allocations[(int)side] = 0;
+		m_Stats.recordRewind(m_UsedMemory[0] + m_UsedMemory[1], m_Allocations[0] + m_Allocations[1]);
+	}
+
+	void DoubleEndedStackAllocator::clear() {
+		clear(EnumStackSide::Bottom);
+		clear(EnumStackSide::Top);
+	}
+
+	// ----- DoubleEndedStackAllocator End -----
+
+	// ----- BlockAllocator Start -----
+
+	namespace tlsf {
+
+		/// <summary>
+		/// Header of every block in the block allocator.
+		/// The previous physical block pointer is stored in the last bytes of the previous block, so it is only valid when the
+		/// previous block is free. The free list pointers are stored in the payload, so they are only valid when the block is free.
+		/// A used block therefore only has the size as overhead.
+		/// The two lowest bits of the size are used as flags, since every block size is a multiple of the alignment
+		/// </summary>
+		struct block_header {
+			block_header* prevPhysical;		// The previous block in memory, only valid when the previous block is free
+			size_t size;					// The size of the payload of the block and the flags in the lowest bits
+
+			block_header* nextFree;			// The next block in the free list
+			block_header* prevFree;			// The previous block in the free list
+		};
+
+		constexpr size_t block_flag_free = 1 << 0;					// Flag set when the block is free
+		constexpr size_t block_flag_prev_free = 1 << 1;				// Flag set when the previous block is free
+		constexpr size_t block_flags = block_flag_free | block_flag_prev_free;
+
+		constexpr size_t block_overhead = sizeof(size_t);											// The overhead of a used block
+		constexpr size_t block_start_offset = offsetof(block_header, size) + sizeof(size_t);		// Offset from the header to the payload
+		constexpr size_t block_size_min = sizeof(block_header) - sizeof(block_header*);				// The smallest payload a block can have
+		constexpr size_t block_size_max = (size_t)1 << BlockAllocator::FirstLevelIndexMax;		// The largest payload a block can have
+
+		inline size_t block_size(const block_header* block) { return block->size & ~block_flags; }
+		inline void block_set_size(block_header* block, size_t size) { block->size = size | (block->size & block_flags); }
+
+		inline bool block_is_free(const block_header* block) { return (block->size & block_flag_free) != 0; }
+		inline void block_set_free(block_header* block) { block->size |= block_flag_free; }
+		inline void block_set_used(block_header* block) { block->size &= ~block_flag_free; }
+
+		inline bool block_is_prev_free(const block_header* block) { return (block->size & block_flag_prev_free) != 0; }
+		inline void block_set_prev_free(block_header* block) { block->size |= block_flag_prev_free; }
+		inline void block_set_prev_used(block_header* block) { block->size &= ~block_flag_prev_free; }
+
+		inline void* block_to_ptr(block_header* block) { return pointer_functions::shift_forward(block, block_start_offset); }
+		inline block_header* block_from_ptr(void* p) { return reinterpret_cast<block_header*>(pointer_functions::shift_back(p, block_start_offset)); }
+
+		// Gets the next block in memory, the header of the next block overlaps the last bytes of the payload of this block
+		inline block_header* block_next(block_header* block) {
+			return reinterpret_cast<block_header*>(pointer_functions::shift_forward(block_to_ptr(block), block_size(block) - block_overhead));
+		}
+
+		// Gets the next block in memory and lets it point back to this block
+		inline block_header* block_link_next(block_header* block) {
+			block_header* next = block_next(block);
+			next->prevPhysical = block;
+			return next;
+		}
+
+		inline void block_mark_as_free(block_header* block) {
+			block_header* next = block_link_next(block);
+			block_set_prev_free(next);
+			block_set_free(block);
+		}
+
+		inline void block_mark_as_used(block_header* block) {
+			block_header* next = block_next(block);
+			block_set_prev_used(next);
+			block_set_used(block);
+		}
+
+		inline bool block_can_split(const block_header* block, size_t size) { return block_size(block) >= sizeof(block_header) + size; }
+
+		// Splits a block in two, the first block keeps the given size and the remaining block is returned as a free block
+		inline block_header* block_split(block_header* block, size_t size) {
+			block_header* remaining = reinterpret_cast<block_header*>(pointer_functions::shift_forward(block_to_ptr(block), size - block_overhead));
+			size_t remainingSize = block_size(block) - (size + block_overhead);
+
+			remaining->size = 0;
+			block_set_size(remaining, remainingSize);
+			block_set_size(block, size);
+			block_mark_as_free(remaining);
+			return remaining;
+		}
+
+		// Absorbs a free block into the previous block
+		inline block_header* block_absorb(block_header* prev, block_header* block) {
+			block_set_size(prev, block_size(prev) + block_size(block) + block_overhead);
+			block_link_next(prev);
+			return prev;
+		}
+
+		inline size_t align_up(size_t x, size_t alignment) { return (x + (alignment - 1)) & ~(alignment - 1); }
+		inline size_t align_down(size_t x, size_t alignment) { return x - (x & (alignment - 1)); }
+
+		// Rounds a requested size up to a block size, returns 0 when the size cannot be satisfied
+		inline size_t adjust_request_size(size_t size, size_t alignment) {
+			size_t aligned = align_up(size, alignment);
+			if (aligned >= block_size_max) return 0;
+			return aligned > block_size_min ? aligned : block_size_min;
+		}
+
+		// Index of the most significant set bit
+		inline uint32 fls(size_t x) { return (uint32)(std::bit_width(x) - 1); }
+
+		// Index of the least significant set bit
+		inline uint32 ffs(uint32 x) { return (uint32)std::countr_zero(x); }
+
+		// Calculates the first and second level index of the list a block of the given size belongs to
+		inline void mapping_insert(size_t size, uint32& fl, uint32& sl) {
+			if (size < BlockAllocator::SmallBlockSize) {
+				fl = 0;
+				sl = (uint32)(size / (BlockAllocator::SmallBlockSize / BlockAllocator::SecondLevelIndexCount));
+			}
+			else {
+				fl = fls(size);
+				sl = (uint32)(size >> (fl - BlockAllocator::SecondLevelIndexCountLog2)) ^ (1 << BlockAllocator::SecondLevelIndexCountLog2);
+				fl -= (BlockAllocator::FirstLevelIndexShift - 1);
+			}
+		}
+
+		// Calculates the first and second level index of the first list where every block is large enough for the given size
+		inline void mapping_search(size_t size, uint32& fl, uint32& sl) {
+			if (size >= BlockAllocator::SmallBlockSize) {
+				size += ((size_t)1 << (fls(size) - BlockAllocator::SecondLevelIndexCountLog2)) - 1;
+			}
+			mapping_insert(size, fl, sl);
+		}
+	}
+
+	BlockAllocator::BlockAllocator(size_t size) :
+		m_Start(nullptr), m_Size(0), m_FirstLevelBitmap(0), m_SecondLevelBitmap{}, m_FreeBlocks{}, m_UsedMemory(0), m_Allocations(0)
+	{
+		using namespace tlsf;
+
+		// The memory block needs room for the size of the first block and the size of the sentinel block at the end
+		size_t poolSize = align_down(size, AlignSize);
+		if (poolSize < block_size_min + 2 * block_overhead) throw std::bad_alloc();
+		size_t blockSize = poolSize - 2 * block_overhead;
+		if (blockSize > block_size_max) throw std::bad_alloc();
+
+		// Allocate the memory
+		m_Start = malloc(poolSize);
+		if (m_Start == nullptr) throw std::bad_alloc();
+		m_Size = poolSize;
+
+		// Create the initial free block spanning the entire memory block
+		// The block header starts before the memory block, since the previous physical pointer is never accessed for the first block
+		block_header* block = reinterpret_cast<block_header*>(pointer_functions::shift_back(m_Start, block_overhead));
+		block->size = 0;
+		block_set_size(block, blockSize);
+		block_set_free(block);
+		block_set_prev_used(block);
+		insertFreeBlock(block);
+
+		// Create the sentinel block, a used zero sized block at the end so block_next never walks out of the memory block
+		block_header* sentinel = block_link_next(block);
+		sentinel->size = 0;
+		block_set_used(sentinel);
+		block_set_prev_free(sentinel);
+	}
+
+	BlockAllocator::~BlockAllocator() {
+		free(m_Start);
+	}
+
+	void* BlockAllocator::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	void* BlockAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
+		using namespace tlsf;
+
+		// Calculate the size of the block, when the alignment is larger then the minimal alignment a larger block is needed
+		// so there is room to move the payload forward and split of the gap in front of it as a free block
+		size_t adjusted = adjust_request_size(size, AlignSize);
+		size_t gapMinimum = sizeof(block_header);
+		size_t searchSize = adjusted;
+		if (adjusted != 0 && allignment > AlignSize) searchSize = adjust_request_size(adjusted + allignment + gapMinimum, allignment);
+
+		block_header* block = searchSize != 0 ? locateFreeBlock(searchSize) : nullptr;
+		if (block == nullptr) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+
+		if (allignment > AlignSize) {
+			// Move the payload forward to the aligned address, the gap needs to be large enough to hold a free block header
+			uintptr_t ptr = reinterpret_cast<uintptr_t>(block_to_ptr(block));
+			uintptr_t aligned = align_up(ptr, allignment);
+			size_t gap = aligned - ptr;
+
+			if (gap != 0 && gap < gapMinimum) {
+				size_t gapRemain = gapMinimum - gap;
+				size_t offset = gapRemain > allignment ? gapRemain : allignment;
+				aligned = align_up(aligned + offset, allignment);
+				gap = aligned - ptr;
+			}
+
+			if (gap != 0) block = trimFreeLeading(block, gap);
+		}
+
+		// Split of the unused tail of the block and mark the block as used
+		trimFree(block, adjusted);
+		block_mark_as_used(block);
+
+		m_Allocations++;
+		m_UsedMemory += block_size(block);
+		m_Stats.recordAllocation(size, block_size(block));
+		return block_to_ptr(block);
+	}
+
+	void BlockAllocator::deallocate(void* p) {
+		if (p == nullptr) return;
+
+		tlsf::block_header* block = tlsf::block_from_ptr(p);
+		if (tlsf::block_is_free(block)) {
+			throw jpt_bad_free("Block allocator cannot deallocate a block that is already free!");
+		}
+		freeBlock(block);
+	}
+
+	void BlockAllocator::deallocate(void* p, size_t size) {
+		if (p == nullptr) return;
+
+		tlsf::block_header* block = tlsf::block_from_ptr(p);
+		if (tlsf::block_is_free(block) || size > tlsf::block_size(block)) {
+			throw jpt_bad_free("Block allocator cannot deallocate a block that is free or smaller then the given size!");
+		}
+		freeBlock(block);
+	}
+
+	bool BlockAllocator::tryResize(void* p, size_t newSize) {
+		using namespace tlsf;
+
+		if (p == nullptr) return false;
+		block_header* block = block_from_ptr(p);
+		size_t adjusted = adjust_request_size(newSize, AlignSize);
+		if (block_is_free(block) || adjusted == 0) return false;
+
+		// Growing absorbs the next block, which is only possible when it is free and the two blocks together are large enough
+		size_t size = block_size(block);
+		if (adjusted > size) {
+			block_header* next = block_next(block);
+			if (!block_is_free(next) || size + block_size(next) + block_overhead < adjusted) return false;
+
+			removeFreeBlock(next);
+			block_absorb(block, next);
+			block_mark_as_used(block);
+		}
+
+		// Split of the unused tail, when shrinking the block after it can be free so the tail is merged with it
+		// The tail does not link back to the block, that pointer overlaps the last bytes of the payload that is kept
+		if (block_can_split(block, adjusted)) {
+			block_header* remaining = block_split(block, adjusted);
+			block_set_prev_used(remaining);
+			insertFreeBlock(mergeNext(remaining));
+		}
+
+		m_UsedMemory = m_UsedMemory - size + block_size(block);
+		m_Stats.recordResize(size, block_size(block));
+		return true;
+	}
+
+	bool BlockAllocator::owns(void* p) const {
+		uintptr_t address = reinterpret_cast<uintptr_t>(p);
+		uintptr_t start = reinterpret_cast<uintptr_t>(m_Start);
+		return address >= start && address < start + m_Size;
+	}
+
+	void BlockAllocator::freeBlock(tlsf::block_header* block) {
+		m_Allocations--;
+		m_UsedMemory -= tlsf::block_size(block);
+		m_Stats.recordDeallocation(tlsf::block_size(block));
+
+		// Mark the block as free and merge it with its neighbours before returning it to the free lists
+		tlsf::block_mark_as_free(block);
+		block = mergePrevious(block);
+		block = mergeNext(block);
+		insertFreeBlock(block);
+	}
+
+	void BlockAllocator::insertFreeBlock(tlsf::block_header* block) {
+		uint32 fl, sl;
+		tlsf::mapping_insert(tlsf::block_size(block), fl, sl);
+
+		// Push the block on the front of the list and mark the list as not empty
+		tlsf::block_header* current = m_FreeBlocks[fl][sl];
+		block->nextFree = current;
+		block->prevFree = nullptr;
+		if (current != nullptr) current->prevFree = block;
+
+		m_FreeBlocks[fl][sl] = block;
+		m_FirstLevelBitmap |= (1u << fl);
+		m_SecondLevelBitmap[fl] |= (1u << sl);
+	}
+
+	void BlockAllocator::removeFreeBlock(tlsf::block_header* block) {
+		uint32 fl, sl;
+		tlsf::mapping_insert(tlsf::block_size(block), fl, sl);
+
+		tlsf::block_header* prev = block->prevFree;
+		tlsf::block_header* next = block->nextFree;
+		if (next != nullptr) next->prevFree = prev;
+		if (prev != nullptr) prev->nextFree = next;
+
+		// If the block was the head of the list, set the new head and clear the bitmaps when the list is empty
+		if (m_FreeBlocks[fl][sl] == block) {
+			m_FreeBlocks[fl][sl] = next;
+			if (next == nullptr) {
+				m_SecondLevelBitmap[fl] &= ~(1u << sl);
+				if (m_SecondLevelBitmap[fl] == 0) m_FirstLevelBitmap &= ~(1u << fl);
+			}
+		}
+	}
+
+	tlsf::block_header* BlockAllocator::locateFreeBlock(size_t size) {
+		uint32 fl, sl;
+		tlsf::mapping_search(size, fl, sl);
+		if (fl >= FirstLevelIndexCount) return nullptr;
+
+		// Search the second level bitmap for a non empty list at or above the second level index
+		uint32 slMap = m_SecondLevelBitmap[fl] & (~0u << sl);
+		if (slMap == 0) {
+			// No list in this first level, search the first level bitmap for the next non empty first level
+			uint32 flMap = (fl + 1 < 32) ? m_FirstLevelBitmap & (~0u << (fl + 1)) : 0;
+			if (flMap == 0) return nullptr;
+
+			fl = tlsf::ffs(flMap);
+			slMap = m_SecondLevelBitmap[fl];
+		}
+		sl = tlsf::ffs(slMap);
+
+		tlsf::block_header* block = m_FreeBlocks[fl][sl];
+		removeFreeBlock(block);
+		return block;
+	}
+
+	tlsf::block_header* BlockAllocator::mergePrevious(tlsf::block_header* block) {
+		if (tlsf::block_is_prev_free(block)) {
+			tlsf::block_header* prev = block->prevPhysical;
+			removeFreeBlock(prev);
+			block = tlsf::block_absorb(prev, block);
+		}
+		return block;
+	}
+
+	tlsf::block_header* BlockAllocator::mergeNext(tlsf::block_header* block) {
+		tlsf::block_header* next = tlsf::block_next(block);
+		if (tlsf::block_is_free(next)) {
+			removeFreeBlock(next);
+			block = tlsf::block_absorb(block, next);
+		}
+		return block;
 	}
+
+	void BlockAllocator::trimFree(tlsf::block_header* block, size_t size) {
+		if (tlsf::block_can_split(block, size)) {
+			tlsf::block_header* remaining = tlsf::block_split(block, size);
+			tlsf::block_link_next(block);
+			tlsf::block_set_prev_used(remaining);
+			insertFreeBlock(remaining);
+		}
+	}
+
+	tlsf::block_header* BlockAllocator::trimFreeLeading(tlsf::block_header* block, size_t size) {
+		tlsf::block_header* remaining = block;
+		if (tlsf::block_can_split(block, size - tlsf::block_overhead)) {
+			// The leading part stays a free block, the remaining part is the block that will be handed out
+			remaining = tlsf::block_split(block, size - tlsf::block_overhead);
+			tlsf::block_set_prev_free(remaining);
+			tlsf::block_link_next(block);
+			insertFreeBlock(block);
+		}
+		return remaining;
+	}
+
+	// ----- BlockAllocator End -----
 }
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "JupiterAllocatorStats.h"
+#include "JupiterVirtualMemory.h"
+
+#include <atomic>
+#include <concepts>
 #include <exception>
 #include <iostream>
 
@@ -15,6 +20,8 @@ namespace Jupiter {
 	typedef short					int16;		// 16 bit integer
 	typedef char					int8;		// 8 bit integer
 
+	constexpr size_t CacheLineSize = 64;		// Size of a cache line, used to keep data written by different threads apart
+
 	/// <summary>
 	/// Namespace containing functions to do with pointers
 	/// </summary>
@@ -25,8 +32,16 @@ namespace Jupiter {
 		/// </summary>
 		/// <param name="ptr">The memory address</param>
 		/// <param name="alignment">The alignment value</param>
-		/// <returns>The adjustment the given memory address need to be moved forward to be aligned</returns>
-		inline uint8 calc_forward_alignment_adjustment(void* ptr, uint8 alignment);
+		/// <returns>The adjustment the given memory address need to be moved forward to be aligned, zero when it already is</returns>
+		inline size_t calc_forward_alignment_adjustment(void* ptr, size_t alignment);
+
+		/// <summary>
+		/// Calculates the adjustment needed to backward align a given memory address
+		/// </summary>
+		/// <param name="ptr">The memory address</param>
+		/// <param name="alignment">The alignment value</param>
+		/// <returns>The adjustment the given memory address need to be moved backward to be aligned, zero when it already is</returns>
+		inline size_t calc_backward_alignment_adjustment(void* ptr, size_t alignment);
 
 		/// <summary>
 		/// Calculates a new memory address by shifting another memory address forward by x amount of bytes
@@ -72,19 +87,135 @@ namespace Jupiter {
 	public:
 		virtual ~IAllocator() = default;
 
-		virtual void* allocate(size_t size, uint8 allignment = 4) = 0;
+		virtual void* allocate(size_t size, size_t allignment = 4) = 0;
 		virtual void deallocate(void* p) = 0;
 		virtual void deallocate(void* p, size_t size) = 0;
+
+		/// <summary>
+		/// Tries to grow or shrink a block in place, the address of the block never changes.
+		/// By default no block can be resized, allocators that can override this function
+		/// </summary>
+		/// <param name="p">The block to resize</param>
+		/// <param name="newSize">The size the block needs to have</param>
+		/// <returns>True when the block now has room for the new size, false when the block is left untouched</returns>
+		virtual bool tryResize(void* p, size_t newSize) { return false; }
+
+		/// <summary>
+		/// Resizes a block, in place when tryResize succeeds, otherwise by allocating a new block, copying the contents
+		/// and deallocating the old block. Allocators that cannot deallocate a single block override this function.
+		/// A nullptr block is a plain allocation
+		/// </summary>
+		/// <param name="p">The block to resize</param>
+		/// <param name="oldSize">The size of the block, the amount of bytes copied when the block is moved</param>
+		/// <param name="newSize">The size the block needs to have</param>
+		/// <param name="allignment">The alignment of the block when it is moved</param>
+		/// <returns>The address of the resized block</returns>
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4);
+
+		/// <summary>
+		/// Gets the statistics of the allocator, nullptr for allocators that do not keep statistics.
+		/// The statistics are empty when MEMORY_ALLOCATOR_STATS is not defined
+		/// </summary>
+		virtual const AllocatorStats* getStats() const { return nullptr; }
+
+		virtual void resetStats() {}		// Resets the statistics of the allocator, including the peaks
+	};
+
+	/// <summary>
+	/// Compile time counterpart of IAllocator, satisfied by every type with the allocate and deallocate functions.
+	/// Templated code taking a StaticAllocator calls the allocator directly, so the allocation can be inlined.
+	/// Every concrete allocator is final, so even through its IAllocator functions the call is resolved at compile time
+	/// as long as the concrete type is known, eg. the composed allocators and the Allocator namespace functions.
+	/// </summary>
+	template<typename A>
+	concept StaticAllocator = requires(A& allocator, void* p, size_t size, size_t allignment) {
+		{ allocator.allocate(size, allignment) } -> std::same_as<void*>;
+		allocator.deallocate(p);
+		allocator.deallocate(p, size);
+	};
+
+	/// <summary>
+	/// Wraps any StaticAllocator in the IAllocator interface, the opt in for code that needs type erasure,
+	/// eg. a composed allocator passed to a ThreadCachingAllocator or a JupiterMemoryResource
+	/// </summary>
+	/// <typeparam name="A">The type of the wrapped allocator</typeparam>
+	template<StaticAllocator A>
+	class AllocatorAdapter final : public IAllocator {
+
+	public:
+		AllocatorAdapter() = delete;
+
+		/// <summary>
+		/// Creates an adapter around an allocator, the allocator needs to outlive the adapter
+		/// </summary>
+		/// <param name="allocator">The allocator every call is passed on to</param>
+		AllocatorAdapter(A& allocator) : m_Allocator(allocator) {}
+
+		virtual ~AllocatorAdapter() override = default;
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Passes the allocation on to the wrapped allocator
+		virtual void deallocate(void* p) override;								// Passes the deallocation on to the wrapped allocator
+		virtual void deallocate(void* p, size_t size) override;					// Passes the deallocation on to the wrapped allocator
+		virtual bool tryResize(void* p, size_t newSize) override;				// Passes the resize on when the wrapped allocator supports it
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;	// Passes the reallocation on when the wrapped allocator supports it
+
+		inline A& getAllocator() const { return m_Allocator; }				// The wrapped allocator
+
+	private:
+		A& m_Allocator;				// The allocator every call is passed on to
+	};
+
+	/// <summary>
+	/// Allocator that passes every allocation on to the system heap, malloc and free.
+	/// Mainly used as the last resort of a composed allocator, eg. the fallback of a stack allocator.
+	/// Alignments larger then what malloc guarantees use the aligned allocation functions of the platform.
+	/// </summary>
+	class MallocAllocator final : public IAllocator {
+
+	public:
+		MallocAllocator() = default;
+
+		virtual ~MallocAllocator() override = default;
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Allocates a block from the system heap
+		virtual void deallocate(void* p) override;								// Returns the block to the system heap
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate(p), the heap keeps track of the size
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;	// Uses realloc, which can grow the block in place
+
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;			// Same as allocate, but returns nullptr when the heap is exhausted
+	};
+
+	/// <summary>
+	/// The way the memory block of a stack allocator is backed
+	/// </summary>
+	enum class EnumStackBacking {
+		Heap = 0,				// The entire block is allocated with malloc on instantiation
+		Virtual = 1,			// The block is reserved as virtual memory on instantiation, pages are committed when the top reaches them
+		HugePages = 2,			// Like Heap, but the block is aligned to 2MB and backed by huge pages when the system allows it
+		VirtualHugePages = 3	// Like Virtual, but the range is aligned to 2MB and backed by transparent huge pages when the system allows it
 	};
 
 	/// <summary>
 	/// Class that allocates memory in a stack like fashion, the total memory block is allocated on instantiation.
 	/// Therefore all the allocation calls are static
 	/// </summary>
-	class StackAllocator : public IAllocator {
+	class StackAllocator final : public IAllocator {
 
 		typedef void* stack_marker;			// Typedef to differntiate between a normal void* and a void* used as a stack marker
 
+	public:
+		/// <summary>
+		/// Snapshot of the top of a stack, kept outside of the stack so taking it does not allocate
+		/// </summary>
+		struct stack_state {
+			void* top;						// The top of the stack when the snapshot was taken
+			void* last;						// The most recent allocation when the snapshot was taken
+			size_t usedMemory;				// The used memory when the snapshot was taken
+			size_t allocations;				// The amount of allocations when the snapshot was taken
+		};
+
+	public:
+		static constexpr size_t CommitGranularity = 64 * 1024;		// Virtual backed stacks commit at least this many bytes at once
+		static constexpr size_t NoDecommit = ~(size_t)0;			// Decommit watermark that keeps all committed memory
+
 	public:
 		StackAllocator() = default;
 
@@ -94,11 +225,40 @@ namespace Jupiter {
 		/// <param name="size">The size of the stack in bytes</param>
 		StackAllocator(size_t size);
 
+		/// <summary>
+		/// Creates a stack allocator with the given backing.
+		/// A virtual backed stack can be sized for the worst case, only the memory below the highest top ever reached is committed.
+		/// When freeForward or clear drops the top below the decommit watermark, the committed memory above the watermark
+		/// is returned to the system
+		/// </summary>
+		/// <param name="size">The size of the stack in bytes</param>
+		/// <param name="backing">The way the memory block is backed</param>
+		/// <param name="decommitWatermark">The amount of bytes that stay committed, only used by virtual backed stacks</param>
+		StackAllocator(size_t size, EnumStackBacking backing, size_t decommitWatermark = NoDecommit);
+
 		virtual ~StackAllocator() override;										// Override virtual desctructor
-		virtual void* allocate(size_t size, uint8 allignment = 4) override;		// Override allocate function
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Override allocate function
 		virtual void deallocate(void* p) override;								// Throws exception, cannot deallocate on a stack!
 		virtual void deallocate(void* p, size_t size) override;					// Throws exception, cannot deallocate on a stack!
 
+		/// <summary>
+		/// Grows or shrinks the most recent allocation in place by moving the top of the stack.
+		/// Any other block cannot be resized, since the block after it is already handed out
+		/// </summary>
+		virtual bool tryResize(void* p, size_t newSize) override;
+
+		/// <summary>
+		/// Resizes the most recent allocation in place, any other block is copied to a new block on the top of the stack.
+		/// The old block is not freed, like every other block it is freed by freeForward or clear
+		/// </summary>
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;
+
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;			// Same as allocate, but returns nullptr when the stack is full
+		bool owns(void* p) const;												// Checks if the address lies inside of the memory block of the stack
+
+		virtual const AllocatorStats* getStats() const override { return &m_Stats; }		// The statistics of the allocator
+		virtual void resetStats() override { m_Stats.reset(); }								// Resets the statistics, including the peaks
+
 		/// <summary>
 		/// Marks the current point in the stack.
 		/// Allocates a stack marker in the stack block, this effectivly snapshots some of the variables the allocator keeps track off.
@@ -126,26 +286,360 @@ namespace Jupiter {
 		/// </summary>
 		void clear();
 
+		/// <summary>
+		/// Takes a snapshot of the top of the stack without allocating a marker on the stack.
+		/// The most recent allocation can no longer be resized until the snapshot is restored, it lies below the snapshot
+		/// so growing it would overlap the blocks allocated after restoring
+		/// </summary>
+		stack_state getState();
+
+		/// <summary>
+		/// Sets the top of the stack back to a snapshot, freeing everything allocated after it
+		/// All snapshots and markers created after the snapshot are invalid and should not be used
+		/// </summary>
+		/// <param name="state">A snapshot taken from this stack</param>
+		void restore(const stack_state& state);
+
+		inline size_t getSize() const { return m_Size; }				// The size of the stack in bytes
+		inline EnumStackBacking getBacking() const { return m_Backing; }	// The way the memory block is backed
+		inline EnumPageBacking getPageBacking() const { return m_PageBacking; }	// The kind of pages actually backing the memory block
+		inline size_t getUsedMemory() const { return m_UsedMemory; }		// The amount of bytes allocated since the last clear, including alignment
+		inline size_t getAllocations() const { return m_Allocations; }		// The amount of allocations since the last clear
+
+		/// <summary>
+		/// Gets the amount of bytes that take up physical memory, for a heap backed stack this is always the size of the stack
+		/// </summary>
+		inline size_t getCommittedMemory() const { return reinterpret_cast<uintptr_t>(m_Committed) - reinterpret_cast<uintptr_t>(m_Start); }
+
+	private:
+		bool commit(void* top);			// Commits the pages of a virtual backed stack up to the given top
+		void decommit();				// Decommits the pages of a virtual backed stack above the top and the watermark
+
+	private:
+		void* m_Start = nullptr;		// Pointer pointing the start of the allocator memory block
+		size_t m_Size = 0;				// The size of the allocated memory block
+
+		void* m_Top = nullptr;			// Pointer pointing to the top of the stack
+		void* m_Last = nullptr;			// The most recent allocation, the only block that can be resized, nullptr when unknown
+		size_t m_UsedMemory = 0;		// The total memory used by this allocator
+		size_t m_Allocations = 0;		// The total number of allocations this allocator has made
+
+		EnumStackBacking m_Backing = EnumStackBacking::Heap;	// The way the memory block is backed
+		EnumPageBacking m_PageBacking = EnumPageBacking::Default;	// The kind of pages actually backing the memory block
+		void* m_Committed = nullptr;							// End of the committed memory, memory above it is only reserved
+		size_t m_DecommitWatermark = NoDecommit;				// The amount of bytes that stay committed when the top drops
+
+		[[no_unique_address]] AllocatorStats m_Stats;			// The statistics of the allocator, empty when compiled out
+	};
+
+	/// <summary>
+	/// The side of a double ended stack allocator
+	/// </summary>
+	enum class EnumStackSide {
+		Bottom = 0,				// The stack growing up from the start of the memory block
+		Top = 1					// The stack growing down from the end of the memory block
+	};
+
+	/// <summary>
+	/// Variant of the StackAllocator with two stacks sharing one memory block, eg. long lived level data and temporary loading data.
+	/// The bottom stack grows up from the start of the block, the top stack grows down from the end of the block.
+	/// Neither side has a fixed budget, an allocation only fails when the two stacks would collide.
+	/// Both sides have their own markers, used memory and allocation count, freeing one side never touches the other.
+	/// Allocations through the IAllocator interface go to the bottom stack
+	/// </summary>
+	class DoubleEndedStackAllocator final : public IAllocator {
+
+		typedef void* stack_marker;			// Typedef to differntiate between a normal void* and a void* used as a stack marker
+
+	public:
+		DoubleEndedStackAllocator() = delete;
+
+		/// <summary>
+		/// Creates a double ended stack allocator, the total memory block is allocated on instantiation
+		/// </summary>
+		/// <param name="size">The size of the memory block shared by both stacks in bytes</param>
+		DoubleEndedStackAllocator(size_t size);
+
+		DoubleEndedStackAllocator(const DoubleEndedStackAllocator&) = delete;				// Delete copy constructor, the allocator owns its memory block
+		DoubleEndedStackAllocator& operator=(const DoubleEndedStackAllocator&) = delete;	// Delete copy assignment operator
+
+		virtual ~DoubleEndedStackAllocator() override;							// Override virtual destructor
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Allocates from the bottom stack
+		virtual void deallocate(void* p) override;								// Throws exception, cannot deallocate on a stack!
+		virtual void deallocate(void* p, size_t size) override;					// Throws exception, cannot deallocate on a stack!
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;	// Copies to a new block on the bottom stack, the old block is not freed
+
+		void* allocate(EnumStackSide side, size_t size, size_t allignment = 4);			// Allocates from the given side, throws when the stacks would collide
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;					// Same as allocate, but returns nullptr when the stacks would collide
+		void* tryAllocate(EnumStackSide side, size_t size, size_t allignment = 4) noexcept;	// Same as allocate, but returns nullptr when the stacks would collide
+		bool owns(void* p) const;														// Checks if the address lies inside of the memory block
+
+		virtual const AllocatorStats* getStats() const override { return &m_Stats; }		// The statistics of both stacks together
+		virtual void resetStats() override { m_Stats.reset(); }								// Resets the statistics, including the peaks
+
+		/// <summary>
+		/// Marks the current point in one of the stacks.
+		/// Like the StackAllocator the marker is allocated on the stack itself, snapshotting the used memory and allocations of that side
+		/// </summary>
+		/// <param name="side">The stack to mark</param>
+		stack_marker mark(EnumStackSide side);
+
+		/// <summary>
+		/// Free's one of the stacks from a marker onward, including the marker itself, the other stack is left untouched
+		/// All markers of the same side created after the marker freed are invalid and should not be used
+		/// </summary>
+		/// <param name="side">The stack the marker was made on</param>
+		/// <param name="marker">The marker</param>
+		void freeForward(EnumStackSide side, stack_marker marker);
+
+		void clear(EnumStackSide side);		// Clears a single stack, deallocating all of its memory
+		void clear();						// Clears both stacks
+
+		inline size_t getSize() const { return m_Size; }		// The size of the memory block shared by both stacks
+		inline size_t getFreeMemory() const { return reinterpret_cast<uintptr_t>(m_Top) - reinterpret_cast<uintptr_t>(m_Bottom); }	// The bytes left between the stacks
+		inline size_t getUsedMemory(EnumStackSide side) const { return m_UsedMemory[(int)side]; }		// The bytes allocated by a side, including alignment
+		inline size_t getAllocations(EnumStackSide side) const { return m_Allocations[(int)side]; }	// The amount of allocations of a side
+
 	private:
 		void* m_Start;					// Pointer pointing the start of the allocator memory block
 		size_t m_Size;					// The size of the allocated memory block
 
-		void* m_Top;					// Pointer pointing to the top of the stack
-		size_t m_UsedMemory;			// The total memory used by this allocator
-		size_t m_Allocations;			// The total number of allocations this allocator has made
+		void* m_Bottom;					// The top of the bottom stack, the first byte it has not handed out
+		void* m_Top;					// The top of the top stack, the last byte it handed out
+		size_t m_UsedMemory[2];			// The memory used by each side, indexed by EnumStackSide
+		size_t m_Allocations[2];		// The number of allocations of each side, indexed by EnumStackSide
+
+		[[no_unique_address]] AllocatorStats m_Stats;		// The statistics of both stacks together, empty when compiled out
+	};
+
+	/// <summary>
+	/// Variant of the StackAllocator that can be shared between threads, eg. a per frame arena used by all workers of a job system.
+	/// The top of the stack is moved forward with a single compare and swap, so allocating never takes a lock.
+	/// The used memory of a stack is always the distance from the start to the top, so it does not need its own atomic.
+	/// Clearing the stack is a single threaded operation, no thread may allocate while the stack is cleared.
+	/// </summary>
+	class ConcurrentStackAllocator final : public IAllocator {
+
+	public:
+		ConcurrentStackAllocator() = delete;
+
+		/// <summary>
+		/// Creates a concurrent stack allocator with a static memory profile
+		/// </summary>
+		/// <param name="size">The size of the stack in bytes</param>
+		ConcurrentStackAllocator(size_t size);
+
+		ConcurrentStackAllocator(const ConcurrentStackAllocator&) = delete;				// Delete copy constructor, the allocator owns its memory block
+		ConcurrentStackAllocator& operator=(const ConcurrentStackAllocator&) = delete;	// Delete copy assignment operator
+
+		virtual ~ConcurrentStackAllocator() override;							// Override virtual destructor
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Moves the top forward, safe to call from any thread
+		virtual void deallocate(void* p) override;								// Throws exception, cannot deallocate on a stack!
+		virtual void deallocate(void* p, size_t size) override;					// Throws exception, cannot deallocate on a stack!
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;	// Copies to a new block, the old block is not freed
+
+		/// <summary>
+		/// Clears the stack deallocating all memory, starting a new epoch
+		/// Not thread safe, all threads allocating from the stack need to be done before it is cleared
+		/// </summary>
+		void clear();
+
+		inline size_t getSize() const { return m_Size; }																	// The size of the stack in bytes
+		inline size_t getUsedMemory() const { return m_Top.load(std::memory_order_relaxed) - reinterpret_cast<uintptr_t>(m_Start); }	// The bytes used by the stack
+		inline size_t getAllocations() const { return m_Allocations.load(std::memory_order_relaxed); }						// The allocations since the last clear
+
+	private:
+		void* m_Start;					// Pointer pointing the start of the allocator memory block
+		size_t m_Size;					// The size of the allocated memory block
+
+		// The top and the allocation counter are always written together, so they share a cache line apart from the rest
+		alignas(CacheLineSize) std::atomic<uintptr_t> m_Top;		// Address of the top of the stack
+		std::atomic<size_t> m_Allocations;							// The total number of allocations since the last clear
 	};
 
+	namespace tlsf {
+		struct block_header;			// Header of a block managed by the block allocator, defined in JupiterAllocator.cpp
+	}
+
 	/// <summary>
-	/// A memory allocator that works similar to a heap
+	/// A memory allocator that works similar to a heap, implemented as a two level segregated fit (TLSF) allocator.
+	/// The memory block is allocated on instantiation and split up in blocks of variable size.
+	/// Free blocks are kept in segregated lists, the first level splits the lists by power of two sizes and the second level
+	/// splits every power of two range linearly. Two bitmaps keep track of which lists are non empty, so a suitable block is
+	/// found with a couple of bit scans. Every block carries a boundary tag so it is merged with its free neighbours immediately.
+	/// Both allocate and deallocate run in constant time, regardless of the amount of blocks in the allocator.
 	/// </summary>
-	class BlockAllocator : public IAllocator {};
+	class BlockAllocator final : public IAllocator {
+
+	public:
+		static constexpr uint32 AlignSizeLog2 = 3;										// Log2 of the minimal alignment of every block
+		static constexpr size_t AlignSize = (size_t)1 << AlignSizeLog2;					// The minimal alignment of every block
+		static constexpr uint32 SecondLevelIndexCountLog2 = 5;							// Log2 of the amount of second level lists per first level
+		static constexpr uint32 SecondLevelIndexCount = 1 << SecondLevelIndexCountLog2;	// The amount of second level lists per first level
+		static constexpr uint32 FirstLevelIndexMax = 38;								// Log2 of the largest block size supported
+		static constexpr uint32 FirstLevelIndexShift = SecondLevelIndexCountLog2 + AlignSizeLog2;
+		static constexpr uint32 FirstLevelIndexCount = FirstLevelIndexMax - FirstLevelIndexShift + 1;
+		static constexpr size_t SmallBlockSize = (size_t)1 << FirstLevelIndexShift;		// Blocks smaller then this all share the first level list
+
+	public:
+		BlockAllocator() = delete;
+
+		/// <summary>
+		/// Creates a block allocator, the total memory block is allocated on instantiation
+		/// </summary>
+		/// <param name="size">The size of the memory block in bytes</param>
+		BlockAllocator(size_t size);
+
+		BlockAllocator(const BlockAllocator&) = delete;							// Delete copy constructor, the allocator owns its memory block
+		BlockAllocator& operator=(const BlockAllocator&) = delete;				// Delete copy assignment operator
+
+		virtual ~BlockAllocator() override;										// Override virtual destructor
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Allocates a block from the best fitting free list
+		virtual void deallocate(void* p) override;								// Frees the block and merges it with its free neighbours
+
+		/// <summary>
+		/// Frees a block of which the caller knows the size.
+		/// The size of the block is stored in its boundary tag, so the size is only used to validate the call
+		/// Throws jpt_bad_free when the size is larger then the size of the block
+		/// </summary>
+		virtual void deallocate(void* p, size_t size) override;
+
+		/// <summary>
+		/// Shrinks a block by returning its tail to the free lists, or grows a block by absorbing the next block when it is free
+		/// </summary>
+		virtual bool tryResize(void* p, size_t newSize) override;
+
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;			// Same as allocate, but returns nullptr when no free block fits
+		bool owns(void* p) const;												// Checks if the address lies inside of the memory block of the allocator
+
+		virtual const AllocatorStats* getStats() const override { return &m_Stats; }		// The statistics of the allocator
+		virtual void resetStats() override { m_Stats.reset(); }								// Resets the statistics, including the peaks
+
+		inline size_t getSize() const { return m_Size; }					// The size of the memory block in bytes
+		inline size_t getUsedMemory() const { return m_UsedMemory; }		// The amount of bytes in blocks that are currently handed out
+		inline size_t getAllocations() const { return m_Allocations; }		// The amount of blocks currently handed out
+
+	private:
+		void insertFreeBlock(tlsf::block_header* block);						// Inserts a free block in the list matching its size
+		void removeFreeBlock(tlsf::block_header* block);						// Removes a free block from the list matching its size
+		tlsf::block_header* locateFreeBlock(size_t size);						// Finds and removes a free block of at least the given size
+		tlsf::block_header* mergePrevious(tlsf::block_header* block);			// Merges a block with its previous neighbour if that one is free
+		tlsf::block_header* mergeNext(tlsf::block_header* block);				// Merges a block with its next neighbour if that one is free
+		void trimFree(tlsf::block_header* block, size_t size);					// Splits of the tail of a block and returns it to the free lists
+		tlsf::block_header* trimFreeLeading(tlsf::block_header* block, size_t size);	// Splits of the head of a block and returns it to the free lists
+		void freeBlock(tlsf::block_header* block);								// Marks a block as free, merges it and inserts it in the free lists
+
+	private:
+		void* m_Start;					// Pointer pointing the start of the allocator memory block
+		size_t m_Size;					// The size of the allocated memory block
+
+		uint32 m_FirstLevelBitmap;											// Bit per first level, set when any of its second level lists is not empty
+		uint32 m_SecondLevelBitmap[FirstLevelIndexCount];					// Bit per second level list, set when the list is not empty
+		tlsf::block_header* m_FreeBlocks[FirstLevelIndexCount][SecondLevelIndexCount];	// Heads of the free lists
+
+		size_t m_UsedMemory;			// The total memory used by this allocator
+		size_t m_Allocations;			// The total number of allocations this allocator has made
+
+		[[no_unique_address]] AllocatorStats m_Stats;		// The statistics of the allocator, empty when compiled out
+	};
 
 	/// <summary>
-	/// 
+	/// Allocator that hands out fixed size slots big enough to hold a single T.
+	/// Memory is allocated in slabs, every slab holds the same amount of slots. The free slots form an intrusive linked list,
+	/// the link to the next free slot is stored inside the free slot itself, so there is no per slot bookkeeping.
+	/// Both allocate and deallocate are constant time, a new slab is only chained to the pool when all slots are in use.
 	/// </summary>
-	/// <typeparam name="T"></typeparam>
+	/// <typeparam name="T">The type of the objects stored in the pool</typeparam>
 	template<typename T>
-	class PoolAllocator : public IAllocator {};
+	class PoolAllocator final : public IAllocator {
+
+		/// <summary>
+		/// Node stored inside of a free slot, pointing to the next free slot
+		/// </summary>
+		struct free_node {
+			free_node* next;
+		};
+
+		/// <summary>
+		/// Header stored at the start of every slab, slabs are chained together so they can be released on destruction
+		/// </summary>
+		struct slab_header {
+			slab_header* next;
+		};
+
+	public:
+		static constexpr size_t SlotAlignment = alignof(T) > alignof(free_node) ? alignof(T) : alignof(free_node);
+		static constexpr size_t SlotSize = ((sizeof(T) > sizeof(free_node) ? sizeof(T) : sizeof(free_node)) + SlotAlignment - 1) & ~(SlotAlignment - 1);
+
+		/// <summary>
+		/// Creates a pool allocator, the first slab is allocated immediately
+		/// </summary>
+		/// <param name="slotsPerSlab">The amount of slots in every slab</param>
+		/// <param name="growable">When true a new slab is chained to the pool once it is full, otherwise std::bad_alloc is thrown</param>
+		PoolAllocator(size_t slotsPerSlab = 1024, bool growable = true);
+
+		PoolAllocator(const PoolAllocator&) = delete;							// Delete copy constructor, the pool owns its slabs
+		PoolAllocator& operator=(const PoolAllocator&) = delete;				// Delete copy assignment operator
+
+		virtual ~PoolAllocator() override;										// Override virtual destructor, releases all slabs
+		virtual void* allocate(size_t size = sizeof(T), size_t allignment = alignof(T)) override;	// Pops a slot from the free list
+		virtual void deallocate(void* p) override;								// Pushes the slot back on the free list
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate(p), every slot has the same size
+
+		void* tryAllocate(size_t size = sizeof(T), size_t allignment = alignof(T)) noexcept;	// Same as allocate, but returns nullptr when no slot is available
+
+		/// <summary>
+		/// Checks if the address lies inside of one of the slabs of the pool, walks the chain of slabs
+		/// </summary>
+		bool owns(void* p) const;
+
+		/// <summary>
+		/// Allocates a slot and constructs a T inside of it
+		/// </summary>
+		/// <param name="...args">The arguments passed to the constructor of T</param>
+		/// <returns>A pointer to the newly constructed object</returns>
+		template<typename ...Args>
+		T* create(Args&&... args);
+
+		/// <summary>
+		/// Destructs the object and returns its slot to the pool
+		/// </summary>
+		/// <param name="object">The object created by this pool</param>
+		void destroy(T* object);
+
+		inline size_t getUsedMemory() const { return m_UsedMemory; }		// The amount of bytes in slots that are currently handed out
+		inline size_t getAllocations() const { return m_Allocations; }		// The amount of slots currently handed out
+		inline size_t getSlabCount() const { return m_SlabCount; }			// The amount of slabs chained to this pool
+
+		virtual const AllocatorStats* getStats() const override { return &m_Stats; }		// The statistics of the allocator
+		virtual void resetStats() override { m_Stats.reset(); }								// Resets the statistics, including the peaks
+
+	private:
+		/// <summary>
+		/// Allocates a new slab and chains it to the pool, the slots of the new slab are handed out by bumping a pointer
+		/// so the slab does not have to be threaded into the free list up front
+		/// </summary>
+		/// <returns>True when the slab was allocated</returns>
+		bool grow();
+
+		inline void* firstSlot(slab_header* slab) const;				// Gets the address of the first slot in a slab
+
+	private:
+		size_t m_SlotsPerSlab;			// The amount of slots in each slab
+		bool m_Growable;				// Flag wether or not the pool is allowed to allocate more slabs
+
+		slab_header* m_Slabs;			// Linked list of all the slabs owned by this pool, the most recent slab first
+		size_t m_SlabCount;				// The amount of slabs owned by this pool
+
+		free_node* m_FreeList;			// Head of the list of slots that have been deallocated
+		void* m_Bump;					// Next slot in the most recent slab that has never been handed out
+		void* m_BumpEnd;				// End of the most recent slab
+
+		size_t m_UsedMemory;			// The total memory used by this allocator
+		size_t m_Allocations;			// The total number of allocations this allocator has made
+
+		[[no_unique_address]] AllocatorStats m_Stats;		// The statistics of the allocator, empty when compiled out
+	};
 
 //	class AllocatorBase {
 //
@@ -176,24 +670,62 @@ namespace Jupiter {
 //		size_t m_NumAllocations;
 //	};
 
-//	namespace Allocator {
-//
-//		template<typename T>
-//		T* allocateNew(AllocatorBase& allocator) {
-//			return new (allocator.allocate(sizeof(T), __alignof(T))) T;
-//		}
-//
-//		template<typename T>
-//		T* allocateNew(AllocatorBase& allocator, const T& t) {
-//			return new (allocator.allocate(sizeof(T), __alignof(T))) T(t);
-//		}
-//
-//		template<typename T>
-//		void deallocateDelete(AllocatorBase& allocator, T& object) {
-//			object.~T();
-//			allocator.deallocate(&object);
-//		}
-//	}
+	/// <summary>
+	/// Namespace containing functions to create and destroy objects with an allocator.
+	/// The functions are templated on the allocator, so with a concrete allocator type the allocation is inlined
+	/// </summary>
+	namespace Allocator {
+
+		/// <summary>
+		/// Allocates memory for a T from the allocator and constructs it in place
+		/// </summary>
+		/// <param name="allocator">The allocator the memory is allocated from</param>
+		/// <param name="...args">The arguments passed to the constructor of T</param>
+		/// <returns>A pointer to the newly constructed object</returns>
+		template<typename T, StaticAllocator A, typename ...Args>
+		inline T* allocateNew(A& allocator, Args&&... args);
+
+		/// <summary>
+		/// Destructs the object and returns its memory to the allocator it was allocated from
+		/// </summary>
+		/// <param name="allocator">The allocator the object was allocated from</param>
+		/// <param name="object">The object created by allocateNew</param>
+		template<typename T, StaticAllocator A>
+		inline void deallocateDelete(A& allocator, T* object);
+
+		/// <summary>
+		/// Gets the size of an isolated block, the size rounded up to whole cache lines
+		/// </summary>
+		constexpr size_t isolatedSize(size_t size) { return (size + CacheLineSize - 1) & ~(CacheLineSize - 1); }
+
+		/// <summary>
+		/// Allocates a block that starts on a cache line and is padded to whole cache lines, so no other block shares a cache line
+		/// with it, eg. counters written by different threads that would otherwise slow each other down through false sharing.
+		/// The block is deallocated with the isolated size, deallocate(p, isolatedSize(size))
+		/// </summary>
+		/// <param name="allocator">The allocator the memory is allocated from</param>
+		/// <param name="size">The size of the block, rounded up to whole cache lines</param>
+		/// <param name="allignment">The alignment of the block, at least the cache line size</param>
+		template<StaticAllocator A>
+		inline void* allocateIsolated(A& allocator, size_t size, size_t allignment = CacheLineSize);
+
+		/// <summary>
+		/// Allocates an isolated block for a T and constructs it in place, no other object shares a cache line with it
+		/// </summary>
+		/// <param name="allocator">The allocator the memory is allocated from</param>
+		/// <param name="...args">The arguments passed to the constructor of T</param>
+		/// <returns>A pointer to the newly constructed object</returns>
+		template<typename T, StaticAllocator A, typename ...Args>
+		inline T* allocateNewIsolated(A& allocator, Args&&... args);
+
+		/// <summary>
+		/// Destructs the object and returns its isolated block to the allocator it was allocated from
+		/// </summary>
+		/// <param name="allocator">The allocator the object was allocated from</param>
+		/// <param name="object">The object created by allocateNewIsolated</param>
+		template<typename T, StaticAllocator A>
+		inline void deallocateDeleteIsolated(A& allocator, T* object);
+	}
 }
 
 #include "JupiterAllocator.inl"
@@ -1,16 +1,24 @@
 #pragma once
 
+#include "JupiterAllocatorExceptions.h"
+
+#include <stdlib.h>
+#include <cstddef>
+#include <new>
+#include <utility>
+
 namespace Jupiter {
 
-	uint8 pointer_functions::calc_forward_alignment_adjustment(void* ptr, uint8 alignment) {
-		uint8 alignmentMask = alignment - 1;
+	size_t pointer_functions::calc_forward_alignment_adjustment(void* ptr, size_t alignment) {
+		// Masking the adjustment instead of subtracting it from the alignment makes an aligned address cost nothing,
+		// without the modulo or branch the subtraction would need
+		uintptr_t alignmentMask = alignment - 1;
 		uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
-		uint8 adjustment = alignment - (address & alignmentMask);
-//		if (adjustment == alignment) return 0; Maybe this needs to be here because now when the address is already aligned, 
-//		the adjustment is equal to the alignment, which means there is memory waste equal to the alignment,
-//		could also just modulo the adjustment with the alignment, so the alignment is never greater then the alignment
-//		But modulo operations are generally more expensive to do so probably not
-		return adjustment;
+		return (size_t)((alignment - (address & alignmentMask)) & alignmentMask);
+	}
+
+	size_t pointer_functions::calc_backward_alignment_adjustment(void* ptr, size_t alignment) {
+		return (size_t)(reinterpret_cast<uintptr_t>(ptr) & (alignment - 1));
 	}
 
 	void* pointer_functions::shift_forward(void* ptr, size_t x) {
@@ -28,4 +36,209 @@ namespace Jupiter {
 	const void* pointer_functions::shift_back(const void* ptr, size_t x) {
 		return (const void*)(reinterpret_cast<uintptr_t>(ptr) - x);
 	}
+
+	// ----- AllocatorAdapter Start -----
+
+	template<StaticAllocator A>
+	void* AllocatorAdapter<A>::allocate(size_t size, size_t allignment) {
+		return m_Allocator.allocate(size, allignment);
+	}
+
+	template<StaticAllocator A>
+	void AllocatorAdapter<A>::deallocate(void* p) {
+		m_Allocator.deallocate(p);
+	}
+
+	template<StaticAllocator A>
+	void AllocatorAdapter<A>::deallocate(void* p, size_t size) {
+		m_Allocator.deallocate(p, size);
+	}
+
+	template<StaticAllocator A>
+	bool AllocatorAdapter<A>::tryResize(void* p, size_t newSize) {
+		if constexpr (requires { m_Allocator.tryResize(p, newSize); }) return m_Allocator.tryResize(p, newSize);
+		else return false;
+	}
+
+	template<StaticAllocator A>
+	void* AllocatorAdapter<A>::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		if constexpr (requires { m_Allocator.reallocate(p, oldSize, newSize, allignment); }) return m_Allocator.reallocate(p, oldSize, newSize, allignment);
+		else return IAllocator::reallocate(p, oldSize, newSize, allignment);
+	}
+
+	// ----- AllocatorAdapter End -----
+
+	// ----- PoolAllocator Start -----
+
+	template<typename T>
+	PoolAllocator<T>::PoolAllocator(size_t slotsPerSlab, bool growable) :
+		m_SlotsPerSlab(slotsPerSlab > 0 ? slotsPerSlab : 1), m_Growable(growable),
+		m_Slabs(nullptr), m_SlabCount(0),
+		m_FreeList(nullptr), m_Bump(nullptr), m_BumpEnd(nullptr),
+		m_UsedMemory(0), m_Allocations(0)
+	{
+		// Allocate the first slab up front, so a non growable pool has all of its memory on instantiation
+		grow();
+	}
+
+	template<typename T>
+	PoolAllocator<T>::~PoolAllocator() {
+		// Release every slab in the chain
+		slab_header* slab = m_Slabs;
+		while (slab != nullptr) {
+			slab_header* next = slab->next;
+			free(slab);
+			slab = next;
+		}
+	}
+
+	template<typename T>
+	void* PoolAllocator<T>::allocate(size_t size, size_t allignment) {
+		void* slot = tryAllocate(size, allignment);
+		if (slot == nullptr) {
+			throw std::bad_alloc();
+		}
+		return slot;
+	}
+
+	template<typename T>
+	void* PoolAllocator<T>::tryAllocate(size_t size, size_t allignment) noexcept {
+		// The pool can only hand out slots, check if the requested block fits inside of one
+		if (size > SlotSize || allignment > SlotAlignment) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+
+		void* slot = nullptr;
+
+		// Reuse a previously deallocated slot first
+		if (m_FreeList != nullptr) {
+			slot = m_FreeList;
+			m_FreeList = m_FreeList->next;
+		}
+		else {
+			// No free slots left, take one from the untouched part of the most recent slab, chain a new slab if it is exhausted
+			if (m_Bump == m_BumpEnd && !(m_Growable && grow())) {
+				m_Stats.recordFailure();
+				return nullptr;
+			}
+			slot = m_Bump;
+			m_Bump = pointer_functions::shift_forward(m_Bump, SlotSize);
+		}
+
+		m_Allocations++;
+		m_UsedMemory += SlotSize;
+		m_Stats.recordAllocation(size, SlotSize);
+		return slot;
+	}
+
+	template<typename T>
+	void PoolAllocator<T>::deallocate(void* p) {
+		if (p == nullptr) return;
+
+		// Push the slot on the front of the free list
+		free_node* node = reinterpret_cast<free_node*>(p);
+		node->next = m_FreeList;
+		m_FreeList = node;
+
+		m_Allocations--;
+		m_UsedMemory -= SlotSize;
+		m_Stats.recordDeallocation(SlotSize);
+	}
+
+	template<typename T>
+	void PoolAllocator<T>::deallocate(void* p, size_t size) {
+		if (size > SlotSize) {
+			throw jpt_bad_free("Pool allocator cannot deallocate a block larger than its slot size!");
+		}
+		deallocate(p);
+	}
+
+	template<typename T>
+	bool PoolAllocator<T>::owns(void* p) const {
+		uintptr_t address = reinterpret_cast<uintptr_t>(p);
+		for (slab_header* slab = m_Slabs; slab != nullptr; slab = slab->next) {
+			uintptr_t first = reinterpret_cast<uintptr_t>(firstSlot(slab));
+			if (address >= first && address < first + SlotSize * m_SlotsPerSlab) return true;
+		}
+		return false;
+	}
+
+	template<typename T>
+	template<typename ...Args>
+	T* PoolAllocator<T>::create(Args&&... args) {
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void PoolAllocator<T>::destroy(T* object) {
+		if (object == nullptr) return;
+		object->~T();
+		deallocate(object);
+	}
+
+	template<typename T>
+	bool PoolAllocator<T>::grow() {
+		// The slots start at the first properly aligned address after the slab header
+		size_t headerSize = (sizeof(slab_header) + SlotAlignment - 1) & ~(SlotAlignment - 1);
+		size_t slabSize = headerSize + SlotSize * m_SlotsPerSlab;
+
+		// Over allocate by the slot alignment when it is larger than what malloc guarantees
+		if (SlotAlignment > alignof(std::max_align_t)) slabSize += SlotAlignment;
+
+		void* data = malloc(slabSize);
+		if (data == nullptr) return false;
+
+		// Chain the slab to the pool
+		slab_header* slab = reinterpret_cast<slab_header*>(data);
+		slab->next = m_Slabs;
+		m_Slabs = slab;
+		m_SlabCount++;
+
+		// Let the bump pointer hand out the slots of the new slab
+		m_Bump = firstSlot(slab);
+		m_BumpEnd = pointer_functions::shift_forward(m_Bump, SlotSize * m_SlotsPerSlab);
+		return true;
+	}
+
+	template<typename T>
+	void* PoolAllocator<T>::firstSlot(slab_header* slab) const {
+		// The first slot is the first properly aligned address after the slab header
+		uintptr_t first = (reinterpret_cast<uintptr_t>(slab) + sizeof(slab_header) + SlotAlignment - 1) & ~(uintptr_t)(SlotAlignment - 1);
+		return reinterpret_cast<void*>(first);
+	}
+
+	// ----- PoolAllocator End -----
+
+	namespace Allocator {
+
+		template<typename T, StaticAllocator A, typename ...Args>
+		T* allocateNew(A& allocator, Args&&... args) {
+			return new (allocator.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T, StaticAllocator A>
+		void deallocateDelete(A& allocator, T* object) {
+			if (object == nullptr) return;
+			object->~T();
+			allocator.deallocate(object, sizeof(T));
+		}
+
+		template<StaticAllocator A>
+		void* allocateIsolated(A& allocator, size_t size, size_t allignment) {
+			return allocator.allocate(isolatedSize(size), allignment > CacheLineSize ? allignment : CacheLineSize);
+		}
+
+		template<typename T, StaticAllocator A, typename ...Args>
+		T* allocateNewIsolated(A& allocator, Args&&... args) {
+			return new (allocateIsolated(allocator, sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T, StaticAllocator A>
+		void deallocateDeleteIsolated(A& allocator, T* object) {
+			if (object == nullptr) return;
+			object->~T();
+			allocator.deallocate(object, isolatedSize(sizeof(T)));
+		}
+	}
 }
@@ -21,4 +21,20 @@ namespace Jupiter {
 		std::string m_Message;
 	};
 
+	/// <summary>
+	/// Exception class for when an allocation trace cannot be decoded
+	/// </summary>
+	class jpt_bad_trace : public std::exception {
+
+	public:
+		jpt_bad_trace(const std::string& message) : m_Message(message) {}
+
+		const char* what() const noexcept override {
+			return m_Message.c_str();
+		}
+
+	private:
+		std::string m_Message;
+	};
+
 }
\ No newline at end of file
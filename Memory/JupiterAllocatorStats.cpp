@@ -0,0 +1,27 @@
+#include "JupiterAllocatorStats.h"
+
+#include <atomic>
+#include <iostream>
+
+namespace Jupiter {
+
+	namespace {
+
+		void warn_leak(const char* allocator, size_t allocations, size_t bytes) {
+			std::cerr << "Warning: " << allocator << " destroyed with " << allocations << " allocations (" << bytes << " bytes) still in use" << std::endl;
+		}
+
+		std::atomic<allocator_stats::leak_handler> s_LeakHandler = warn_leak;	// Allocators can be destroyed on any thread
+	}
+
+	allocator_stats::leak_handler allocator_stats::setLeakHandler(leak_handler handler) {
+		return s_LeakHandler.exchange(handler);
+	}
+
+	void allocator_stats::reportLeak(const char* allocator, size_t allocations, size_t bytes) {
+#ifdef MEMORY_ALLOCATOR_STATS
+		leak_handler handler = s_LeakHandler.load();
+		if (handler != nullptr) handler(allocator, allocations, bytes);
+#endif
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+
+// Allocation statistics are compiled in, unless the build defines MEMORY_NO_ALLOCATOR_STATS, eg. release performance builds
+#if !defined(MEMORY_NO_ALLOCATOR_STATS) && !defined(MEMORY_ALLOCATOR_STATS)
+#define MEMORY_ALLOCATOR_STATS
+#endif
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Statistics of a single allocator, used to size arenas and pools from real workloads instead of guessing.
+	/// The bytes of a block are the bytes the allocator accounts for it, the requested size plus the padding for alignment
+	/// and the rounding up to a slot or block size. The difference between the two is counted as alignment waste.
+	///
+	/// When MEMORY_ALLOCATOR_STATS is not defined every function is empty and the class has no members,
+	/// so an allocator holding it as a [[no_unique_address]] member pays nothing for it.
+	/// </summary>
+	class AllocatorStats {
+
+	public:
+		static constexpr size_t HistogramBuckets = 32;		// Bucket i counts requests of at least 2^(i-1) and less than 2^i bytes, the last bucket counts everything larger
+
+#ifdef MEMORY_ALLOCATOR_STATS
+		static constexpr bool Enabled = true;				// Wether the statistics are compiled in
+#else
+		static constexpr bool Enabled = false;
+#endif
+
+	public:
+		/// <summary>
+		/// Records a successful allocation
+		/// </summary>
+		/// <param name="requested">The size the caller asked for</param>
+		/// <param name="bytes">The bytes the allocator accounts for the block, at least the requested size</param>
+		inline void recordAllocation(size_t requested, size_t bytes);
+
+		inline void recordDeallocation(size_t bytes);						// Records a block of the given bytes being returned
+		inline void recordResize(size_t oldBytes, size_t newBytes);			// Records a block growing or shrinking in place
+		inline void recordFailure();										// Records an allocation that could not be served
+
+		/// <summary>
+		/// Sets the current bytes and allocations back, for allocators that free many blocks at once eg. a stack that is cleared
+		/// </summary>
+		inline void recordRewind(size_t bytes, size_t allocations);
+
+		inline void reset();				// Resets all statistics, including the peaks, eg. after loading a level
+
+#ifdef MEMORY_ALLOCATOR_STATS
+		inline size_t getCurrentBytes() const { return m_CurrentBytes; }					// The bytes of all blocks currently handed out
+		inline size_t getPeakBytes() const { return m_PeakBytes; }						// The highest amount of current bytes
+		inline size_t getCurrentAllocations() const { return m_CurrentAllocations; }		// The amount of blocks currently handed out
+		inline size_t getPeakAllocations() const { return m_PeakAllocations; }			// The highest amount of current allocations
+		inline size_t getTotalAllocations() const { return m_TotalAllocations; }			// The amount of successful allocations
+		inline size_t getFailedAllocations() const { return m_FailedAllocations; }		// The amount of allocations that could not be served
+		inline size_t getAlignmentWaste() const { return m_AlignmentWaste; }				// The bytes of all allocations beyond their requested size
+		inline size_t getHistogram(size_t bucket) const { return m_Histogram[bucket]; }	// The amount of requests in a size bucket
+#else
+		inline size_t getCurrentBytes() const { return 0; }
+		inline size_t getPeakBytes() const { return 0; }
+		inline size_t getCurrentAllocations() const { return 0; }
+		inline size_t getPeakAllocations() const { return 0; }
+		inline size_t getTotalAllocations() const { return 0; }
+		inline size_t getFailedAllocations() const { return 0; }
+		inline size_t getAlignmentWaste() const { return 0; }
+		inline size_t getHistogram(size_t bucket) const { return 0; }
+#endif
+
+		/// <summary>
+		/// Gets the histogram bucket a request size is counted in
+		/// </summary>
+		static inline size_t histogramBucket(size_t size);
+
+	private:
+#ifdef MEMORY_ALLOCATOR_STATS
+		size_t m_CurrentBytes = 0;						// The bytes of all blocks currently handed out
+		size_t m_PeakBytes = 0;							// The highest amount of current bytes
+		size_t m_CurrentAllocations = 0;				// The amount of blocks currently handed out
+		size_t m_PeakAllocations = 0;					// The highest amount of current allocations
+		size_t m_TotalAllocations = 0;					// The amount of successful allocations
+		size_t m_FailedAllocations = 0;					// The amount of allocations that could not be served
+		size_t m_AlignmentWaste = 0;					// The bytes of all allocations beyond their requested size
+		size_t m_Histogram[HistogramBuckets] = {};		// The amount of requests per power of two size bucket
+#endif
+	};
+
+	namespace allocator_stats {
+
+		/// <summary>
+		/// Function called when an allocator is destroyed while blocks are still handed out
+		/// </summary>
+		/// <param name="allocator">The name of the allocator type</param>
+		/// <param name="allocations">The amount of blocks still handed out</param>
+		/// <param name="bytes">The bytes of the blocks still handed out</param>
+		typedef void (*leak_handler)(const char* allocator, size_t allocations, size_t bytes);
+
+		/// <summary>
+		/// Sets the function called when an allocator is destroyed with blocks still handed out, eg. to send it to telemetry.
+		/// The default handler writes a warning to std::cerr, nullptr silences the warnings
+		/// </summary>
+		/// <returns>The previous handler</returns>
+		leak_handler setLeakHandler(leak_handler handler);
+
+		/// <summary>
+		/// Warns the user that an allocator was destroyed while blocks are still handed out.
+		/// Does nothing when MEMORY_ALLOCATOR_STATS is not defined
+		/// </summary>
+		void reportLeak(const char* allocator, size_t allocations, size_t bytes);
+	}
+}
+
+#include "JupiterAllocatorStats.inl"
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <bit>
+
+namespace Jupiter {
+
+	size_t AllocatorStats::histogramBucket(size_t size) {
+		size_t bucket = (size_t)std::bit_width(size);
+		return bucket < HistogramBuckets ? bucket : HistogramBuckets - 1;
+	}
+
+#ifdef MEMORY_ALLOCATOR_STATS
+
+	void AllocatorStats::recordAllocation(size_t requested, size_t bytes) {
+		m_CurrentBytes += bytes;
+		m_CurrentAllocations++;
+		m_TotalAllocations++;
+		m_AlignmentWaste += bytes > requested ? bytes - requested : 0;
+		m_Histogram[histogramBucket(requested)]++;
+
+		if (m_CurrentBytes > m_PeakBytes) m_PeakBytes = m_CurrentBytes;
+		if (m_CurrentAllocations > m_PeakAllocations) m_PeakAllocations = m_CurrentAllocations;
+	}
+
+	void AllocatorStats::recordDeallocation(size_t bytes) {
+		m_CurrentBytes -= bytes;
+		m_CurrentAllocations--;
+	}
+
+	void AllocatorStats::recordResize(size_t oldBytes, size_t newBytes) {
+		m_CurrentBytes = m_CurrentBytes - oldBytes + newBytes;
+		if (m_CurrentBytes > m_PeakBytes) m_PeakBytes = m_CurrentBytes;
+	}
+
+	void AllocatorStats::recordFailure() {
+		m_FailedAllocations++;
+	}
+
+	void AllocatorStats::recordRewind(size_t bytes, size_t allocations) {
+		m_CurrentBytes = bytes;
+		m_CurrentAllocations = allocations;
+	}
+
+	void AllocatorStats::reset() {
+		*this = AllocatorStats();
+	}
+
+#else
+
+	void AllocatorStats::recordAllocation(size_t requested, size_t bytes) {}
+	void AllocatorStats::recordDeallocation(size_t bytes) {}
+	void AllocatorStats::recordResize(size_t oldBytes, size_t newBytes) {}
+	void AllocatorStats::recordFailure() {}
+	void AllocatorStats::recordRewind(size_t bytes, size_t allocations) {}
+	void AllocatorStats::reset() {}
+
+#endif
+}
@@ -0,0 +1,204 @@
+#include "JupiterBuddyAllocator.h"
+
+#include "JupiterAllocatorExceptions.h"
+#include "JupiterVirtualMemory.h"
+
+#include <bit>
+#include <new>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Stored inside of every free block, links it in the free list of its order
+	/// </summary>
+	struct BuddyAllocator::free_block {
+		free_block* prev;				// Previous free block of the same order
+		free_block* next;				// Next free block of the same order
+	};
+
+	namespace {
+
+		// Log2 of a power of two, or of the next power of two for any other value, based on count leading zeros
+		inline uint32 ceil_log2(size_t value) {
+			return value <= 1 ? 0 : 64 - (uint32)std::countl_zero((uint64)(value - 1));
+		}
+	}
+
+	BuddyAllocator::BuddyAllocator(size_t size, size_t minBlockSize) :
+		m_Start(nullptr), m_Size(0), m_SizeLog2(0), m_MinBlockSizeLog2(0), m_OrderCount(0),
+		m_FreeLists{}, m_FreeCounts{}, m_FreeOrders(0), m_UsedMemory(0), m_Allocations(0)
+	{
+		m_MinBlockSizeLog2 = ceil_log2(minBlockSize < sizeof(free_block) ? sizeof(free_block) : minBlockSize);
+		m_SizeLog2 = ceil_log2(size);
+		if (m_SizeLog2 < m_MinBlockSizeLog2) m_SizeLog2 = m_MinBlockSizeLog2;
+		m_OrderCount = m_SizeLog2 - m_MinBlockSizeLog2 + 1;
+		if (m_OrderCount > MaxOrderCount) throw std::bad_alloc();
+		m_Size = (size_t)1 << m_SizeLog2;
+
+		// Align the memory block so every block is aligned to its own size, up to the huge page size
+		size_t alignment = m_Size < virtual_memory::HugePageSize ? m_Size : virtual_memory::HugePageSize;
+		m_Start = virtual_memory::allocate_aligned(m_Size, alignment);
+		if (m_Start == nullptr) throw std::bad_alloc();
+
+		// The tree has a node for every block of every order
+		size_t nodeCount = ((size_t)1 << m_OrderCount) - 1;
+		m_SplitBits.resize((nodeCount + 63) >> 6, 0);
+		m_FreeBits.resize((nodeCount + 63) >> 6, 0);
+
+		// Initially the memory block is a single free block, the root of the tree
+		pushFree(0, m_OrderCount - 1);
+	}
+
+	BuddyAllocator::~BuddyAllocator() {
+		if (m_Allocations != 0) {
+			allocator_stats::reportLeak("BuddyAllocator", m_Allocations, m_UsedMemory);
+		}
+		virtual_memory::release(m_Start, m_Size);
+	}
+
+	void* BuddyAllocator::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	void* BuddyAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
+		// A block is aligned to its own size up to the alignment of the memory block, the huge page size at most.
+		// Up to there a larger alignment only needs a larger block, beyond it no block is guaranteed to be aligned
+		size_t requested = size;
+		if (size < allignment) size = allignment;
+		if (size > m_Size || allignment > virtual_memory::HugePageSize) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+
+		uint32 order = ceil_log2(size);
+		order = order > m_MinBlockSizeLog2 ? order - m_MinBlockSizeLog2 : 0;
+
+		// Find the smallest order with a free block that is at least as large as the request
+		uint64 candidates = m_FreeOrders & (~(uint64)0 << order);
+		if (candidates == 0) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+		uint32 found = (uint32)std::countr_zero(candidates);
+
+		// Take the block and split it until it has the requested order, the second half of every split is freed
+		void* block = m_FreeLists[found];
+		uint32 level = m_OrderCount - 1 - found;
+		size_t offset = reinterpret_cast<uintptr_t>(block) - reinterpret_cast<uintptr_t>(m_Start);
+		size_t node = ((size_t)1 << level) - 1 + (offset >> (m_SizeLog2 - level));
+		removeFree(node, found);
+
+		while (found > order) {
+			setBit(m_SplitBits, node);
+			node = 2 * node + 1;
+			found--;
+			pushFree(node + 1, found);
+		}
+
+		m_Allocations++;
+		m_UsedMemory += (size_t)1 << (found + m_MinBlockSizeLog2);
+		m_Stats.recordAllocation(requested, (size_t)1 << (found + m_MinBlockSizeLog2));
+		return block;
+	}
+
+	void BuddyAllocator::deallocate(void* p) {
+		if (p == nullptr) return;
+		freeNode(findNode(p));
+	}
+
+	void BuddyAllocator::deallocate(void* p, size_t size) {
+		if (p == nullptr) return;
+
+		size_t node = findNode(p);
+		if (size > ((size_t)1 << (nodeOrder(node) + m_MinBlockSizeLog2))) {
+			throw jpt_bad_free("Buddy allocator cannot deallocate a block smaller then the given size!");
+		}
+		freeNode(node);
+	}
+
+	bool BuddyAllocator::owns(void* p) const {
+		uintptr_t address = reinterpret_cast<uintptr_t>(p);
+		uintptr_t start = reinterpret_cast<uintptr_t>(m_Start);
+		return address >= start && address < start + m_Size;
+	}
+
+	size_t BuddyAllocator::blockSize(size_t size) const {
+		uint32 log2 = ceil_log2(size);
+		return (size_t)1 << (log2 > m_MinBlockSizeLog2 ? log2 : m_MinBlockSizeLog2);
+	}
+
+	void* BuddyAllocator::nodeAddress(size_t node) const {
+		uint32 level = (uint32)std::bit_width(node + 1) - 1;
+		size_t index = node + 1 - ((size_t)1 << level);
+		return pointer_functions::shift_forward(m_Start, index << (m_SizeLog2 - level));
+	}
+
+	uint32 BuddyAllocator::nodeOrder(size_t node) const {
+		return m_OrderCount - (uint32)std::bit_width(node + 1);
+	}
+
+	size_t BuddyAllocator::findNode(void* p) const {
+		if (!owns(p)) {
+			throw jpt_bad_free("Buddy allocator cannot deallocate a block it does not own!");
+		}
+
+		// Descend from the root into the half containing the address until a block that is not split is reached
+		size_t offset = reinterpret_cast<uintptr_t>(p) - reinterpret_cast<uintptr_t>(m_Start);
+		size_t node = 0;
+		uint32 shift = m_SizeLog2;
+		while (testBit(m_SplitBits, node)) {
+			shift--;
+			node = 2 * node + 1 + ((offset >> shift) & 1);
+		}
+
+		if ((offset & (((size_t)1 << shift) - 1)) != 0 || testBit(m_FreeBits, node)) {
+			throw jpt_bad_free("Buddy allocator cannot deallocate a block that is free or does not start at the given address!");
+		}
+		return node;
+	}
+
+	void BuddyAllocator::pushFree(size_t node, uint32 order) {
+		free_block* block = reinterpret_cast<free_block*>(nodeAddress(node));
+		block->prev = nullptr;
+		block->next = m_FreeLists[order];
+		if (block->next != nullptr) block->next->prev = block;
+		m_FreeLists[order] = block;
+
+		m_FreeCounts[order]++;
+		m_FreeOrders |= (uint64)1 << order;
+		setBit(m_FreeBits, node);
+	}
+
+	void BuddyAllocator::removeFree(size_t node, uint32 order) {
+		free_block* block = reinterpret_cast<free_block*>(nodeAddress(node));
+		if (block->prev != nullptr) block->prev->next = block->next;
+		else m_FreeLists[order] = block->next;
+		if (block->next != nullptr) block->next->prev = block->prev;
+
+		if (--m_FreeCounts[order] == 0) m_FreeOrders &= ~((uint64)1 << order);
+		clearBit(m_FreeBits, node);
+	}
+
+	void BuddyAllocator::freeNode(size_t node) {
+		uint32 order = nodeOrder(node);
+		m_Allocations--;
+		m_UsedMemory -= (size_t)1 << (order + m_MinBlockSizeLog2);
+		m_Stats.recordDeallocation((size_t)1 << (order + m_MinBlockSizeLog2));
+
+		// Merge with the buddy as long as it is free, the parent is no longer split after the merge
+		while (node != 0) {
+			size_t buddy = (node & 1) ? node + 1 : node - 1;
+			if (!testBit(m_FreeBits, buddy)) break;
+
+			removeFree(buddy, order);
+			node = (node - 1) / 2;
+			clearBit(m_SplitBits, node);
+			order++;
+		}
+		pushFree(node, order);
+	}
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <vector>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Allocator that hands out power of two blocks, eg. I/O blocks and staging buffers.
+	/// The memory block is a binary tree of blocks, every block can be split in two halves (buddies) down to the minimal
+	/// block size. Every allocation is rounded up to a power of two, the smallest free block that fits is split until it has
+	/// the right size. When a block is freed and its buddy is free as well they are merged, all the way up the tree.
+	///
+	/// Free blocks are kept in a doubly linked list per order, stored inside of the free blocks themselves. The state of the
+	/// tree is kept in two bitmaps next to the memory, one bit per node marking it split and one marking it free, so there
+	/// is no header in front of any block. The order of a block is found by walking the split bits from the root.
+	/// Both allocate and deallocate are O(log N), with N the amount of minimal blocks.
+	/// Blocks are aligned to their own size up to the huge page size, a larger alignment cannot be served.
+	/// </summary>
+	class BuddyAllocator final : public IAllocator {
+
+	public:
+		struct free_block;				// Links a free block in the list of its order, defined in JupiterBuddyAllocator.cpp
+
+		static constexpr uint32 MaxOrderCount = 48;				// The maximum amount of orders, the size of the largest block is at most 2^47 minimal blocks
+
+	public:
+		BuddyAllocator() = delete;
+
+		/// <summary>
+		/// Creates a buddy allocator, the total memory block is allocated on instantiation
+		/// </summary>
+		/// <param name="size">The size of the memory block in bytes, rounded up to a power of two</param>
+		/// <param name="minBlockSize">The size of the smallest block, rounded up to a power of two of at least 16 bytes</param>
+		BuddyAllocator(size_t size, size_t minBlockSize = 64);
+
+		BuddyAllocator(const BuddyAllocator&) = delete;							// Delete copy constructor, the allocator owns its memory block
+		BuddyAllocator& operator=(const BuddyAllocator&) = delete;				// Delete copy assignment operator
+
+		virtual ~BuddyAllocator() override;										// Override virtual destructor
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Splits the smallest free block that fits down to the size
+		virtual void deallocate(void* p) override;								// Frees the block and merges it with its buddies
+
+		/// <summary>
+		/// Frees a block of which the caller knows the size.
+		/// The order of the block follows from the split bits, so the size is only used to validate the call
+		/// Throws jpt_bad_free when the size is larger then the size of the block
+		/// </summary>
+		virtual void deallocate(void* p, size_t size) override;
+
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;			// Same as allocate, but returns nullptr when no free block fits
+		bool owns(void* p) const;												// Checks if the address lies inside of the memory block of the allocator
+
+		virtual const AllocatorStats* getStats() const override { return &m_Stats; }		// The statistics of the allocator
+		virtual void resetStats() override { m_Stats.reset(); }								// Resets the statistics, including the peaks
+
+		/// <summary>
+		/// Gets the size of the block an allocation of the given size is rounded up to
+		/// </summary>
+		size_t blockSize(size_t size) const;
+
+		inline size_t getSize() const { return m_Size; }						// The size of the memory block in bytes
+		inline size_t getMinBlockSize() const { return (size_t)1 << m_MinBlockSizeLog2; }	// The size of the smallest block
+		inline uint32 getOrderCount() const { return m_OrderCount; }			// The amount of orders, order 0 holds the smallest blocks
+		inline size_t getFreeBlocks(uint32 order) const { return m_FreeCounts[order]; }	// The amount of free blocks of an order
+		inline size_t getUsedMemory() const { return m_UsedMemory; }			// The amount of bytes in blocks that are currently handed out
+		inline size_t getAllocations() const { return m_Allocations; }			// The amount of blocks currently handed out
+
+	private:
+		inline void* nodeAddress(size_t node) const;				// Gets the address of the block of a node
+		inline uint32 nodeOrder(size_t node) const;					// Gets the order of the block of a node
+		size_t findNode(void* p) const;								// Walks the split bits to the node of an allocated block
+
+		void pushFree(size_t node, uint32 order);					// Adds the block of a node to the free list of its order
+		void removeFree(size_t node, uint32 order);					// Removes the block of a node from the free list of its order
+		void freeNode(size_t node);									// Frees the block of a node and merges it with its buddies
+
+		inline bool testBit(const std::vector<uint64>& bits, size_t node) const { return (bits[node >> 6] >> (node & 63)) & 1; }
+		inline void setBit(std::vector<uint64>& bits, size_t node) { bits[node >> 6] |= (uint64)1 << (node & 63); }
+		inline void clearBit(std::vector<uint64>& bits, size_t node) { bits[node >> 6] &= ~((uint64)1 << (node & 63)); }
+
+	private:
+		void* m_Start;					// Pointer pointing the start of the allocator memory block
+		size_t m_Size;					// The size of the allocated memory block, a power of two
+		uint32 m_SizeLog2;				// Log2 of the size of the memory block
+		uint32 m_MinBlockSizeLog2;		// Log2 of the size of the smallest block
+		uint32 m_OrderCount;			// The amount of orders, the root block has order m_OrderCount - 1
+
+		free_block* m_FreeLists[MaxOrderCount];		// Heads of the free lists, one per order
+		size_t m_FreeCounts[MaxOrderCount];			// The amount of blocks in every free list
+		uint64 m_FreeOrders;						// Bit per order, set when its free list is not empty
+
+		std::vector<uint64> m_SplitBits;			// Bit per node, set when the block of the node is split in two
+		std::vector<uint64> m_FreeBits;				// Bit per node, set when the block of the node is on a free list
+
+		size_t m_UsedMemory;			// The total memory used by this allocator
+		size_t m_Allocations;			// The total number of allocations this allocator has made
+
+		[[no_unique_address]] AllocatorStats m_Stats;		// The statistics of the allocator, empty when compiled out
+	};
+}
@@ -0,0 +1,413 @@
+#include "JupiterCompactingHeap.h"
+
+#include "JupiterAllocatorExceptions.h"
+#include "JupiterVirtualMemory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Stored in front of every block, padded to HeaderSize so the memory after it stays aligned
+	/// </summary>
+	struct CompactingHeap::block_header {
+		size_t size;					// The usable size of the block, excluding the header
+		size_t prevSize;				// The usable size of the block before it, zero for the first block
+		uint32 handle;					// The handle slot of a live block
+		uint32 free;					// Non zero while the block is free
+	};
+
+	namespace {
+
+		/// <summary>
+		/// Stored inside of every free block, links it in the free list
+		/// </summary>
+		struct free_links {
+			CompactingHeap::block_header* prev;		// Previous free block
+			CompactingHeap::block_header* next;		// Next free block
+		};
+
+		static_assert(sizeof(CompactingHeap::block_header) <= CompactingHeap::HeaderSize, "The block header does not fit in HeaderSize!");
+		static_assert(sizeof(free_links) <= CompactingHeap::MinBlockSize, "The free list links do not fit in the smallest block!");
+
+		inline size_t align_up(size_t value, size_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		inline free_links* links_of(CompactingHeap::block_header* block) {
+			return reinterpret_cast<free_links*>(pointer_functions::shift_forward(block, CompactingHeap::HeaderSize));
+		}
+	}
+
+	// ----- CompactingHeap::Pin Start -----
+
+	CompactingHeap::Pin::Pin(Pin&& other) noexcept :
+		m_Heap(other.m_Heap), m_Slot(other.m_Slot), m_Pointer(other.m_Pointer)
+	{
+		other.m_Heap = nullptr;
+		other.m_Pointer = nullptr;
+	}
+
+	CompactingHeap::Pin::~Pin() {
+		if (m_Heap != nullptr) m_Heap->unpin(m_Slot);
+	}
+
+	// ----- CompactingHeap::Pin End -----
+
+	CompactingHeap::CompactingHeap(size_t reservedSize) :
+		m_Start(nullptr), m_Reserved(align_up(reservedSize, DecommitThreshold)), m_Committed(0), m_Top(0), m_LastSize(0),
+		m_FreeList(nullptr), m_Cursor(0), m_FreeHandle(EndOfList),
+		m_UsedMemory(0), m_FreeMemory(0), m_FreeBlocks(0), m_Allocations(0)
+	{
+		m_Start = virtual_memory::reserve(m_Reserved);
+		if (m_Start == nullptr) throw std::bad_alloc();
+	}
+
+	CompactingHeap::~CompactingHeap() {
+		if (m_Allocations != 0) {
+			allocator_stats::reportLeak("CompactingHeap", m_Allocations, m_UsedMemory);
+		}
+		virtual_memory::release(m_Start, m_Reserved);
+	}
+
+	slot_handle CompactingHeap::allocate(size_t size) {
+		if (size > m_Reserved) {
+			m_Stats.recordFailure();
+			throw std::bad_alloc();
+		}
+		size_t requested = size;
+		size = align_up(size < MinBlockSize ? MinBlockSize : size, Alignment);
+
+		// The slot is added to the handle table first, so a full table cannot leak a block
+		if (m_FreeHandle == EndOfList) {
+			if (m_Handles.size() >= EndOfList) throw std::bad_alloc();
+			m_Handles.push_back({ nullptr, EndOfList, 0, 0 });
+			m_FreeHandle = (uint32)m_Handles.size() - 1;
+		}
+
+		block_header* block = nullptr;
+		for (block_header* free = m_FreeList; free != nullptr; free = links_of(free)->next) {
+			if (free->size >= size) {
+				block = free;
+				break;
+			}
+		}
+
+		if (block != nullptr) {
+			unlinkFree(block);
+			block->free = 0;
+			split(block, size);
+		}
+		else {
+			// No free block fits, the block goes on top of the heap
+			size_t top = m_Top + HeaderSize + size;
+			if (HeaderSize + size > m_Reserved - m_Top) {
+				m_Stats.recordFailure();
+				throw std::bad_alloc();
+			}
+			if (top > m_Committed) {
+				size_t committed = align_up(top, DecommitThreshold);
+				if (!virtual_memory::commit(pointer_functions::shift_forward(m_Start, m_Committed), committed - m_Committed)) {
+					m_Stats.recordFailure();
+					throw std::bad_alloc();
+				}
+				m_Committed = committed;
+			}
+
+			block = blockAt(m_Top);
+			block->size = size;
+			block->prevSize = m_LastSize;
+			block->free = 0;
+			m_LastSize = size;
+			m_Top = top;
+		}
+
+		uint32 index = m_FreeHandle;
+		handle_slot& slot = m_Handles[index];
+		m_FreeHandle = slot.nextFree;
+		slot.block = block;
+		slot.generation++;
+		slot.pins = 0;
+		block->handle = index;
+
+		m_UsedMemory += block->size;
+		m_Allocations++;
+		m_Stats.recordAllocation(requested, block->size);
+		return { index, slot.generation };
+	}
+
+	void CompactingHeap::free(slot_handle handle) {
+		handle_slot& slot = slotOf(handle);
+		if (slot.pins != 0) {
+			throw jpt_bad_free("Compacting heap cannot free a block that is pinned!");
+		}
+
+		block_header* block = slot.block;
+		m_UsedMemory -= block->size;
+		m_Allocations--;
+		m_Stats.recordDeallocation(block->size);
+
+		slot.block = nullptr;
+		slot.generation++;
+		slot.nextFree = m_FreeHandle;
+		m_FreeHandle = handle.index;
+
+		block->free = 1;
+		releaseFree(block);
+	}
+
+	CompactingHeap::Pin CompactingHeap::pin(slot_handle handle) {
+		handle_slot& slot = slotOf(handle);
+		slot.pins++;
+		return Pin(this, handle.index, payloadOf(slot.block));
+	}
+
+	size_t CompactingHeap::defragment(std::chrono::nanoseconds budget) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		size_t moved = 0;
+		uint32 skipped = 0;
+
+		// The free blocks sorted by size, so the smallest free block a block fits in is found with a binary search
+		m_Holes.clear();
+		size_t lowest = m_Top;
+		for (block_header* free = m_FreeList; free != nullptr; free = links_of(free)->next) {
+			m_Holes.push_back({ free->size, free, 0 });
+			if (offsetOf(free) < lowest) lowest = offsetOf(free);
+		}
+		std::sort(m_Holes.begin(), m_Holes.end(), [](const free_hole& a, const free_hole& b) { return a.size != b.size ? a.size < b.size : a.block < b.block; });
+		for (size_t i = 0; i < m_Holes.size(); i++) m_Holes[i].next = i + 1;
+
+		// A used free block is skipped for the rest of the call, the links to the next free block that is not used are shortened on the way
+		auto findHole = [this](size_t index) {
+			size_t found = index;
+			while (found < m_Holes.size() && m_Holes[found].block == nullptr) found = m_Holes[found].next;
+			while (index != found) {
+				size_t next = m_Holes[index].next;
+				m_Holes[index].next = found;
+				index = next;
+			}
+			return found;
+		};
+
+		// Moving a block costs only its own size, so blocks are taken from the top and moved into the free block below them that fits best.
+		// A free block below the walk only grows when a moved block is merged with it, so the sizes in the sorted list stay a lower bound.
+		// Free blocks above the walk are never used again, they can be merged away
+		block_header* block = m_Top != 0 ? blockAt(m_Top - HeaderSize - m_LastSize) : nullptr;
+		while (block != nullptr && offsetOf(block) > lowest) {
+			block_header* prev = prevBlock(block);
+			size_t bytes = 0;
+			if (block->free == 0 && m_Handles[block->handle].pins == 0) {
+				size_t offset = offsetOf(block);
+				size_t index = std::lower_bound(m_Holes.begin(), m_Holes.end(), block->size, [](const free_hole& hole, size_t size) { return hole.size < size; }) - m_Holes.begin();
+				for (index = findHole(index); index < m_Holes.size() && offsetOf(m_Holes[index].block) > offset; index = findHole(index)) {
+					m_Holes[index].block = nullptr;
+				}
+				if (index < m_Holes.size()) {
+					bytes = relocate(block, m_Holes[index].block);
+					m_Holes[index].block = nullptr;
+				}
+			}
+			moved += bytes;
+
+			// The call may stop once a block was moved, the clock is only read every 64 blocks that are not moved
+			if (moved != 0 && (bytes != 0 || ++skipped % 64 == 0) && std::chrono::steady_clock::now() - start >= budget) return moved;
+			block = prev;
+		}
+		if (moved != 0) return moved;
+
+		// No block fits in a free block below it, so live blocks slide down instead.
+		// Every free block below the cursor lies below a pinned block, so the walk continues where the last call stopped
+		while (m_Cursor < m_Top) {
+			block_header* block = blockAt(m_Cursor);
+			if (block->free == 0 || m_Handles[nextBlock(block)->handle].pins != 0) {
+				// Skip live blocks and the free block below a pinned block, the walk is cheap but a large heap still needs the clock
+				block_header* next = block->free == 0 ? block : nextBlock(block);
+				m_Cursor = offsetOf(next) + HeaderSize + next->size;
+				if (++skipped % 1024 == 0 && std::chrono::steady_clock::now() - start >= budget) break;
+				continue;
+			}
+
+			// A free block is never the last block, so there always is a live block after it
+			block_header* next = nextBlock(block);
+			moved += next->size;
+			slide(block, next);
+			m_Cursor += HeaderSize + block->size;
+			if (std::chrono::steady_clock::now() - start >= budget) break;
+		}
+		return moved;
+	}
+
+	bool CompactingHeap::contains(slot_handle handle) const {
+		// The generation of a free slot is even, so it never matches the odd generation of a handle
+		return handle.index < m_Handles.size() && m_Handles[handle.index].generation == handle.generation;
+	}
+
+	size_t CompactingHeap::sizeOf(slot_handle handle) const {
+		return contains(handle) ? m_Handles[handle.index].block->size : 0;
+	}
+
+	CompactingHeap::block_header* CompactingHeap::blockAt(size_t offset) const {
+		return reinterpret_cast<block_header*>(pointer_functions::shift_forward(m_Start, offset));
+	}
+
+	size_t CompactingHeap::offsetOf(const block_header* block) const {
+		return (size_t)(reinterpret_cast<const uint8*>(block) - reinterpret_cast<const uint8*>(m_Start));
+	}
+
+	CompactingHeap::block_header* CompactingHeap::nextBlock(const block_header* block) const {
+		size_t offset = offsetOf(block) + HeaderSize + block->size;
+		return offset < m_Top ? blockAt(offset) : nullptr;
+	}
+
+	CompactingHeap::block_header* CompactingHeap::prevBlock(const block_header* block) const {
+		size_t offset = offsetOf(block);
+		return offset != 0 ? blockAt(offset - HeaderSize - block->prevSize) : nullptr;
+	}
+
+	void* CompactingHeap::payloadOf(block_header* block) {
+		return pointer_functions::shift_forward(block, HeaderSize);
+	}
+
+	void CompactingHeap::linkFree(block_header* block) {
+		free_links* links = links_of(block);
+		links->prev = nullptr;
+		links->next = m_FreeList;
+		if (m_FreeList != nullptr) links_of(m_FreeList)->prev = block;
+		m_FreeList = block;
+
+		m_FreeMemory += HeaderSize + block->size;
+		m_FreeBlocks++;
+	}
+
+	void CompactingHeap::unlinkFree(block_header* block) {
+		free_links* links = links_of(block);
+		if (links->prev != nullptr) links_of(links->prev)->next = links->next;
+		else m_FreeList = links->next;
+		if (links->next != nullptr) links_of(links->next)->prev = links->prev;
+
+		m_FreeMemory -= HeaderSize + block->size;
+		m_FreeBlocks--;
+	}
+
+	void CompactingHeap::split(block_header* block, size_t size) {
+		size_t rest = block->size - size;
+		if (rest < HeaderSize + MinBlockSize) return;
+
+		// Only free blocks are split, and a free block is never the last block
+		block->size = size;
+		block_header* free = reinterpret_cast<block_header*>(pointer_functions::shift_forward(payloadOf(block), size));
+		free->size = rest - HeaderSize;
+		free->prevSize = size;
+		free->handle = EndOfList;
+		free->free = 1;
+		nextBlock(free)->prevSize = free->size;
+		linkFree(free);
+	}
+
+	void CompactingHeap::releaseFree(block_header* block) {
+		block_header* next = nextBlock(block);
+		if (next != nullptr && next->free != 0) {
+			unlinkFree(next);
+			block->size += HeaderSize + next->size;
+		}
+
+		block_header* prev = prevBlock(block);
+		if (prev != nullptr && prev->free != 0) {
+			unlinkFree(prev);
+			prev->size += HeaderSize + block->size;
+			block = prev;
+		}
+
+		next = nextBlock(block);
+		if (next != nullptr) {
+			next->prevSize = block->size;
+			linkFree(block);
+		}
+		else {
+			lowerTop(block);
+		}
+
+		// A new free block below the cursor has to be walked again
+		size_t offset = offsetOf(block);
+		if (m_Cursor > offset) m_Cursor = offset;
+	}
+
+	void CompactingHeap::lowerTop(block_header* block) {
+		m_Top = offsetOf(block);
+		m_LastSize = block->prevSize;
+
+		// Keep some committed memory above the top, so a heap going up and down around a boundary does not commit on every allocation
+		size_t keep = align_up(m_Top, DecommitThreshold) + DecommitThreshold;
+		if (m_Committed > keep) {
+			virtual_memory::decommit(pointer_functions::shift_forward(m_Start, keep), m_Committed - keep);
+			m_Committed = keep;
+		}
+	}
+
+	void CompactingHeap::slide(block_header* free, block_header* block) {
+		size_t freeSize = free->size;
+		size_t prevSize = free->prevSize;
+		size_t size = block->size;
+		uint32 handle = block->handle;
+
+		// The live block takes the place of the free block, the free block moves up behind it with the same size
+		unlinkFree(free);
+		std::memmove(payloadOf(free), payloadOf(block), size);
+		free->size = size;
+		free->prevSize = prevSize;
+		free->handle = handle;
+		free->free = 0;
+		m_Handles[handle].block = free;
+
+		block_header* moved = reinterpret_cast<block_header*>(pointer_functions::shift_forward(payloadOf(free), size));
+		moved->size = freeSize;
+		moved->prevSize = size;
+		moved->handle = EndOfList;
+		moved->free = 1;
+		releaseFree(moved);
+	}
+
+	size_t CompactingHeap::relocate(block_header* block, block_header* free) {
+		// The free block lies below the block and is at least as large, so the copy never overlaps
+		size_t size = block->size;
+		handle_slot& slot = m_Handles[block->handle];
+		unlinkFree(free);
+		std::memcpy(payloadOf(free), payloadOf(block), size);
+		free->handle = block->handle;
+		free->free = 0;
+		split(free, size);
+		slot.block = free;
+
+		// A rest too small to split off stays part of the block
+		if (free->size != size) {
+			m_UsedMemory += free->size - size;
+			m_Stats.recordResize(size, free->size);
+		}
+
+		// The part split off lies below the cursor when the free block did
+		block_header* next = nextBlock(free);
+		if (next->free != 0 && offsetOf(next) < m_Cursor) m_Cursor = offsetOf(next);
+
+		block->free = 1;
+		releaseFree(block);
+		return size;
+	}
+
+	CompactingHeap::handle_slot& CompactingHeap::slotOf(slot_handle handle) {
+		if (!contains(handle)) {
+			throw jpt_bad_free("Compacting heap cannot use a handle that is stale or does not belong to it!");
+		}
+		return m_Handles[handle.index];
+	}
+
+	void CompactingHeap::unpin(uint32 slot) {
+		handle_slot& s = m_Handles[slot];
+		if (--s.pins != 0) return;
+
+		// The free block below the block could not be filled while it was pinned
+		block_header* prev = prevBlock(s.block);
+		if (prev != nullptr && prev->free != 0 && offsetOf(prev) < m_Cursor) m_Cursor = offsetOf(prev);
+	}
+}
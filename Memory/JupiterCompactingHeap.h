@@ -0,0 +1,172 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+#include "JupiterSlotMap.h"
+
+#include <chrono>
+#include <vector>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Heap for long running processes that moves its blocks to keep its memory from fragmenting, eg. resource data of a server.
+	/// Clients hold handles instead of pointers, a pointer to a block is only valid while the block is pinned by a Pin.
+	///
+	/// Blocks lie back to back in a reserved range of addresses, every block has a header with its size and the size of the block
+	/// before it, so free blocks are merged with their neighbours immediately. New blocks are taken from the first free block
+	/// that fits, otherwise from the top of the heap. A free block at the top lowers the top and the pages above it are decommitted.
+	///
+	/// defragment takes blocks from the top and moves each into the smallest free block below it that fits, which lowers the top
+	/// while only copying the blocks that are moved. When no block fits anywhere it slides live blocks down into the free blocks
+	/// below them instead, a little at a time within a time budget, so over time all free memory ends up at the top where it is returned to the system.
+	/// Pinned blocks are never moved, the free block below a pinned block stays until the pin is released.
+	/// The heap is not thread safe.
+	/// </summary>
+	class CompactingHeap {
+
+	public:
+		struct block_header;				// Header in front of every block, defined in JupiterCompactingHeap.cpp
+
+		static constexpr size_t Alignment = 16;				// The alignment of every block
+		static constexpr size_t HeaderSize = 32;			// The size of the header in front of every block
+		static constexpr size_t MinBlockSize = 16;			// The smallest block, a free block holds the links of the free list
+		static constexpr size_t DecommitThreshold = 64 * 1024;	// The granularity memory is committed in, at most twice this is kept committed above the top
+		static constexpr uint32 EndOfList = 0xFFFFFFFF;			// Index marking the end of the handle free list
+
+		/// <summary>
+		/// RAII guard pinning a block, the block is not moved by defragment while a pin exists
+		/// </summary>
+		class Pin {
+
+		public:
+			Pin(const Pin&) = delete;							// Delete copy constructor, every pin unpins once
+			Pin& operator=(const Pin&) = delete;				// Delete copy assignment operator
+			Pin(Pin&& other) noexcept;							// Moves the pin, the other pin no longer pins the block
+			~Pin();												// Unpins the block
+
+			inline void* get() const { return m_Pointer; }		// The address of the block, valid as long as the pin exists
+
+			template<typename T>
+			inline T* as() const { return reinterpret_cast<T*>(m_Pointer); }		// The address of the block as a T
+
+		private:
+			friend class CompactingHeap;
+			Pin(CompactingHeap* heap, uint32 slot, void* pointer) : m_Heap(heap), m_Slot(slot), m_Pointer(pointer) {}
+
+			CompactingHeap* m_Heap;			// The heap of the block, nullptr once the pin has been moved
+			uint32 m_Slot;					// The handle slot of the block
+			void* m_Pointer;				// The address of the block
+		};
+
+	public:
+		CompactingHeap() = delete;
+
+		/// <summary>
+		/// Creates a compacting heap, the address range is reserved on instantiation and committed as the heap grows
+		/// </summary>
+		/// <param name="reservedSize">The size of the address range, the most memory the heap can ever use</param>
+		CompactingHeap(size_t reservedSize);
+
+		CompactingHeap(const CompactingHeap&) = delete;				// Delete copy constructor, the heap owns its memory
+		CompactingHeap& operator=(const CompactingHeap&) = delete;	// Delete copy assignment operator
+
+		~CompactingHeap();											// Releases the memory, reports blocks that were not freed
+
+		/// <summary>
+		/// Allocates a block aligned to 16 bytes
+		/// Throws std::bad_alloc when the reserved range is full
+		/// </summary>
+		/// <returns>The handle of the block</returns>
+		slot_handle allocate(size_t size);
+
+		/// <summary>
+		/// Frees a block, the handle becomes stale
+		/// Throws jpt_bad_free when the handle is stale or the block is pinned
+		/// </summary>
+		void free(slot_handle handle);
+
+		/// <summary>
+		/// Pins a block so it can be accessed through a pointer
+		/// Throws jpt_bad_free when the handle is stale
+		/// </summary>
+		Pin pin(slot_handle handle);
+
+		/// <summary>
+		/// Moves live blocks from the top into the free blocks below them until the budget is spent, live blocks are only slid down
+		/// when none of them fits in a free block. At least one block is moved when there is one to move, so a budget of zero does a single step
+		/// </summary>
+		/// <param name="budget">The time the call may take, checked after every move</param>
+		/// <returns>The amount of bytes moved, zero when the heap is compact apart from the free blocks below pinned blocks</returns>
+		size_t defragment(std::chrono::nanoseconds budget);
+
+		bool contains(slot_handle handle) const;			// Checks if the handle refers to a live block
+		size_t sizeOf(slot_handle handle) const;			// The usable size of a block, the size rounded up to the alignment
+
+		inline const AllocatorStats& getStats() const { return m_Stats; }	// The statistics of the heap
+		inline size_t getReservedSize() const { return m_Reserved; }		// The size of the address range
+		inline size_t getCommittedSize() const { return m_Committed; }		// The bytes committed from the start of the range
+		inline size_t getHeapSize() const { return m_Top; }					// The bytes from the start of the range to the top, including headers
+		inline size_t getUsedMemory() const { return m_UsedMemory; }		// The usable bytes of all live blocks
+		inline size_t getFreeMemory() const { return m_FreeMemory; }		// The bytes in free blocks below the top, including their headers
+		inline size_t getFreeBlocks() const { return m_FreeBlocks; }		// The amount of free blocks below the top
+		inline size_t getAllocations() const { return m_Allocations; }		// The amount of live blocks
+
+	private:
+		/// <summary>
+		/// Live or free entry of the handle table
+		/// </summary>
+		struct handle_slot {
+			block_header* block;			// The block of the handle, nullptr while the slot is free
+			uint32 nextFree;				// The next free slot while the slot is free
+			uint32 generation;				// Odd while the slot refers to a block
+			uint32 pins;					// The amount of pins on the block
+		};
+
+		/// <summary>
+		/// Free block defragment can move a block into
+		/// </summary>
+		struct free_hole {
+			size_t size;					// The size of the free block when defragment started
+			block_header* block;			// The free block, nullptr once it is used or lies above the blocks that are left to move
+			size_t next;					// The index of a later entry, no entry in between is left to use
+		};
+
+		block_header* blockAt(size_t offset) const;				// The block starting at an offset from the start of the range
+		size_t offsetOf(const block_header* block) const;		// The offset of a block from the start of the range
+		block_header* nextBlock(const block_header* block) const;	// The block after a block, nullptr at the top
+		block_header* prevBlock(const block_header* block) const;	// The block before a block, nullptr for the first block
+		static void* payloadOf(block_header* block);				// The address of the memory of a block, right after its header
+
+		void linkFree(block_header* block);						// Adds a free block to the free list
+		void unlinkFree(block_header* block);					// Removes a free block from the free list
+		void split(block_header* block, size_t size);			// Splits the part after the given size of a block off as a free block
+		void releaseFree(block_header* block);					// Merges a free block with its neighbours, lowers the top when it is the last block
+		void lowerTop(block_header* block);						// Makes a free last block part of the space above the top
+		void slide(block_header* free, block_header* block);	// Moves the live block after a free block to the start of the free block
+		size_t relocate(block_header* block, block_header* free);	// Moves a block into a free block below it that fits, returns the bytes moved
+
+		handle_slot& slotOf(slot_handle handle);				// The slot of a live handle, throws jpt_bad_free for a stale handle
+		void unpin(uint32 slot);								// Releases a pin, called by the destructor of Pin
+
+	private:
+		void* m_Start;					// The start of the reserved range
+		size_t m_Reserved;				// The size of the reserved range
+		size_t m_Committed;				// The bytes committed from the start of the range
+		size_t m_Top;					// The offset of the end of the last block
+		size_t m_LastSize;				// The size of the last block, the previous size of a block allocated at the top
+
+		block_header* m_FreeList;		// The first free block below the top
+		size_t m_Cursor;				// The offset defragment continues from, there are no movable free blocks below it
+		std::vector<free_hole> m_Holes;	// The free blocks sorted by size during defragment, kept so its memory is reused
+
+		std::vector<handle_slot> m_Handles;		// The handle table, a handle is an index into it and a generation
+		uint32 m_FreeHandle;					// The first free slot of the handle table, EndOfList when there is none
+
+		size_t m_UsedMemory;			// The usable bytes of all live blocks
+		size_t m_FreeMemory;			// The bytes in free blocks below the top, including their headers
+		size_t m_FreeBlocks;			// The amount of free blocks below the top
+		size_t m_Allocations;			// The amount of live blocks
+
+		[[no_unique_address]] AllocatorStats m_Stats;		// The statistics of the heap, empty when compiled out
+	};
+}
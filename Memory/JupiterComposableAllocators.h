@@ -0,0 +1,230 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Namespace containing the building blocks shared by the composable allocators
+	/// </summary>
+	namespace composable {
+
+		/// <summary>
+		/// Compile time properties of an allocator used inside of a composed allocator.
+		/// Allocators that only release their memory all at once, eg. stack allocators, specialize this so their
+		/// deallocations are dropped instead of throwing
+		/// </summary>
+		/// <typeparam name="A">The type of the allocator</typeparam>
+		template<typename A>
+		struct composable_traits {
+			static constexpr bool CanDeallocate = true;		// Wether or not the allocator can deallocate a single block
+		};
+
+		template<>
+		struct composable_traits<StackAllocator> {
+			static constexpr bool CanDeallocate = false;
+		};
+
+		template<>
+		struct composable_traits<ConcurrentStackAllocator> {
+			static constexpr bool CanDeallocate = false;
+		};
+
+		template<>
+		struct composable_traits<DoubleEndedStackAllocator> {
+			static constexpr bool CanDeallocate = false;
+		};
+
+		/// <summary>
+		/// Deallocates a block when the allocator supports it, otherwise the block is left to the allocator until it is cleared
+		/// </summary>
+		template<typename A>
+		inline void deallocate(A& allocator, void* p);
+
+		/// <summary>
+		/// Deallocates a block of a known size when the allocator supports it
+		/// </summary>
+		template<typename A>
+		inline void deallocate(A& allocator, void* p, size_t size);
+
+		/// <summary>
+		/// Slot type of a pool allocator that serves a bucket, Size bytes aligned to the largest fundamental alignment that fits
+		/// </summary>
+		template<size_t Size>
+		struct alignas(Size >= alignof(std::max_align_t) ? alignof(std::max_align_t) : alignof(void*)) pool_slot {
+			uint8 data[Size];
+		};
+
+		/// <summary>
+		/// Holds a single bucket of a bucketizer, the index keeps buckets of the same type apart
+		/// </summary>
+		template<size_t Index, typename Bucket>
+		struct bucket_holder {
+			Bucket bucket;
+
+			template<typename ...Args>
+			bucket_holder(const Args&... args) : bucket(args...) {}
+		};
+
+		template<typename Sequence, template<size_t> typename Bucket, size_t MinSize, size_t Step>
+		struct bucket_set;
+
+		/// <summary>
+		/// Holds every bucket of a bucketizer, bucket I serves the sizes up to MinSize + I * Step
+		/// </summary>
+		template<size_t ...I, template<size_t> typename Bucket, size_t MinSize, size_t Step>
+		struct bucket_set<std::index_sequence<I...>, Bucket, MinSize, Step> : bucket_holder<I, Bucket<MinSize + I * Step>>... {
+
+			template<typename ...Args>
+			bucket_set(const Args&... args) : bucket_holder<I, Bucket<MinSize + I * Step>>(args...)... {}
+		};
+	}
+
+	/// <summary>
+	/// Pool allocator serving a bucket of Size bytes, used as bucket of a Bucketizer
+	/// </summary>
+	template<size_t Size>
+	using PoolBucket = PoolAllocator<composable::pool_slot<Size>>;
+
+	/// <summary>
+	/// Allocator that tries the primary allocator first and only goes to the fallback allocator when the primary is full,
+	/// eg. a stack arena with the heap as fallback. Deallocations go to the allocator that owns the block, so the primary
+	/// allocator needs to implement owns(p). Both allocators need to implement tryAllocate.
+	/// All calls are resolved at compile time, the allocators are held by value.
+	/// </summary>
+	/// <typeparam name="Primary">The allocator that is tried first</typeparam>
+	/// <typeparam name="Fallback">The allocator used when the primary allocator is full</typeparam>
+	template<StaticAllocator Primary, StaticAllocator Fallback>
+	class FallbackAllocator {
+
+	public:
+		/// <summary>
+		/// Creates both allocators in place from their own set of constructor arguments
+		/// </summary>
+		/// <param name="primaryArgs">The arguments passed to the constructor of the primary allocator</param>
+		/// <param name="fallbackArgs">The arguments passed to the constructor of the fallback allocator</param>
+		template<typename ...PrimaryArgs, typename ...FallbackArgs>
+		FallbackAllocator(std::piecewise_construct_t, std::tuple<PrimaryArgs...> primaryArgs, std::tuple<FallbackArgs...> fallbackArgs);
+
+		FallbackAllocator(const FallbackAllocator&) = delete;				// Delete copy constructor, the allocators own their memory
+		FallbackAllocator& operator=(const FallbackAllocator&) = delete;	// Delete copy assignment operator
+
+		inline void* allocate(size_t size, size_t allignment = 4);				// Allocates from the primary allocator, then from the fallback
+		inline void* tryAllocate(size_t size, size_t allignment = 4) noexcept;	// Same as allocate, but returns nullptr when both are full
+		inline void deallocate(void* p);										// Deallocates the block in the allocator that owns it
+		inline void deallocate(void* p, size_t size);							// Deallocates the block in the allocator that owns it
+		inline bool owns(void* p) const;										// Checks if either allocator owns the block
+
+		inline Primary& getPrimary() { return m_Primary; }				// The allocator that is tried first
+		inline Fallback& getFallback() { return m_Fallback; }			// The allocator used when the primary allocator is full
+
+	private:
+		Primary m_Primary;				// The allocator that is tried first
+		Fallback m_Fallback;			// The allocator used when the primary allocator is full
+	};
+
+	/// <summary>
+	/// Allocator that sends allocations up to Threshold bytes to the small allocator and larger ones to the large allocator,
+	/// eg. a pool for small objects and a block heap for the rest. Sized deallocations are routed on the size,
+	/// unsized deallocations ask the small allocator if it owns the block.
+	/// All calls are resolved at compile time, the allocators are held by value.
+	/// </summary>
+	/// <typeparam name="Threshold">The largest size that goes to the small allocator</typeparam>
+	/// <typeparam name="Small">The allocator serving sizes up to the threshold</typeparam>
+	/// <typeparam name="Large">The allocator serving sizes larger then the threshold</typeparam>
+	template<size_t Threshold, StaticAllocator Small, StaticAllocator Large>
+	class Segregator {
+
+	public:
+		/// <summary>
+		/// Creates both allocators in place from their own set of constructor arguments
+		/// </summary>
+		/// <param name="smallArgs">The arguments passed to the constructor of the small allocator</param>
+		/// <param name="largeArgs">The arguments passed to the constructor of the large allocator</param>
+		template<typename ...SmallArgs, typename ...LargeArgs>
+		Segregator(std::piecewise_construct_t, std::tuple<SmallArgs...> smallArgs, std::tuple<LargeArgs...> largeArgs);
+
+		Segregator(const Segregator&) = delete;					// Delete copy constructor, the allocators own their memory
+		Segregator& operator=(const Segregator&) = delete;		// Delete copy assignment operator
+
+		inline void* allocate(size_t size, size_t allignment = 4);				// Allocates from the allocator matching the size
+		inline void* tryAllocate(size_t size, size_t allignment = 4) noexcept;	// Same as allocate, but returns nullptr when it is full
+		inline void deallocate(void* p);										// Deallocates the block in the allocator that owns it
+		inline void deallocate(void* p, size_t size);							// Deallocates the block in the allocator matching the size
+		inline bool owns(void* p) const;										// Checks if either allocator owns the block
+
+		inline Small& getSmall() { return m_Small; }		// The allocator serving sizes up to the threshold
+		inline Large& getLarge() { return m_Large; }		// The allocator serving sizes larger then the threshold
+
+	private:
+		Small m_Small;				// The allocator serving sizes up to the threshold
+		Large m_Large;				// The allocator serving sizes larger then the threshold
+	};
+
+	/// <summary>
+	/// Allocator with a bucket for every size class between MinSize and MaxSize in steps of Step bytes,
+	/// bucket I serves the sizes up to MinSize + I * Step, eg. one pool per size class with PoolBucket.
+	/// Sizes larger then MaxSize are not served, combine the bucketizer with a Segregator to handle those.
+	/// Selecting the bucket is a division and an unrolled compare over the bucket indices, all resolved at compile time.
+	/// </summary>
+	/// <typeparam name="Bucket">Allocator template serving blocks of up to the given size</typeparam>
+	/// <typeparam name="MinSize">The size served by the first bucket</typeparam>
+	/// <typeparam name="MaxSize">The size served by the last bucket</typeparam>
+	/// <typeparam name="Step">The difference in size between two buckets</typeparam>
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	class Bucketizer {
+
+		static_assert(Step > 0 && MinSize > 0 && MaxSize >= MinSize, "Bucketizer needs at least one bucket and a step larger then zero!");
+		static_assert((MaxSize - MinSize) % Step == 0, "The size range of a bucketizer needs to be a multiple of the step!");
+
+	public:
+		static constexpr size_t BucketCount = (MaxSize - MinSize) / Step + 1;		// The amount of buckets
+
+	public:
+		/// <summary>
+		/// Creates every bucket from the same set of constructor arguments
+		/// </summary>
+		/// <param name="...args">The arguments passed to the constructor of every bucket, eg. the slots per slab of a pool</param>
+		template<typename ...Args>
+		Bucketizer(const Args&... args);
+
+		Bucketizer(const Bucketizer&) = delete;					// Delete copy constructor, the buckets own their memory
+		Bucketizer& operator=(const Bucketizer&) = delete;		// Delete copy assignment operator
+
+		inline void* allocate(size_t size, size_t allignment = 4);				// Allocates from the bucket matching the size
+		inline void* tryAllocate(size_t size, size_t allignment = 4) noexcept;	// Same as allocate, but returns nullptr when it is full
+		inline void deallocate(void* p);										// Deallocates the block in the bucket that owns it
+		inline void deallocate(void* p, size_t size);							// Deallocates the block in the bucket matching the size
+		inline bool owns(void* p) const;										// Checks if any bucket owns the block
+
+		/// <summary>
+		/// Gets the index of the bucket serving the given size, BucketCount when the size is larger then MaxSize
+		/// </summary>
+		static constexpr size_t bucketIndex(size_t size);
+
+		/// <summary>
+		/// Gets a bucket by index
+		/// </summary>
+		template<size_t Index>
+		inline Bucket<MinSize + Index * Step>& getBucket();
+
+	private:
+		template<size_t ...I>
+		inline void* tryAllocateBucket(size_t index, size_t size, size_t allignment, std::index_sequence<I...>) noexcept;	// Allocates from the bucket with the index
+		template<size_t ...I>
+		inline void deallocateBucket(size_t index, void* p, size_t size, std::index_sequence<I...>);	// Deallocates in the bucket with the index
+		template<size_t ...I>
+		inline bool deallocateOwner(void* p, std::index_sequence<I...>);		// Deallocates in the bucket that owns the block, false if there is none
+		template<size_t ...I>
+		inline bool ownsAny(void* p, std::index_sequence<I...>) const;			// Checks every bucket for ownership of the block
+
+	private:
+		composable::bucket_set<std::make_index_sequence<BucketCount>, Bucket, MinSize, Step> m_Buckets;	// All buckets, ordered by size
+	};
+}
+
+#include "JupiterComposableAllocators.inl"
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "JupiterAllocatorExceptions.h"
+
+#include <new>
+#include <tuple>
+#include <utility>
+
+namespace Jupiter {
+
+	namespace composable {
+
+		template<typename A>
+		void deallocate(A& allocator, void* p) {
+			if constexpr (composable_traits<A>::CanDeallocate) allocator.deallocate(p);
+		}
+
+		template<typename A>
+		void deallocate(A& allocator, void* p, size_t size) {
+			if constexpr (composable_traits<A>::CanDeallocate) allocator.deallocate(p, size);
+		}
+	}
+
+	// ----- FallbackAllocator Start -----
+
+	template<StaticAllocator Primary, StaticAllocator Fallback>
+	template<typename ...PrimaryArgs, typename ...FallbackArgs>
+	FallbackAllocator<Primary, Fallback>::FallbackAllocator(std::piecewise_construct_t, std::tuple<PrimaryArgs...> primaryArgs, std::tuple<FallbackArgs...> fallbackArgs) :
+		m_Primary(std::make_from_tuple<Primary>(std::move(primaryArgs))), m_Fallback(std::make_from_tuple<Fallback>(std::move(fallbackArgs)))
+	{}
+
+	template<StaticAllocator Primary, StaticAllocator Fallback>
+	void* FallbackAllocator<Primary, Fallback>::allocate(size_t size, size_t allignment) {
+		void* p = m_Primary.tryAllocate(size, allignment);
+		if (p == nullptr) p = m_Fallback.allocate(size, allignment);
+		return p;
+	}
+
+	template<StaticAllocator Primary, StaticAllocator Fallback>
+	void* FallbackAllocator<Primary, Fallback>::tryAllocate(size_t size, size_t allignment) noexcept {
+		void* p = m_Primary.tryAllocate(size, allignment);
+		if (p == nullptr) p = m_Fallback.tryAllocate(size, allignment);
+		return p;
+	}
+
+	template<StaticAllocator Primary, StaticAllocator Fallback>
+	void FallbackAllocator<Primary, Fallback>::deallocate(void* p) {
+		if (p == nullptr) return;
+		if (m_Primary.owns(p)) composable::deallocate(m_Primary, p);
+		else composable::deallocate(m_Fallback, p);
+	}
+
+	template<StaticAllocator Primary, StaticAllocator Fallback>
+	void FallbackAllocator<Primary, Fallback>::deallocate(void* p, size_t size) {
+		if (p == nullptr) return;
+		if (m_Primary.owns(p)) composable::deallocate(m_Primary, p, size);
+		else composable::deallocate(m_Fallback, p, size);
+	}
+
+	template<StaticAllocator Primary, StaticAllocator Fallback>
+	bool FallbackAllocator<Primary, Fallback>::owns(void* p) const {
+		return m_Primary.owns(p) || m_Fallback.owns(p);
+	}
+
+	// ----- FallbackAllocator End -----
+
+	// ----- Segregator Start -----
+
+	template<size_t Threshold, StaticAllocator Small, StaticAllocator Large>
+	template<typename ...SmallArgs, typename ...LargeArgs>
+	Segregator<Threshold, Small, Large>::Segregator(std::piecewise_construct_t, std::tuple<SmallArgs...> smallArgs, std::tuple<LargeArgs...> largeArgs) :
+		m_Small(std::make_from_tuple<Small>(std::move(smallArgs))), m_Large(std::make_from_tuple<Large>(std::move(largeArgs)))
+	{}
+
+	template<size_t Threshold, StaticAllocator Small, StaticAllocator Large>
+	void* Segregator<Threshold, Small, Large>::allocate(size_t size, size_t allignment) {
+		if (size <= Threshold) return m_Small.allocate(size, allignment);
+		return m_Large.allocate(size, allignment);
+	}
+
+	template<size_t Threshold, StaticAllocator Small, StaticAllocator Large>
+	void* Segregator<Threshold, Small, Large>::tryAllocate(size_t size, size_t allignment) noexcept {
+		if (size <= Threshold) return m_Small.tryAllocate(size, allignment);
+		return m_Large.tryAllocate(size, allignment);
+	}
+
+	template<size_t Threshold, StaticAllocator Small, StaticAllocator Large>
+	void Segregator<Threshold, Small, Large>::deallocate(void* p) {
+		if (p == nullptr) return;
+		if (m_Small.owns(p)) composable::deallocate(m_Small, p);
+		else composable::deallocate(m_Large, p);
+	}
+
+	template<size_t Threshold, StaticAllocator Small, StaticAllocator Large>
+	void Segregator<Threshold, Small, Large>::deallocate(void* p, size_t size) {
+		if (p == nullptr) return;
+		if (size <= Threshold) composable::deallocate(m_Small, p, size);
+		else composable::deallocate(m_Large, p, size);
+	}
+
+	template<size_t Threshold, StaticAllocator Small, StaticAllocator Large>
+	bool Segregator<Threshold, Small, Large>::owns(void* p) const {
+		return m_Small.owns(p) || m_Large.owns(p);
+	}
+
+	// ----- Segregator End -----
+
+	// ----- Bucketizer Start -----
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	template<typename ...Args>
+	Bucketizer<Bucket, MinSize, MaxSize, Step>::Bucketizer(const Args&... args) :
+		m_Buckets(args...)
+	{}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	void* Bucketizer<Bucket, MinSize, MaxSize, Step>::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	void* Bucketizer<Bucket, MinSize, MaxSize, Step>::tryAllocate(size_t size, size_t allignment) noexcept {
+		return tryAllocateBucket(bucketIndex(size), size, allignment, std::make_index_sequence<BucketCount>());
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	void Bucketizer<Bucket, MinSize, MaxSize, Step>::deallocate(void* p) {
+		if (p == nullptr) return;
+		if (!deallocateOwner(p, std::make_index_sequence<BucketCount>())) {
+			throw jpt_bad_free("Bucketizer cannot deallocate a block none of its buckets own!");
+		}
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	void Bucketizer<Bucket, MinSize, MaxSize, Step>::deallocate(void* p, size_t size) {
+		if (p == nullptr) return;
+
+		size_t index = bucketIndex(size);
+		if (index >= BucketCount) {
+			throw jpt_bad_free("Bucketizer cannot deallocate a block larger than its largest bucket!");
+		}
+		deallocateBucket(index, p, size, std::make_index_sequence<BucketCount>());
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	bool Bucketizer<Bucket, MinSize, MaxSize, Step>::owns(void* p) const {
+		return ownsAny(p, std::make_index_sequence<BucketCount>());
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	constexpr size_t Bucketizer<Bucket, MinSize, MaxSize, Step>::bucketIndex(size_t size) {
+		if (size <= MinSize) return 0;
+		if (size > MaxSize) return BucketCount;
+		return (size - MinSize + Step - 1) / Step;
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	template<size_t Index>
+	Bucket<MinSize + Index * Step>& Bucketizer<Bucket, MinSize, MaxSize, Step>::getBucket() {
+		return static_cast<composable::bucket_holder<Index, Bucket<MinSize + Index * Step>>&>(m_Buckets).bucket;
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	template<size_t ...I>
+	void* Bucketizer<Bucket, MinSize, MaxSize, Step>::tryAllocateBucket(size_t index, size_t size, size_t allignment, std::index_sequence<I...>) noexcept {
+		// Unrolls to a compare per bucket, the compiler is free to turn it into a jump table
+		void* p = nullptr;
+		((index == I ? (p = getBucket<I>().tryAllocate(size, allignment), true) : false) || ...);
+		return p;
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	template<size_t ...I>
+	void Bucketizer<Bucket, MinSize, MaxSize, Step>::deallocateBucket(size_t index, void* p, size_t size, std::index_sequence<I...>) {
+		((index == I ? (composable::deallocate(getBucket<I>(), p, size), true) : false) || ...);
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	template<size_t ...I>
+	bool Bucketizer<Bucket, MinSize, MaxSize, Step>::deallocateOwner(void* p, std::index_sequence<I...>) {
+		return ((getBucket<I>().owns(p) ? (composable::deallocate(getBucket<I>(), p), true) : false) || ...);
+	}
+
+	template<template<size_t> typename Bucket, size_t MinSize, size_t MaxSize, size_t Step>
+	template<size_t ...I>
+	bool Bucketizer<Bucket, MinSize, MaxSize, Step>::ownsAny(void* p, std::index_sequence<I...>) const {
+		return (static_cast<const composable::bucket_holder<I, Bucket<MinSize + I * Step>>&>(m_Buckets).bucket.owns(p) || ...);
+	}
+
+	// ----- Bucketizer End -----
+}
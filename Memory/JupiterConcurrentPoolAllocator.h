@@ -0,0 +1,90 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Thread safe version of the PoolAllocator, any thread can allocate and any thread can deallocate without locking.
+	/// The free slots form a Treiber stack. The head of the stack is a single 64 bit value with the index of the top slot in the
+	/// lower half and a tag in the upper half, the tag is incremented on every change so a compare and swap of a head that was
+	/// popped and pushed back in the meantime fails (ABA safe). Using indices instead of pointers keeps the head at 64 bits,
+	/// so no 128 bit compare and swap is needed.
+	///
+	/// The pool grows by chaining slabs, every new slab is twice the size of the previous one. Slabs are only released when
+	/// the pool is destroyed, so reading the next index of a slot that was just popped by another thread is always safe.
+	/// Growing takes a mutex, but only when the stack is empty.
+	/// </summary>
+	/// <typeparam name="T">The type of the objects stored in the pool</typeparam>
+	template<typename T>
+	class ConcurrentPoolAllocator final : public IAllocator {
+
+	public:
+		static constexpr size_t SlotAlignment = alignof(T) > alignof(uint32) ? alignof(T) : alignof(uint32);
+		static constexpr size_t SlotSize = ((sizeof(T) > sizeof(uint32) ? sizeof(T) : sizeof(uint32)) + SlotAlignment - 1) & ~(SlotAlignment - 1);
+		static constexpr uint32 MaxSlabs = 32;						// The maximum amount of slabs chained to the pool
+		static constexpr uint32 EmptyIndex = ~0u;					// Index marking the end of the stack
+
+	public:
+		/// <summary>
+		/// Creates a concurrent pool allocator, the first slab is allocated immediately
+		/// </summary>
+		/// <param name="slotsInFirstSlab">The amount of slots in the first slab, rounded up to a power of two</param>
+		/// <param name="growable">When true a new slab is chained to the pool once it is empty, otherwise std::bad_alloc is thrown</param>
+		ConcurrentPoolAllocator(size_t slotsInFirstSlab = 1024, bool growable = true);
+
+		ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;				// Delete copy constructor, the pool owns its slabs
+		ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&) = delete;	// Delete copy assignment operator
+
+		virtual ~ConcurrentPoolAllocator() override;									// Override virtual destructor, releases all slabs
+		virtual void* allocate(size_t size = sizeof(T), size_t allignment = alignof(T)) override;	// Pops a slot from the stack
+		virtual void deallocate(void* p) override;										// Pushes the slot back on the stack
+		virtual void deallocate(void* p, size_t size) override;							// Same as deallocate(p), every slot has the same size
+
+		/// <summary>
+		/// Allocates a slot and constructs a T inside of it
+		/// </summary>
+		/// <param name="...args">The arguments passed to the constructor of T</param>
+		/// <returns>A pointer to the newly constructed object</returns>
+		template<typename ...Args>
+		T* create(Args&&... args);
+
+		/// <summary>
+		/// Destructs the object and returns its slot to the pool
+		/// </summary>
+		/// <param name="object">The object created by this pool</param>
+		void destroy(T* object);
+
+		/// <summary>
+		/// Gets the total amount of slots in all slabs
+		/// </summary>
+		size_t getCapacity() const;
+
+		inline size_t getSlabCount() const { return m_SlabCount.load(std::memory_order_acquire); }	// The amount of slabs chained to this pool
+
+	private:
+		inline void* slotAt(uint32 index) const;						// Gets the address of the slot with the given index
+		inline uint32 indexOf(void* p) const;							// Gets the index of the slot at the given address
+		inline std::atomic_ref<uint32> nextOf(uint32 index) const;		// Gets the next index stored in a free slot
+
+		void push(uint32 first, uint32 last);							// Pushes a chain of linked slots on the stack
+		bool grow();													// Chains a new slab, returns false when no slab could be added
+
+		inline static uint64 makeHead(uint64 head, uint32 index) { return (((head >> 32) + 1) << 32) | index; }
+
+	private:
+		size_t m_SlotsInFirstSlabLog2;					// Log2 of the amount of slots in the first slab
+		bool m_Growable;								// Flag wether or not the pool is allowed to allocate more slabs
+
+		alignas(CacheLineSize) std::atomic<uint64> m_Head;			// Index of the top slot and the ABA tag, on its own cache line
+
+		alignas(CacheLineSize) std::atomic<uint8*> m_Slabs[MaxSlabs];	// The slabs, slab k holds (slotsInFirstSlab << k) slots
+		std::atomic<uint32> m_SlabCount;								// The amount of slabs chained to this pool
+		std::mutex m_GrowMutex;											// Makes sure only one thread chains a new slab
+	};
+}
+
+#include "JupiterConcurrentPoolAllocator.inl"
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "JupiterAllocatorExceptions.h"
+
+#include <bit>
+#include <new>
+#include <utility>
+
+namespace Jupiter {
+
+	template<typename T>
+	ConcurrentPoolAllocator<T>::ConcurrentPoolAllocator(size_t slotsInFirstSlab, bool growable) :
+		m_SlotsInFirstSlabLog2(std::bit_width(slotsInFirstSlab > 1 ? slotsInFirstSlab - 1 : 1)), m_Growable(growable),
+		m_Head(EmptyIndex), m_SlabCount(0)
+	{
+		for (uint32 i = 0; i < MaxSlabs; i++) m_Slabs[i].store(nullptr, std::memory_order_relaxed);
+
+		// Allocate the first slab up front, so a non growable pool has all of its memory on instantiation
+		if (!grow()) throw std::bad_alloc();
+	}
+
+	template<typename T>
+	ConcurrentPoolAllocator<T>::~ConcurrentPoolAllocator() {
+		uint32 slabCount = m_SlabCount.load(std::memory_order_acquire);
+		for (uint32 k = 0; k < slabCount; k++) {
+			::operator delete(m_Slabs[k].load(std::memory_order_relaxed), std::align_val_t(SlotAlignment));
+		}
+	}
+
+	template<typename T>
+	void* ConcurrentPoolAllocator<T>::allocate(size_t size, size_t allignment) {
+		// The pool can only hand out slots, check if the requested block fits inside of one
+		if (size > SlotSize || allignment > SlotAlignment) {
+			throw std::bad_alloc();
+		}
+
+		uint64 head = m_Head.load(std::memory_order_acquire);
+		while (true) {
+			uint32 index = (uint32)head;
+			if (index == EmptyIndex) {
+				// The stack is empty, chain a new slab and try again
+				if (!(m_Growable && grow())) throw std::bad_alloc();
+				head = m_Head.load(std::memory_order_acquire);
+				continue;
+			}
+
+			// The slot may be popped and reused by another thread before the compare and swap, in that case the next index
+			// read here is garbage but the tag of the head has changed so the compare and swap fails
+			uint32 next = nextOf(index).load(std::memory_order_relaxed);
+			if (m_Head.compare_exchange_weak(head, makeHead(head, next), std::memory_order_acquire, std::memory_order_acquire)) {
+				return slotAt(index);
+			}
+		}
+	}
+
+	template<typename T>
+	void ConcurrentPoolAllocator<T>::deallocate(void* p) {
+		if (p == nullptr) return;
+
+		uint32 index = indexOf(p);
+		if (index == EmptyIndex) {
+			throw jpt_bad_free("Concurrent pool allocator cannot deallocate a block it does not own!");
+		}
+		push(index, index);
+	}
+
+	template<typename T>
+	void ConcurrentPoolAllocator<T>::deallocate(void* p, size_t size) {
+		if (size > SlotSize) {
+			throw jpt_bad_free("Concurrent pool allocator cannot deallocate a block larger than its slot size!");
+		}
+		deallocate(p);
+	}
+
+	template<typename T>
+	template<typename ...Args>
+	T* ConcurrentPoolAllocator<T>::create(Args&&... args) {
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void ConcurrentPoolAllocator<T>::destroy(T* object) {
+		if (object == nullptr) return;
+		object->~T();
+		deallocate(object);
+	}
+
+	template<typename T>
+	size_t ConcurrentPoolAllocator<T>::getCapacity() const {
+		// Slab k holds (first << k) slots, so all slabs together hold first * (2^count - 1) slots
+		return (((size_t)1 << getSlabCount()) - 1) << m_SlotsInFirstSlabLog2;
+	}
+
+	template<typename T>
+	void* ConcurrentPoolAllocator<T>::slotAt(uint32 index) const {
+		// The first index of slab k is first * (2^k - 1), so the slab follows from the most significant bit of index / first + 1
+		size_t first = (size_t)1 << m_SlotsInFirstSlabLog2;
+		uint32 slab = (uint32)std::bit_width(((size_t)index >> m_SlotsInFirstSlabLog2) + 1) - 1;
+		size_t offset = (size_t)index + first - (first << slab);
+		return m_Slabs[slab].load(std::memory_order_relaxed) + offset * SlotSize;
+	}
+
+	template<typename T>
+	uint32 ConcurrentPoolAllocator<T>::indexOf(void* p) const {
+		// Search from the newest slab, it holds half of all the slots
+		uint8* address = reinterpret_cast<uint8*>(p);
+		uint32 slabCount = m_SlabCount.load(std::memory_order_acquire);
+		for (uint32 slab = slabCount; slab-- > 0;) {
+			uint8* start = m_Slabs[slab].load(std::memory_order_relaxed);
+			size_t slots = (size_t)1 << (m_SlotsInFirstSlabLog2 + slab);
+			if (address >= start && address < start + slots * SlotSize) {
+				size_t firstIndex = slots - ((size_t)1 << m_SlotsInFirstSlabLog2);
+				return (uint32)(firstIndex + (size_t)(address - start) / SlotSize);
+			}
+		}
+		return EmptyIndex;
+	}
+
+	template<typename T>
+	std::atomic_ref<uint32> ConcurrentPoolAllocator<T>::nextOf(uint32 index) const {
+		return std::atomic_ref<uint32>(*reinterpret_cast<uint32*>(slotAt(index)));
+	}
+
+	template<typename T>
+	void ConcurrentPoolAllocator<T>::push(uint32 first, uint32 last) {
+		uint64 head = m_Head.load(std::memory_order_relaxed);
+		do {
+			nextOf(last).store((uint32)head, std::memory_order_relaxed);
+		} while (!m_Head.compare_exchange_weak(head, makeHead(head, first), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	template<typename T>
+	bool ConcurrentPoolAllocator<T>::grow() {
+		std::lock_guard<std::mutex> lock(m_GrowMutex);
+
+		// Another thread may have grown the pool or returned slots while this thread was waiting for the lock
+		if ((uint32)m_Head.load(std::memory_order_acquire) != EmptyIndex) return true;
+
+		uint32 slab = m_SlabCount.load(std::memory_order_relaxed);
+		if (slab >= MaxSlabs) return false;
+
+		size_t slots = (size_t)1 << (m_SlotsInFirstSlabLog2 + slab);
+		size_t firstIndex = slots - ((size_t)1 << m_SlotsInFirstSlabLog2);
+		if (firstIndex + slots >= EmptyIndex) return false;
+
+		uint8* data = nullptr;
+		try {
+			data = reinterpret_cast<uint8*>(::operator new(slots * SlotSize, std::align_val_t(SlotAlignment)));
+		}
+		catch (std::bad_alloc&) {
+			return false;
+		}
+
+		// Publish the slab before any of its indices can be seen on the stack
+		m_Slabs[slab].store(data, std::memory_order_release);
+		m_SlabCount.store(slab + 1, std::memory_order_release);
+
+		// Link the slots of the slab together and push the entire chain at once
+		for (size_t i = 0; i + 1 < slots; i++) {
+			*reinterpret_cast<uint32*>(data + i * SlotSize) = (uint32)(firstIndex + i + 1);
+		}
+		push((uint32)firstIndex, (uint32)(firstIndex + slots - 1));
+		return true;
+	}
+}
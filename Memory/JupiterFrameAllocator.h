@@ -0,0 +1,88 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <array>
+#include <utility>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Per frame arena for data that lives exactly N frames, eg. upload staging that needs to survive until the GPU fence of its frame.
+	/// Rotates N stack allocators, every frame allocates from the next one. beginFrame clears the oldest arena before it is reused,
+	/// so a block allocated in a frame stays valid until beginFrame has been called N more times.
+	/// Keeps track of the memory used by every frame, so the budget of an arena can be sized to the highest frame seen.
+	/// </summary>
+	/// <typeparam name="N">The amount of frames a block lives, and the amount of arenas</typeparam>
+	template<size_t N>
+	class FrameAllocator final : public IAllocator {
+
+		static_assert(N > 0, "A frame allocator needs at least one arena!");
+
+	public:
+		static constexpr size_t FrameCount = N;			// The amount of frames a block lives
+
+	public:
+		FrameAllocator() = delete;
+
+		/// <summary>
+		/// Creates a frame allocator, the memory of all arenas is allocated on instantiation
+		/// </summary>
+		/// <param name="frameSize">The size of every arena in bytes, the budget of a single frame</param>
+		/// <param name="backing">The way the memory block of every arena is backed</param>
+		FrameAllocator(size_t frameSize, EnumStackBacking backing = EnumStackBacking::Heap);
+
+		FrameAllocator(const FrameAllocator&) = delete;				// Delete copy constructor, the allocator owns its arenas
+		FrameAllocator& operator=(const FrameAllocator&) = delete;	// Delete copy assignment operator
+
+		virtual ~FrameAllocator() override;										// Override virtual destructor, clears the arenas before they release their memory
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Allocates from the arena of the current frame
+		virtual void deallocate(void* p) override;								// Throws exception, blocks are freed when their arena is reused!
+		virtual void deallocate(void* p, size_t size) override;					// Throws exception, blocks are freed when their arena is reused!
+		virtual bool tryResize(void* p, size_t newSize) override;				// Resizes the most recent allocation of the current frame in place
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;	// Resizes or copies within the arena of the current frame
+
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;			// Same as allocate, but returns nullptr when the arena is full
+		bool owns(void* p) const;												// Checks if the address lies inside of one of the arenas
+
+		/// <summary>
+		/// Starts a new frame, records the memory used by the previous frame and clears the arena of the frame N frames ago
+		/// All blocks allocated in that frame are invalid after this call
+		/// </summary>
+		void beginFrame();
+
+		inline uint64 getFrame() const { return m_Frame; }									// The amount of frames begun since instantiation
+		inline StackAllocator& getArena() { return m_Arenas[m_Frame % N]; }				// The arena of the current frame
+		inline size_t getUsedMemory() const { return m_Arenas[m_Frame % N].getUsedMemory(); }	// The bytes allocated in the current frame, including alignment
+		inline size_t getLastFrameUsedMemory() const { return m_LastFrameUsedMemory; }		// The bytes allocated in the previous frame, including alignment
+
+		/// <summary>
+		/// Gets the highest amount of bytes allocated in a single frame, including the current frame
+		/// </summary>
+		inline size_t getHighWatermark() const { return m_HighWatermark > getUsedMemory() ? m_HighWatermark : getUsedMemory(); }
+
+		/// <summary>
+		/// Gets the highest amount of allocations made in a single frame, including the current frame
+		/// </summary>
+		inline size_t getAllocationsHighWatermark() const {
+			size_t allocations = m_Arenas[m_Frame % N].getAllocations();
+			return m_AllocationsHighWatermark > allocations ? m_AllocationsHighWatermark : allocations;
+		}
+
+		void resetHighWatermark();		// Resets the high watermarks to the current frame, eg. after loading a level
+
+	private:
+		template<size_t... I>
+		FrameAllocator(size_t frameSize, EnumStackBacking backing, std::index_sequence<I...>);	// Constructs an arena for every index
+
+	private:
+		std::array<StackAllocator, N> m_Arenas;		// One arena per frame in flight, constructed in place
+		uint64 m_Frame;								// The amount of frames begun, the current arena is m_Frame % N
+
+		size_t m_LastFrameUsedMemory;				// The bytes allocated in the previous frame
+		size_t m_HighWatermark;						// The highest amount of bytes allocated in a single finished frame
+		size_t m_AllocationsHighWatermark;			// The highest amount of allocations made in a single finished frame
+	};
+}
+
+#include "JupiterFrameAllocator.inl"
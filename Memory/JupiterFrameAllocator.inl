@@ -0,0 +1,87 @@
+#pragma once
+
+#include "JupiterAllocatorExceptions.h"
+
+#include <new>
+
+namespace Jupiter {
+
+	template<size_t N>
+	FrameAllocator<N>::FrameAllocator(size_t frameSize, EnumStackBacking backing) :
+		FrameAllocator(frameSize, backing, std::make_index_sequence<N>())
+	{}
+
+	template<size_t N>
+	template<size_t... I>
+	FrameAllocator<N>::FrameAllocator(size_t frameSize, EnumStackBacking backing, std::index_sequence<I...>) :
+		m_Arenas{ { StackAllocator(((void)I, frameSize), backing)... } }, m_Frame(0),
+		m_LastFrameUsedMemory(0), m_HighWatermark(0), m_AllocationsHighWatermark(0)
+	{}
+
+	template<size_t N>
+	FrameAllocator<N>::~FrameAllocator() {
+		// Blocks are never freed one by one, so the blocks left in the arenas are not leaks
+		for (StackAllocator& arena : m_Arenas) arena.clear();
+	}
+
+	template<size_t N>
+	void* FrameAllocator<N>::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	template<size_t N>
+	void* FrameAllocator<N>::tryAllocate(size_t size, size_t allignment) noexcept {
+		return m_Arenas[m_Frame % N].tryAllocate(size, allignment);
+	}
+
+	template<size_t N>
+	void FrameAllocator<N>::deallocate(void* p) {
+		throw jpt_bad_free("Frame allocator cannot deallocate memory, blocks are freed when the arena of their frame is reused!");
+	}
+
+	template<size_t N>
+	void FrameAllocator<N>::deallocate(void* p, size_t size) {
+		throw jpt_bad_free("Frame allocator cannot deallocate memory, blocks are freed when the arena of their frame is reused!");
+	}
+
+	template<size_t N>
+	bool FrameAllocator<N>::tryResize(void* p, size_t newSize) {
+		return m_Arenas[m_Frame % N].tryResize(p, newSize);
+	}
+
+	template<size_t N>
+	void* FrameAllocator<N>::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		return m_Arenas[m_Frame % N].reallocate(p, oldSize, newSize, allignment);
+	}
+
+	template<size_t N>
+	bool FrameAllocator<N>::owns(void* p) const {
+		for (const StackAllocator& arena : m_Arenas) {
+			if (arena.owns(p)) return true;
+		}
+		return false;
+	}
+
+	template<size_t N>
+	void FrameAllocator<N>::beginFrame() {
+		// Nothing is allocated from an arena after its frame ended, so its used memory is final
+		const StackAllocator& previous = m_Arenas[m_Frame % N];
+		m_LastFrameUsedMemory = previous.getUsedMemory();
+		if (m_LastFrameUsedMemory > m_HighWatermark) m_HighWatermark = m_LastFrameUsedMemory;
+		if (previous.getAllocations() > m_AllocationsHighWatermark) m_AllocationsHighWatermark = previous.getAllocations();
+
+		// The arena of the new frame was last used N frames ago
+		m_Frame++;
+		m_Arenas[m_Frame % N].clear();
+	}
+
+	template<size_t N>
+	void FrameAllocator<N>::resetHighWatermark() {
+		m_HighWatermark = 0;
+		m_AllocationsHighWatermark = 0;
+	}
+}
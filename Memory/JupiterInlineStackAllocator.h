@@ -0,0 +1,90 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Stack allocator with its memory block embedded in the allocator itself, eg. a few hundred bytes of temporary space in a hot function.
+	/// Lives on the call stack or inside of another object, so creating one never touches the heap and cannot fail.
+	/// When the buffer is full the allocation is passed on to the parent allocator, without a parent std::bad_alloc is thrown.
+	///
+	/// Unlike the StackAllocator single blocks can be deallocated, so the allocator can be used where blocks are freed.
+	/// Blocks from the parent are returned to the parent, blocks in the buffer have a small header linking them to the block below.
+	/// Freeing the most recent block pops it from the stack, together with every block below it that was already freed.
+	/// Any other block in the buffer is only marked, it is popped once the blocks above it are freed, or freed by clear.
+	/// </summary>
+	/// <typeparam name="N">The size of the embedded buffer in bytes</typeparam>
+	/// <typeparam name="Align">The alignment of the embedded buffer</typeparam>
+	template<size_t N, size_t Align = alignof(std::max_align_t)>
+	class InlineStackAllocator final : public IAllocator {
+
+		static_assert(N > 0, "An inline stack allocator needs a buffer!");
+		static_assert(Align > 0 && (Align & (Align - 1)) == 0, "The alignment of the buffer needs to be a power of two!");
+
+		using offset_type = std::conditional_t<(N < ((size_t)1 << 31)), uint32, size_t>;		// Offset in the buffer, 32 bits unless the buffer is larger
+
+		/// <summary>
+		/// Header in front of every block in the buffer
+		/// </summary>
+		struct block_header {
+			offset_type previousTop;		// The top before the block was allocated, FreedFlag is set once the block is freed while it is not the most recent
+			offset_type previousBlock;		// The offset of the block below, zero when there is none
+		};
+
+		static constexpr offset_type FreedFlag = (offset_type)1 << (sizeof(offset_type) * 8 - 1);	// Highest bit, above any offset in the buffer
+
+	public:
+		static constexpr size_t Capacity = N;						// The size of the embedded buffer in bytes
+		static constexpr size_t HeaderSize = sizeof(block_header);	// The size of the header in front of every block in the buffer
+		static constexpr size_t NoBlock = ~(size_t)0;				// Offset marking that there is no block in the buffer
+
+	public:
+		/// <summary>
+		/// Creates an inline stack allocator, no memory is allocated
+		/// </summary>
+		/// <param name="parent">The allocator used when the buffer is full, nullptr to throw std::bad_alloc instead</param>
+		constexpr InlineStackAllocator(IAllocator* parent = nullptr) noexcept :
+			m_Top(0), m_Last(NoBlock), m_Allocations(0), m_Overflows(0), m_Parent(parent)
+		{}
+
+		InlineStackAllocator(const InlineStackAllocator&) = delete;				// Delete copy constructor, blocks point into the buffer
+		InlineStackAllocator& operator=(const InlineStackAllocator&) = delete;	// Delete copy assignment operator
+
+		virtual ~InlineStackAllocator() override = default;
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Allocates from the buffer, or from the parent when the buffer is full
+		virtual void deallocate(void* p) override;								// Pops or marks a block in the buffer, or returns a block to the parent
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate(p)
+		virtual bool tryResize(void* p, size_t newSize) override;				// Resizes the most recent block in the buffer, or passes the resize on to the parent
+
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;			// Allocates from the buffer only, returns nullptr when the buffer is full
+		bool owns(const void* p) const;											// Checks if the address lies inside of the buffer
+
+		/// <summary>
+		/// Clears the buffer, deallocating all blocks in it. Blocks allocated from the parent are not touched
+		/// </summary>
+		constexpr void clear() noexcept;
+
+		constexpr size_t getUsedMemory() const { return m_Top; }					// The bytes used in the buffer, including headers and alignment
+		constexpr size_t getFreeMemory() const { return N - m_Top; }				// The bytes left in the buffer
+		constexpr size_t getAllocations() const { return m_Allocations; }			// The amount of blocks in the buffer that are not freed
+		constexpr size_t getOverflows() const { return m_Overflows; }				// The amount of blocks passed on to the parent, non zero means N is too small
+		constexpr IAllocator* getParent() const { return m_Parent; }				// The allocator used when the buffer is full
+
+	private:
+		block_header* headerOf(size_t offset);		// The header in front of the block at an offset in the buffer
+
+	private:
+		alignas(Align) uint8 m_Buffer[N];	// The embedded memory block, left uninitialized
+		size_t m_Top;						// Offset of the top of the stack in the buffer
+		size_t m_Last;						// Offset of the most recent block that is not popped, NoBlock when the stack is empty
+		size_t m_Allocations;				// The number of blocks in the buffer that are not freed
+		size_t m_Overflows;					// The number of blocks passed on to the parent
+		IAllocator* m_Parent;				// The allocator used when the buffer is full
+	};
+}
+
+#include "JupiterInlineStackAllocator.inl"
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "JupiterAllocatorExceptions.h"
+
+#include <new>
+
+namespace Jupiter {
+
+	template<size_t N, size_t Align>
+	void* InlineStackAllocator<N, Align>::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p != nullptr) return p;
+
+		if (m_Parent == nullptr) {
+			throw std::bad_alloc();
+		}
+		p = m_Parent->allocate(size, allignment);
+		m_Overflows++;
+		return p;
+	}
+
+	template<size_t N, size_t Align>
+	void* InlineStackAllocator<N, Align>::tryAllocate(size_t size, size_t allignment) noexcept {
+		if (HeaderSize > N - m_Top) {
+			return nullptr;
+		}
+
+		// Calculate the adjustment based on the top of the stack after the header, the header is aligned by aligning the block
+		if (allignment < alignof(block_header)) allignment = alignof(block_header);
+		size_t adjustment = pointer_functions::calc_forward_alignment_adjustment(m_Buffer + m_Top + HeaderSize, allignment);
+		// A block of size zero has to start inside of the buffer as well, or it would not be owned by the allocator
+		size_t start = m_Top + HeaderSize + adjustment;
+		if (start >= N || size > N - start) {
+			return nullptr;
+		}
+
+		*headerOf(start) = { (offset_type)m_Top, (offset_type)(m_Last == NoBlock ? 0 : m_Last) };
+		m_Last = start;
+		m_Top = start + size;
+		m_Allocations++;
+		return m_Buffer + start;
+	}
+
+	template<size_t N, size_t Align>
+	void InlineStackAllocator<N, Align>::deallocate(void* p) {
+		if (p == nullptr) return;
+
+		if (!owns(p)) {
+			if (m_Parent == nullptr) {
+				throw jpt_bad_free("Inline stack allocator cannot deallocate a block it does not own!");
+			}
+			m_Parent->deallocate(p);
+			return;
+		}
+
+		size_t offset = static_cast<uint8*>(p) - m_Buffer;
+		if (offset < HeaderSize || offset > m_Top || (headerOf(offset)->previousTop & FreedFlag) != 0) {
+			throw jpt_bad_free("Inline stack allocator cannot deallocate a block that is free!");
+		}
+		block_header* header = headerOf(offset);
+		m_Allocations--;
+
+		// A block that is not the most recent is only marked, it is popped together with the blocks above it
+		if (offset != m_Last) {
+			header->previousTop |= FreedFlag;
+			return;
+		}
+
+		while (true) {
+			m_Top = header->previousTop & ~FreedFlag;
+			if (header->previousBlock == 0) {
+				m_Last = NoBlock;
+				return;
+			}
+			m_Last = header->previousBlock;
+			header = headerOf(m_Last);
+			if ((header->previousTop & FreedFlag) == 0) return;
+		}
+	}
+
+	template<size_t N, size_t Align>
+	void InlineStackAllocator<N, Align>::deallocate(void* p, size_t size) {
+		deallocate(p);
+	}
+
+	template<size_t N, size_t Align>
+	bool InlineStackAllocator<N, Align>::tryResize(void* p, size_t newSize) {
+		if (p == nullptr) return false;
+		if (!owns(p)) return m_Parent != nullptr && m_Parent->tryResize(p, newSize);
+
+		// Only the most recent block ends at the top of the stack
+		size_t offset = static_cast<uint8*>(p) - m_Buffer;
+		if (offset != m_Last || newSize > N - offset) return false;
+
+		m_Top = offset + newSize;
+		return true;
+	}
+
+	template<size_t N, size_t Align>
+	bool InlineStackAllocator<N, Align>::owns(const void* p) const {
+		uintptr_t address = reinterpret_cast<uintptr_t>(p);
+		uintptr_t start = reinterpret_cast<uintptr_t>(m_Buffer);
+		return address >= start && address < start + N;
+	}
+
+	template<size_t N, size_t Align>
+	typename InlineStackAllocator<N, Align>::block_header* InlineStackAllocator<N, Align>::headerOf(size_t offset) {
+		return reinterpret_cast<block_header*>(m_Buffer + offset - HeaderSize);
+	}
+
+	template<size_t N, size_t Align>
+	constexpr void InlineStackAllocator<N, Align>::clear() noexcept {
+		m_Top = 0;
+		m_Last = NoBlock;
+		m_Allocations = 0;
+	}
+}
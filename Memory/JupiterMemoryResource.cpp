@@ -0,0 +1,37 @@
+#include "JupiterMemoryResource.h"
+
+#include <new>
+
+namespace Jupiter {
+
+	JupiterMemoryResource::JupiterMemoryResource(IAllocator& allocator, EnumDeallocateRoute route) :
+		m_Allocator(allocator), m_Route(route)
+	{}
+
+	JupiterMemoryResource::JupiterMemoryResource(StackAllocator& allocator) :
+		m_Allocator(allocator), m_Route(EnumDeallocateRoute::Ignore)
+	{}
+
+	JupiterMemoryResource::JupiterMemoryResource(ConcurrentStackAllocator& allocator) :
+		m_Allocator(allocator), m_Route(EnumDeallocateRoute::Ignore)
+	{}
+
+	void* JupiterMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+		return m_Allocator.allocate(bytes, alignment);
+	}
+
+	void JupiterMemoryResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+		if (m_Route == EnumDeallocateRoute::Ignore) return;
+
+		if (m_Route == EnumDeallocateRoute::Sized) m_Allocator.deallocate(p, bytes);
+		else m_Allocator.deallocate(p);
+	}
+
+	bool JupiterMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		if (this == &other) return true;
+
+		// Memory allocated through one resource can be deallocated through another when both pass it on the same way
+		const JupiterMemoryResource* resource = dynamic_cast<const JupiterMemoryResource*>(&other);
+		return resource != nullptr && &resource->m_Allocator == &m_Allocator && resource->m_Route == m_Route;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <memory_resource>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// The way a memory resource passes deallocations on to the allocator it wraps
+	/// </summary>
+	enum class EnumDeallocateRoute {
+		Sized = 0,		// Calls deallocate(p, size), the size of the block is known to the container
+		Unsized = 1,	// Calls deallocate(p), for allocators that keep track of the size of their blocks themselves
+		Ignore = 2		// Deallocations are dropped, for allocators that only release memory all at once eg. StackAllocator
+	};
+
+	/// <summary>
+	/// Memory resource that passes the allocations of pmr containers on to an IAllocator, so any container using a
+	/// std::pmr::polymorphic_allocator can be backed by a stack, pool or block allocator without changing the container.
+	/// Every alignment is passed on to the allocator as is.
+	/// </summary>
+	class JupiterMemoryResource : public std::pmr::memory_resource {
+
+	public:
+		JupiterMemoryResource() = delete;
+
+		/// <summary>
+		/// Creates a memory resource on top of an allocator, the allocator needs to outlive the memory resource
+		/// </summary>
+		/// <param name="allocator">The allocator all allocations are passed on to</param>
+		/// <param name="route">The way deallocations are passed on to the allocator</param>
+		JupiterMemoryResource(IAllocator& allocator, EnumDeallocateRoute route = EnumDeallocateRoute::Sized);
+
+		/// <summary>
+		/// Creates a memory resource on top of a stack allocator, deallocations are ignored (monotonic)
+		/// The memory is released by clearing the stack allocator once the containers using it are destroyed
+		/// </summary>
+		/// <param name="allocator">The stack allocator all allocations are passed on to</param>
+		JupiterMemoryResource(StackAllocator& allocator);
+
+		/// <summary>
+		/// Creates a memory resource on top of a concurrent stack allocator, deallocations are ignored (monotonic)
+		/// </summary>
+		/// <param name="allocator">The concurrent stack allocator all allocations are passed on to</param>
+		JupiterMemoryResource(ConcurrentStackAllocator& allocator);
+
+		JupiterMemoryResource(const JupiterMemoryResource&) = delete;				// Delete copy constructor, containers hold a pointer to the resource
+		JupiterMemoryResource& operator=(const JupiterMemoryResource&) = delete;	// Delete copy assignment operator
+
+		virtual ~JupiterMemoryResource() override = default;
+
+		inline IAllocator& getAllocator() const { return m_Allocator; }			// The allocator all allocations are passed on to
+		inline EnumDeallocateRoute getRoute() const { return m_Route; }			// The way deallocations are passed on to the allocator
+
+	protected:
+		virtual void* do_allocate(size_t bytes, size_t alignment) override;
+		virtual void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;	// Equal when both wrap the same allocator
+
+	private:
+		IAllocator& m_Allocator;			// The allocator all allocations are passed on to
+		EnumDeallocateRoute m_Route;		// The way deallocations are passed on to the allocator
+	};
+}
@@ -0,0 +1,252 @@
+#include "JupiterRingAllocator.h"
+
+#include "JupiterAllocatorExceptions.h"
+#include "JupiterVirtualMemory.h"
+
+#include <bit>
+#include <new>
+
+namespace Jupiter {
+
+	namespace {
+
+		/// <summary>
+		/// Header in front of every record, the header of a skip record has a size of zero and no live flag
+		/// </summary>
+		struct record_header {
+			uint32 length;				// The bytes from this header to the next one, a multiple of 8 with the live flag in the lowest bit
+			uint32 size;				// The size the record was allocated with
+		};
+
+		static_assert(sizeof(record_header) == RingAllocator::HeaderSize, "The record header does not match HeaderSize!");
+
+		constexpr uint32 live_flag = 1;			// Set while the record is not freed
+
+		inline size_t align_up(size_t value, size_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		inline record_header* header_at(uint8* start, size_t capacity, uint64 position) {
+			return reinterpret_cast<record_header*>(start + (position & (capacity - 1)));
+		}
+
+		inline size_t ring_capacity(size_t capacity) {
+			if (capacity > RingAllocator::MaxCapacity) throw std::bad_alloc();
+			size_t pageSize = virtual_memory::page_size();
+			return capacity <= pageSize ? pageSize : std::bit_ceil(capacity);
+		}
+
+		/// <summary>
+		/// Writes a record and the skip records in front of it at the head, without moving the head
+		/// </summary>
+		/// <returns>The payload of the record, nullptr when there is not enough room between the head and the tail</returns>
+		void* place_record(uint8* start, size_t capacity, uint64 head, uint64 tail, size_t size, size_t allignment, uint64& newHead) {
+			if (allignment < RingAllocator::RecordAlignment) allignment = RingAllocator::RecordAlignment;
+			if (size > capacity || allignment > capacity) return nullptr;
+
+			size_t length = RingAllocator::HeaderSize + align_up(size, RingAllocator::RecordAlignment);
+			size_t offset = (size_t)(head & (capacity - 1));
+			size_t start_offset = offset;
+			size_t payload = align_up(offset + RingAllocator::HeaderSize, allignment);
+
+			// Records never wrap, a record that does not fit before the end of the ring starts over at the start.
+			// The payload has to lie inside of the ring as well, a record of size zero can end right at the end of the ring
+			size_t wrap = 0;
+			if (payload >= capacity || payload - RingAllocator::HeaderSize + length > capacity) {
+				wrap = capacity - offset;
+				offset = 0;
+				payload = align_up(RingAllocator::HeaderSize, allignment);
+				if (payload >= capacity || payload - RingAllocator::HeaderSize + length > capacity) return nullptr;
+			}
+
+			size_t total = wrap + payload - RingAllocator::HeaderSize + length - offset;
+			if (total > capacity - (size_t)(head - tail)) return nullptr;
+
+			if (wrap != 0) *reinterpret_cast<record_header*>(start + start_offset) = { (uint32)wrap, 0 };
+			size_t gap = payload - RingAllocator::HeaderSize - offset;
+			if (gap != 0) *reinterpret_cast<record_header*>(start + offset) = { (uint32)gap, 0 };
+			*reinterpret_cast<record_header*>(start + payload - RingAllocator::HeaderSize) = { (uint32)length | live_flag, (uint32)size };
+
+			newHead = head + total;
+			return start + payload;
+		}
+
+		/// <summary>
+		/// Moves the tail past every freed record and skip record, up to the limit
+		/// </summary>
+		uint64 advance_tail(uint8* start, size_t capacity, uint64 tail, uint64 limit) {
+			while (tail != limit) {
+				record_header* header = header_at(start, capacity, tail);
+				if ((header->length & live_flag) != 0) break;
+				tail += header->length;
+			}
+			return tail;
+		}
+
+		/// <summary>
+		/// Clears the live flag of a record, throws jpt_bad_free when the address is not the payload of a live record
+		/// </summary>
+		record_header* free_record(uint8* start, size_t capacity, void* p, const char* message) {
+			uint8* payload = reinterpret_cast<uint8*>(p);
+			if (payload < start + RingAllocator::HeaderSize || payload >= start + capacity || ((uintptr_t)payload & (RingAllocator::RecordAlignment - 1)) != 0) {
+				throw jpt_bad_free(message);
+			}
+			record_header* header = reinterpret_cast<record_header*>(payload - RingAllocator::HeaderSize);
+			if ((header->length & live_flag) == 0) throw jpt_bad_free(message);
+
+			header->length &= ~live_flag;
+			return header;
+		}
+	}
+
+	// ----- RingAllocator Start -----
+
+	RingAllocator::RingAllocator(size_t capacity) :
+		m_Start(nullptr), m_Capacity(ring_capacity(capacity)), m_Head(0), m_Tail(0), m_Allocations(0)
+	{
+		m_Start = reinterpret_cast<uint8*>(virtual_memory::allocate_aligned(m_Capacity, virtual_memory::page_size()));
+		if (m_Start == nullptr) throw std::bad_alloc();
+	}
+
+	RingAllocator::~RingAllocator() {
+		if (m_Allocations != 0) {
+			allocator_stats::reportLeak("RingAllocator", m_Allocations, getUsedMemory());
+		}
+		virtual_memory::release(m_Start, m_Capacity);
+	}
+
+	void* RingAllocator::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	void* RingAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
+		uint64 head;
+		void* p = place_record(m_Start, m_Capacity, m_Head, m_Tail, size, allignment, head);
+		if (p == nullptr) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+
+		m_Stats.recordAllocation(size, HeaderSize + align_up(size, RecordAlignment));
+		m_Head = head;
+		m_Allocations++;
+		return p;
+	}
+
+	void RingAllocator::deallocate(void* p) {
+		record_header* header = free_record(m_Start, m_Capacity, p, "Ring allocator cannot deallocate a block that is free or was not allocated by it!");
+		m_Stats.recordDeallocation(header->length);
+		m_Allocations--;
+		m_Tail = advance_tail(m_Start, m_Capacity, m_Tail, m_Head);
+	}
+
+	void RingAllocator::deallocate(void* p, size_t size) {
+		deallocate(p);
+	}
+
+	bool RingAllocator::owns(void* p) const {
+		return p >= m_Start && p < m_Start + m_Capacity;
+	}
+
+	void RingAllocator::clear() {
+		m_Stats.recordRewind(0, 0);
+		m_Head = 0;
+		m_Tail = 0;
+		m_Allocations = 0;
+	}
+
+	// ----- RingAllocator End -----
+
+	// ----- SpscRingAllocator Start -----
+
+	SpscRingAllocator::SpscRingAllocator(size_t capacity) :
+		m_Start(nullptr), m_Capacity(ring_capacity(capacity)),
+		m_Head(0), m_Write(0), m_CachedTail(0),
+		m_Tail(0), m_Read(0), m_CachedHead(0)
+	{
+		m_Start = reinterpret_cast<uint8*>(virtual_memory::allocate_aligned(m_Capacity, virtual_memory::page_size()));
+		if (m_Start == nullptr) throw std::bad_alloc();
+	}
+
+	SpscRingAllocator::~SpscRingAllocator() {
+		// Both threads are done once the ring is destroyed, so every record between the tail and the write position can be walked
+		size_t allocations = 0;
+		uint64 tail = m_Tail.load(std::memory_order_acquire);
+		for (uint64 position = tail; position != m_Write;) {
+			record_header* header = header_at(m_Start, m_Capacity, position);
+			if ((header->length & live_flag) != 0) allocations++;
+			position += header->length & ~live_flag;
+		}
+		if (allocations != 0) {
+			allocator_stats::reportLeak("SpscRingAllocator", allocations, (size_t)(m_Write - tail));
+		}
+		virtual_memory::release(m_Start, m_Capacity);
+	}
+
+	void* SpscRingAllocator::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	void* SpscRingAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
+		uint64 head;
+		void* p = place_record(m_Start, m_Capacity, m_Write, m_CachedTail, size, allignment, head);
+		if (p == nullptr) {
+			// The copy of the tail may be old, the consumer could have freed records since
+			m_CachedTail = m_Tail.load(std::memory_order_acquire);
+			p = place_record(m_Start, m_Capacity, m_Write, m_CachedTail, size, allignment, head);
+			if (p == nullptr) return nullptr;
+		}
+
+		m_Write = head;
+		return p;
+	}
+
+	void SpscRingAllocator::publish() {
+		m_Head.store(m_Write, std::memory_order_release);
+	}
+
+	void* SpscRingAllocator::receive(size_t& size) noexcept {
+		while (true) {
+			if (m_Read == m_CachedHead) {
+				m_CachedHead = m_Head.load(std::memory_order_acquire);
+				if (m_Read == m_CachedHead) return nullptr;
+			}
+
+			// Skip records are passed over, the tail moves past them once the records before them are freed
+			record_header* header = header_at(m_Start, m_Capacity, m_Read);
+			uint64 position = m_Read;
+			m_Read += header->length & ~live_flag;
+			if ((header->length & live_flag) != 0) {
+				size = header->size;
+				return pointer_functions::shift_forward(m_Start, (size_t)(position & (m_Capacity - 1)) + RingAllocator::HeaderSize);
+			}
+		}
+	}
+
+	void SpscRingAllocator::deallocate(void* p) {
+		free_record(m_Start, m_Capacity, p, "Spsc ring allocator cannot deallocate a block that is free or was not allocated by it!");
+
+		// Only received records are freed, so the tail never passes the read position
+		uint64 tail = m_Tail.load(std::memory_order_relaxed);
+		uint64 newTail = advance_tail(m_Start, m_Capacity, tail, m_Read);
+		if (newTail != tail) m_Tail.store(newTail, std::memory_order_release);
+	}
+
+	void SpscRingAllocator::deallocate(void* p, size_t size) {
+		deallocate(p);
+	}
+
+	bool SpscRingAllocator::owns(void* p) const {
+		return p >= m_Start && p < m_Start + m_Capacity;
+	}
+
+	// ----- SpscRingAllocator End -----
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <atomic>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Allocator for records freed in about the order they were allocated, eg. the messages of a streaming pipeline.
+	/// Records are allocated at the head of a ring buffer and the memory is reclaimed from the tail.
+	///
+	/// Every record is contiguous, it never wraps around the end of the ring. A record that does not fit before the end
+	/// starts over at the start of the ring, the rest of the ring is turned into a skip record. The gap in front of a record
+	/// with a larger alignment is a skip record as well, so the tail always finds the next record at the end of the previous one.
+	/// Freeing a record that is not the oldest only marks it, its memory is reclaimed once every record before it is freed.
+	/// </summary>
+	class RingAllocator final : public IAllocator {
+
+	public:
+		static constexpr size_t RecordAlignment = 8;				// The alignment of every record, and the least alignment of a block
+		static constexpr size_t HeaderSize = 8;						// The size of the header in front of every record
+		static constexpr size_t MaxCapacity = (size_t)1 << 31;		// The largest ring, the length of a record is kept in 32 bits
+
+	public:
+		RingAllocator() = delete;
+
+		/// <summary>
+		/// Creates a ring allocator, the memory is allocated and committed on instantiation
+		/// Throws std::bad_alloc when the capacity is larger then MaxCapacity or the memory could not be allocated
+		/// </summary>
+		/// <param name="capacity">The size of the ring in bytes, rounded up to a power of two of at least a page</param>
+		RingAllocator(size_t capacity);
+
+		RingAllocator(const RingAllocator&) = delete;					// Delete copy constructor, the allocator owns its memory block
+		RingAllocator& operator=(const RingAllocator&) = delete;		// Delete copy assignment operator
+
+		virtual ~RingAllocator() override;										// Override virtual destructor
+		virtual void* allocate(size_t size, size_t allignment = 8) override;		// Allocates a record at the head, throws std::bad_alloc when the ring is full
+		virtual void deallocate(void* p) override;								// Frees a record, the tail moves past every freed record at the tail
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate(p), the record knows its size
+
+		void* tryAllocate(size_t size, size_t allignment = 8) noexcept;			// Same as allocate, but returns nullptr when the ring is full
+		bool owns(void* p) const;												// Checks if the address lies inside of the ring
+		void clear();															// Frees every record at once
+
+		virtual const AllocatorStats* getStats() const override { return &m_Stats; }		// The statistics of the allocator
+		virtual void resetStats() override { m_Stats.reset(); }								// Resets the statistics, including the peaks
+
+		inline size_t getCapacity() const { return m_Capacity; }							// The size of the ring in bytes
+		inline size_t getUsedMemory() const { return (size_t)(m_Head - m_Tail); }			// The bytes from the tail to the head, including freed records not yet reclaimed
+		inline size_t getAllocations() const { return m_Allocations; }					// The amount of records that are not freed
+
+	private:
+		uint8* m_Start;					// The start of the ring
+		size_t m_Capacity;				// The size of the ring, a power of two
+
+		uint64 m_Head;					// The position the next record is allocated at, only ever increases, the offset in the ring is the position modulo the capacity
+		uint64 m_Tail;					// The position of the oldest record that is not reclaimed
+		size_t m_Allocations;			// The amount of records that are not freed
+
+		[[no_unique_address]] AllocatorStats m_Stats;		// The statistics of the allocator, empty when compiled out
+	};
+
+	/// <summary>
+	/// Variant of the RingAllocator shared by a single producer thread and a single consumer thread, eg. a log or network thread
+	/// receiving messages from a game thread. The threads exchange records without locks and without touching the heap.
+	///
+	/// The producer allocates records and fills them, publish makes every record allocated so far visible to the consumer.
+	/// The consumer receives the records in the order they were allocated and frees them when it is done with them.
+	/// The head and the tail are the only shared state, each is written by one thread and read by the other.
+	/// Both threads keep a copy of the position the other thread wrote last, so they only read the other cache line when they run out.
+	/// </summary>
+	class SpscRingAllocator final : public IAllocator {
+
+	public:
+		SpscRingAllocator() = delete;
+
+		/// <summary>
+		/// Creates a single producer single consumer ring allocator, the memory is allocated and committed on instantiation
+		/// Throws std::bad_alloc when the capacity is larger then RingAllocator::MaxCapacity or the memory could not be allocated
+		/// </summary>
+		/// <param name="capacity">The size of the ring in bytes, rounded up to a power of two of at least a page</param>
+		SpscRingAllocator(size_t capacity);
+
+		SpscRingAllocator(const SpscRingAllocator&) = delete;				// Delete copy constructor, the allocator owns its memory block
+		SpscRingAllocator& operator=(const SpscRingAllocator&) = delete;	// Delete copy assignment operator
+
+		virtual ~SpscRingAllocator() override;									// Override virtual destructor
+		virtual void* allocate(size_t size, size_t allignment = 8) override;		// Producer only, throws std::bad_alloc when the ring is full
+		virtual void deallocate(void* p) override;								// Consumer only, frees a received record
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate(p), the record knows its size
+
+		void* tryAllocate(size_t size, size_t allignment = 8) noexcept;			// Producer only, same as allocate but returns nullptr when the ring is full
+		void publish();															// Producer only, makes every allocated record visible to the consumer
+
+		/// <summary>
+		/// Consumer only, takes the oldest published record that was not received yet
+		/// </summary>
+		/// <param name="size">Receives the size the record was allocated with</param>
+		/// <returns>The record, nullptr when there is no published record</returns>
+		void* receive(size_t& size) noexcept;
+
+		bool owns(void* p) const;												// Checks if the address lies inside of the ring
+		inline size_t getCapacity() const { return m_Capacity; }				// The size of the ring in bytes
+
+	private:
+		uint8* m_Start;					// The start of the ring
+		size_t m_Capacity;				// The size of the ring, a power of two
+
+		// The producer writes the head and keeps its own position and its copy of the tail next to it
+		alignas(CacheLineSize) std::atomic<uint64> m_Head;		// The position after the last published record
+		uint64 m_Write;											// The position the next record is allocated at
+		uint64 m_CachedTail;									// The tail the producer read last
+
+		// The consumer writes the tail and keeps its own position and its copy of the head next to it
+		alignas(CacheLineSize) std::atomic<uint64> m_Tail;		// The position of the oldest record that is not reclaimed
+		uint64 m_Read;											// The position of the next record to receive
+		uint64 m_CachedHead;									// The head the consumer read last
+	};
+}
@@ -0,0 +1,22 @@
+#include "JupiterScratchArena.h"
+
+namespace Jupiter {
+
+	StackAllocator& scratch_arena::get() {
+		// Committed memory is kept when a scope ends, so a loop opening the same scope does not commit and decommit every iteration
+		static thread_local StackAllocator t_Arena(ReservedSize, EnumStackBacking::Virtual);
+		return t_Arena;
+	}
+
+	ScratchScope::ScratchScope() :
+		ScratchScope(scratch_arena::get())
+	{}
+
+	ScratchScope::ScratchScope(StackAllocator& arena) :
+		m_Arena(arena), m_State(arena.getState())
+	{}
+
+	ScratchScope::~ScratchScope() {
+		m_Arena.restore(m_State);
+	}
+}
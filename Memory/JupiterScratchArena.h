@@ -0,0 +1,54 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Namespace containing the per thread scratch arena, a stack for temporary buffers that never touches the heap.
+	/// Every thread lazily gets its own virtual backed stack, only the memory the deepest scope reached is committed.
+	/// Memory is only ever handed out through a ScratchScope, so everything allocated in a scope is freed when it ends
+	/// </summary>
+	namespace scratch_arena {
+
+		constexpr size_t ReservedSize = (size_t)256 * 1024 * 1024;		// The address range reserved for the arena of every thread
+
+		/// <summary>
+		/// Gets the scratch arena of the calling thread, it is created on the first call of the thread
+		/// Hot functions should take the arena as a parameter instead of calling this again
+		/// </summary>
+		StackAllocator& get();
+	}
+
+	/// <summary>
+	/// RAII guard for temporary allocations on a stack allocator, eg. the scratch arena of the thread.
+	/// Snapshots the top of the stack on construction and restores it on destruction, freeing everything allocated in the scope.
+	/// The snapshot lives in the scope itself, not on the stack, so a scope leaves no gap in the arena.
+	///
+	/// Scopes can be nested, as long as they end in the reverse order they started, which C++ scoping already guarantees.
+	/// A block allocated in an outer scope while an inner scope is open is freed when the inner scope ends.
+	/// </summary>
+	class ScratchScope {
+
+	public:
+		ScratchScope();								// Opens a scope on the scratch arena of the calling thread
+		explicit ScratchScope(StackAllocator& arena);	// Opens a scope on the given arena, eg. one passed through a hot function
+
+		ScratchScope(const ScratchScope&) = delete;				// Delete copy constructor, the scope restores the arena exactly once
+		ScratchScope& operator=(const ScratchScope&) = delete;	// Delete copy assignment operator
+
+		~ScratchScope();							// Frees everything allocated since the scope was opened
+
+		/// <summary>
+		/// Allocates a temporary block that lives until the end of the scope
+		/// Throws std::bad_alloc when the arena is full
+		/// </summary>
+		inline void* allocate(size_t size, size_t allignment = 4) { return m_Arena.allocate(size, allignment); }
+
+		inline StackAllocator& getArena() { return m_Arena; }		// The arena of the scope, to pass to nested functions
+
+	private:
+		StackAllocator& m_Arena;					// The arena the scope allocates from
+		StackAllocator::stack_state m_State;		// The top of the arena when the scope was opened
+	};
+}
@@ -0,0 +1,213 @@
+#include "JupiterSlabAllocator.h"
+
+#include "JupiterAllocatorExceptions.h"
+#include "JupiterVirtualMemory.h"
+
+#include <algorithm>
+#include <new>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Header stored at the start of every slab, the slots start at the first cache line after it
+	/// </summary>
+	struct SlabAllocator::slab_header {
+		SlabAllocator* owner;			// The allocator the slab belongs to, used to validate deallocations
+		slab_header* prev;				// Previous slab with free slots of the same size class
+		slab_header* next;				// Next slab with free slots of the same size class
+		void* freeList;					// Head of the list of slots that have been deallocated
+		uint8* bump;					// Next slot that has never been handed out
+		uint32 used;					// The amount of slots currently handed out
+		uint32 capacity;				// The amount of slots in the slab
+		uint32 sizeClass;				// The size class of every slot in the slab
+		uint32 slotSize;				// The size of every slot in the slab
+	};
+
+	namespace {
+
+		static_assert(sizeof(SlabAllocator::slab_header) <= SlabAllocator::SlabAlignment, "The slab header needs to fit in front of the first slot!");
+
+		// Slot size of every size class
+		constexpr uint32 size_class_sizes[SlabAllocator::SizeClassCount] = {
+			8, 16, 24, 32,
+			48, 64, 80, 96, 112, 128,
+			160, 192, 224, 256,
+			320, 384, 448, 512
+		};
+
+		// Size class of every size rounded up to a multiple of 8, indexed by (size + 7) / 8
+		struct size_class_table {
+			uint8 index[SlabAllocator::MaxSize / 8 + 1];
+
+			constexpr size_class_table() : index{} {
+				uint32 sizeClass = 0;
+				for (uint32 i = 0; i <= SlabAllocator::MaxSize / 8; i++) {
+					while (size_class_sizes[sizeClass] < i * 8) sizeClass++;
+					index[i] = (uint8)sizeClass;
+				}
+			}
+		};
+
+		constexpr size_class_table size_classes;
+
+		inline SlabAllocator::slab_header* slab_of(void* p) {
+			return reinterpret_cast<SlabAllocator::slab_header*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(SlabAllocator::SlabSize - 1));
+		}
+	}
+
+	SlabAllocator::SlabAllocator() :
+		m_Partial{}, m_UsedMemory(0), m_Allocations(0)
+	{}
+
+	SlabAllocator::~SlabAllocator() {
+		if (m_Allocations != 0) {
+			allocator_stats::reportLeak("SlabAllocator", m_Allocations, m_UsedMemory);
+		}
+		for (slab_header* slab : m_Slabs) virtual_memory::release(slab, SlabSize);
+	}
+
+	void* SlabAllocator::allocate(size_t size, size_t allignment) {
+		void* p = tryAllocate(size, allignment);
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+
+	void* SlabAllocator::tryAllocate(size_t size, size_t allignment) noexcept {
+		if (size > MaxSize || allignment > SlabAlignment) {
+			m_Stats.recordFailure();
+			return nullptr;
+		}
+
+		// Slots are aligned to the largest power of two dividing the slot size, move up a size class until the alignment fits
+		uint32 sizeClass = sizeClassIndex(size);
+		if (allignment > 1) {
+			while (sizeClass < SizeClassCount && (size_class_sizes[sizeClass] & (allignment - 1)) != 0) sizeClass++;
+			if (sizeClass == SizeClassCount) {
+				m_Stats.recordFailure();
+				return nullptr;
+			}
+		}
+
+		slab_header* slab = m_Partial[sizeClass];
+		if (slab == nullptr) {
+			slab = createSlab(sizeClass);
+			if (slab == nullptr) {
+				m_Stats.recordFailure();
+				return nullptr;
+			}
+		}
+
+		// Reuse a previously deallocated slot first, then take one from the untouched part of the slab
+		void* slot;
+		if (slab->freeList != nullptr) {
+			slot = slab->freeList;
+			slab->freeList = *reinterpret_cast<void**>(slot);
+		}
+		else {
+			slot = slab->bump;
+			slab->bump += slab->slotSize;
+		}
+
+		// A full slab has nothing left to hand out, take it out of the list until one of its slots is returned
+		if (++slab->used == slab->capacity) unlinkPartial(slab);
+
+		m_Allocations++;
+		m_UsedMemory += slab->slotSize;
+		m_Stats.recordAllocation(size, slab->slotSize);
+		return slot;
+	}
+
+	void SlabAllocator::deallocate(void* p) {
+		if (p == nullptr) return;
+
+		slab_header* slab = slab_of(p);
+		if (slab->owner != this) {
+			throw jpt_bad_free("Slab allocator cannot deallocate a block it does not own!");
+		}
+
+		*reinterpret_cast<void**>(p) = slab->freeList;
+		slab->freeList = p;
+		if (slab->used-- == slab->capacity) linkPartial(slab);
+
+		m_Allocations--;
+		m_UsedMemory -= slab->slotSize;
+		m_Stats.recordDeallocation(slab->slotSize);
+
+		// Return empty slabs to the system, but keep the last slab of a size class around
+		if (slab->used == 0 && (m_Partial[slab->sizeClass] != slab || slab->next != nullptr)) releaseSlab(slab);
+	}
+
+	void SlabAllocator::deallocate(void* p, size_t size) {
+		if (p == nullptr) return;
+
+		if (size > slab_of(p)->slotSize) {
+			throw jpt_bad_free("Slab allocator cannot deallocate a block larger than its slot size!");
+		}
+		deallocate(p);
+	}
+
+	bool SlabAllocator::owns(void* p) const {
+		slab_header* slab = slab_of(p);
+		return std::binary_search(m_Slabs.begin(), m_Slabs.end(), slab);
+	}
+
+	uint32 SlabAllocator::sizeClassIndex(size_t size) {
+		return size_classes.index[(size + 7) >> 3];
+	}
+
+	size_t SlabAllocator::sizeClassSize(uint32 sizeClass) {
+		return size_class_sizes[sizeClass];
+	}
+
+	SlabAllocator::slab_header* SlabAllocator::createSlab(uint32 sizeClass) {
+		void* data = virtual_memory::allocate_aligned(SlabSize, SlabSize);
+		if (data == nullptr) return nullptr;
+
+		// Keep the slabs sorted by address, the allocation is already expensive enough that the insert does not matter
+		try {
+			m_Slabs.insert(std::upper_bound(m_Slabs.begin(), m_Slabs.end(), reinterpret_cast<slab_header*>(data)), reinterpret_cast<slab_header*>(data));
+		}
+		catch (std::bad_alloc&) {
+			virtual_memory::release(data, SlabSize);
+			return nullptr;
+		}
+
+		slab_header* slab = reinterpret_cast<slab_header*>(data);
+		slab->owner = this;
+		slab->prev = nullptr;
+		slab->next = nullptr;
+		slab->freeList = nullptr;
+		slab->sizeClass = sizeClass;
+		slab->slotSize = size_class_sizes[sizeClass];
+		slab->capacity = (uint32)((SlabSize - SlabAlignment) / slab->slotSize);
+		slab->used = 0;
+		slab->bump = reinterpret_cast<uint8*>(data) + SlabAlignment;
+
+		linkPartial(slab);
+		return slab;
+	}
+
+	void SlabAllocator::releaseSlab(slab_header* slab) {
+		unlinkPartial(slab);
+		m_Slabs.erase(std::lower_bound(m_Slabs.begin(), m_Slabs.end(), slab));
+		virtual_memory::release(slab, SlabSize);
+	}
+
+	void SlabAllocator::linkPartial(slab_header* slab) {
+		slab_header*& head = m_Partial[slab->sizeClass];
+		slab->prev = nullptr;
+		slab->next = head;
+		if (head != nullptr) head->prev = slab;
+		head = slab;
+	}
+
+	void SlabAllocator::unlinkPartial(slab_header* slab) {
+		if (slab->prev != nullptr) slab->prev->next = slab->next;
+		else m_Partial[slab->sizeClass] = slab->next;
+		if (slab->next != nullptr) slab->next->prev = slab->prev;
+		slab->prev = nullptr;
+		slab->next = nullptr;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <vector>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Allocator for many small allocations of different sizes, eg. strings, nodes and callbacks.
+	/// Every size is rounded up to one of a fixed set of size classes between 8 and 512 bytes. Memory is taken from the
+	/// system in slabs of SlabSize bytes aligned to SlabSize, every slab is carved into equal slots of a single size class.
+	/// The slab header sits at the start of the slab, so the slab of any block is found by masking its address.
+	///
+	/// Every slab keeps its own intrusive free list and bump pointer, slabs with free slots are linked per size class.
+	/// A slab that becomes empty is returned to the system, except for the last one of its size class which is kept
+	/// to avoid mapping and unmapping a slab when a single block is allocated and freed repeatedly.
+	/// </summary>
+	class SlabAllocator final : public IAllocator {
+
+	public:
+		struct slab_header;				// Header at the start of every slab, defined in JupiterSlabAllocator.cpp
+
+		static constexpr size_t SlabSize = 64 * 1024;			// Size and alignment of every slab
+		static constexpr size_t MinSize = 8;					// Size of the smallest size class
+		static constexpr size_t MaxSize = 512;					// Size of the largest size class, larger allocations are not served
+		static constexpr uint32 SizeClassCount = 18;			// 8 byte steps up to 32, 16 up to 128, 32 up to 256 and 64 up to 512
+		static constexpr size_t SlabAlignment = CacheLineSize;	// Alignment of the first slot in a slab
+
+	public:
+		SlabAllocator();
+
+		SlabAllocator(const SlabAllocator&) = delete;				// Delete copy constructor, the allocator owns its slabs
+		SlabAllocator& operator=(const SlabAllocator&) = delete;	// Delete copy assignment operator
+
+		virtual ~SlabAllocator() override;										// Override virtual destructor, releases all slabs
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Allocates a slot from a slab of the matching size class
+		virtual void deallocate(void* p) override;								// Returns the slot to its slab
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate(p), validates the size against the slot size
+
+		void* tryAllocate(size_t size, size_t allignment = 4) noexcept;			// Same as allocate, but returns nullptr when the size is not served
+		bool owns(void* p) const;												// Checks if the address lies inside of one of the slabs
+
+		virtual const AllocatorStats* getStats() const override { return &m_Stats; }		// The statistics of the allocator
+		virtual void resetStats() override { m_Stats.reset(); }								// Resets the statistics, including the peaks
+
+		/// <summary>
+		/// Gets the size class index for an allocation size
+		/// </summary>
+		/// <param name="size">The size of the allocation, needs to be smaller or equal to MaxSize</param>
+		/// <returns>The index of the smallest size class that fits the size</returns>
+		static uint32 sizeClassIndex(size_t size);
+
+		/// <summary>
+		/// Gets the size of the slots in a size class
+		/// </summary>
+		/// <param name="sizeClass">The index of the size class</param>
+		static size_t sizeClassSize(uint32 sizeClass);
+
+		inline size_t getUsedMemory() const { return m_UsedMemory; }					// The amount of bytes in slots that are currently handed out
+		inline size_t getAllocations() const { return m_Allocations; }					// The amount of slots currently handed out
+		inline size_t getSlabCount() const { return m_Slabs.size(); }					// The amount of slabs taken from the system
+		inline size_t getReservedMemory() const { return m_Slabs.size() * SlabSize; }	// The amount of bytes in all slabs
+
+	private:
+		slab_header* createSlab(uint32 sizeClass);			// Takes a new slab from the system and links it to its size class
+		void releaseSlab(slab_header* slab);				// Unlinks a slab and returns it to the system
+		void linkPartial(slab_header* slab);				// Adds a slab to the list of slabs with free slots of its size class
+		void unlinkPartial(slab_header* slab);				// Removes a slab from the list of slabs with free slots of its size class
+
+	private:
+		slab_header* m_Partial[SizeClassCount];		// Per size class, the slabs with at least one free slot
+		std::vector<slab_header*> m_Slabs;			// Every slab, sorted by address so ownership is a binary search
+
+		size_t m_UsedMemory;			// The total memory used by this allocator
+		size_t m_Allocations;			// The total number of allocations this allocator has made
+
+		[[no_unique_address]] AllocatorStats m_Stats;		// The statistics of the allocator, empty when compiled out
+	};
+}
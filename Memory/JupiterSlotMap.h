@@ -0,0 +1,126 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <utility>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Handle to an object in a SlotMap, an index into the slots of the map and the generation of the slot it was made for.
+	/// The generation of a slot changes every time its object is erased, so a handle outliving its object no longer matches.
+	/// A default constructed handle never matches any object
+	/// </summary>
+	struct slot_handle {
+		uint32 index = 0;				// The slot of the object
+		uint32 generation = 0;			// The generation of the slot when the object was inserted, always odd
+
+		inline bool operator==(const slot_handle& other) const { return index == other.index && generation == other.generation; }
+		inline bool operator!=(const slot_handle& other) const { return !(*this == other); }
+	};
+
+	/// <summary>
+	/// Container storing objects densely in a single array, addressed by generational handles, eg. entity and resource tables.
+	/// Iterating the objects is a linear walk over contiguous memory, no pointer is followed.
+	///
+	/// Every handle refers to a slot, the slot holds the index of the object in the dense array and a generation.
+	/// The generation is odd while the slot holds an object and even while it is free, it is incremented on every insert and erase.
+	/// Erasing moves the last object into the hole, so the dense array never has gaps, and pushes the slot on a free list.
+	/// Insert, erase and lookup are O(1). A stale handle is detected by the generation check, without any control block per object.
+	///
+	/// The objects, the slot of every object and the slots are kept in a single block of the allocator, which doubles when full.
+	/// Erasing and growing move objects, so pointers to objects are only valid until the next insert or erase.
+	/// </summary>
+	/// <typeparam name="T">The type of the stored objects, should have a noexcept move constructor</typeparam>
+	template<typename T>
+	class SlotMap {
+
+		/// <summary>
+		/// The slot a handle refers to
+		/// </summary>
+		struct slot {
+			uint32 index;				// The index of the object in the dense array, or the next free slot when the slot is free
+			uint32 generation;			// Odd while the slot holds an object
+		};
+
+	public:
+		static constexpr uint32 EndOfList = 0xFFFFFFFF;		// Index marking the end of the free list, the capacity always stays below it
+
+	public:
+		SlotMap() = delete;
+
+		/// <summary>
+		/// Creates an empty slot map
+		/// </summary>
+		/// <param name="allocator">The allocator the storage is allocated from, needs to outlive the map</param>
+		/// <param name="capacity">The amount of objects the map has room for before it grows</param>
+		SlotMap(IAllocator& allocator, size_t capacity = 0);
+
+		SlotMap(const SlotMap&) = delete;					// Delete copy constructor, handles belong to a single map
+		SlotMap& operator=(const SlotMap&) = delete;		// Delete copy assignment operator
+
+		~SlotMap();											// Destroys all objects and returns the storage to the allocator
+
+		/// <summary>
+		/// Constructs an object at the end of the dense array
+		/// Throws std::bad_alloc when the map needs to grow and the allocator is out of memory
+		/// </summary>
+		/// <returns>The handle to the new object</returns>
+		template<typename ...Args>
+		slot_handle emplace(Args&&... args);
+
+		inline slot_handle insert(const T& object) { return emplace(object); }		// Copies an object into the map
+		inline slot_handle insert(T&& object) { return emplace(std::move(object)); }	// Moves an object into the map
+
+		/// <summary>
+		/// Destroys the object of a handle, the last object is moved into its place
+		/// </summary>
+		/// <returns>False when the handle is stale, the map is left untouched</returns>
+		bool erase(slot_handle handle);
+
+		void clear();										// Destroys all objects, every handle becomes stale
+		void reserve(size_t capacity);						// Grows the storage to hold at least the given amount of objects
+
+		/// <summary>
+		/// Gets the object of a handle
+		/// </summary>
+		/// <returns>The object, nullptr when the handle is stale</returns>
+		inline T* get(slot_handle handle);
+		inline const T* get(slot_handle handle) const;
+		inline bool contains(slot_handle handle) const;		// Checks if the handle refers to a live object
+
+		/// <summary>
+		/// Gets the handle of the object at an index of the dense array, eg. while iterating
+		/// </summary>
+		inline slot_handle handleAt(size_t index) const;
+
+		inline T* begin() { return m_Objects; }								// The first object of the dense array
+		inline T* end() { return m_Objects + m_Size; }						// One past the last object of the dense array
+		inline const T* begin() const { return m_Objects; }
+		inline const T* end() const { return m_Objects + m_Size; }
+		inline T* data() { return m_Objects; }								// The dense array
+		inline T& operator[](size_t index) { return m_Objects[index]; }		// The object at an index of the dense array
+
+		inline size_t size() const { return m_Size; }						// The amount of objects
+		inline bool empty() const { return m_Size == 0; }					// Checks if the map holds no objects
+		inline size_t capacity() const { return m_Capacity; }				// The amount of objects the map has room for
+		inline IAllocator& getAllocator() const { return m_Allocator; }		// The allocator of the storage
+
+	private:
+		static inline size_t storageSize(size_t capacity);					// The size of the block holding all three arrays
+		void grow(size_t capacity);											// Moves everything to a block with room for the given amount of objects
+
+	private:
+		IAllocator& m_Allocator;			// The allocator the storage is allocated from
+
+		T* m_Objects;						// The dense array of objects, the start of the storage block
+		uint32* m_ObjectSlots;				// The slot of every object in the dense array, used to fix up the slot of a moved object
+		slot* m_Slots;						// The slots handles refer to
+		uint32 m_Size;						// The amount of objects
+		uint32 m_Capacity;					// The amount of objects and slots the storage has room for
+		uint32 m_SlotCount;					// The amount of slots that have ever been used, the slots after it are untouched
+		uint32 m_FreeSlot;					// The first slot of the free list, EndOfList when the list is empty
+	};
+}
+
+#include "JupiterSlotMap.inl"
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstring>
+#include <new>
+
+namespace Jupiter {
+
+	template<typename T>
+	SlotMap<T>::SlotMap(IAllocator& allocator, size_t capacity) :
+		m_Allocator(allocator), m_Objects(nullptr), m_ObjectSlots(nullptr), m_Slots(nullptr),
+		m_Size(0), m_Capacity(0), m_SlotCount(0), m_FreeSlot(EndOfList)
+	{
+		if (capacity > 0) grow(capacity);
+	}
+
+	template<typename T>
+	SlotMap<T>::~SlotMap() {
+		clear();
+		if (m_Objects != nullptr) m_Allocator.deallocate(m_Objects, storageSize(m_Capacity));
+	}
+
+	template<typename T>
+	template<typename ...Args>
+	slot_handle SlotMap<T>::emplace(Args&&... args) {
+		// Every used slot holds an object while the free list is empty, so there is a free slot whenever there is room for the object
+		if (m_Size == m_Capacity) {
+			grow(m_Capacity < 16 ? 16 : (size_t)m_Capacity * 2);
+		}
+
+		new (m_Objects + m_Size) T(std::forward<Args>(args)...);
+
+		uint32 index;
+		if (m_FreeSlot != EndOfList) {
+			index = m_FreeSlot;
+			m_FreeSlot = m_Slots[index].index;
+		}
+		else {
+			index = m_SlotCount++;
+			m_Slots[index].generation = 0;
+		}
+
+		slot& s = m_Slots[index];
+		s.index = m_Size;
+		s.generation++;
+		m_ObjectSlots[m_Size] = index;
+		m_Size++;
+		return { index, s.generation };
+	}
+
+	template<typename T>
+	bool SlotMap<T>::erase(slot_handle handle) {
+		if (!contains(handle)) return false;
+
+		// Move the last object into the hole and point its slot at its new place
+		slot& s = m_Slots[handle.index];
+		uint32 last = m_Size - 1;
+		if (s.index != last) {
+			m_Objects[s.index] = std::move(m_Objects[last]);
+			m_ObjectSlots[s.index] = m_ObjectSlots[last];
+			m_Slots[m_ObjectSlots[s.index]].index = s.index;
+		}
+		m_Objects[last].~T();
+		m_Size--;
+
+		s.generation++;
+		s.index = m_FreeSlot;
+		m_FreeSlot = handle.index;
+		return true;
+	}
+
+	template<typename T>
+	void SlotMap<T>::clear() {
+		// Every slot that holds an object goes on the free list with a new generation
+		for (uint32 i = 0; i < m_Size; i++) {
+			m_Objects[i].~T();
+
+			slot& s = m_Slots[m_ObjectSlots[i]];
+			s.generation++;
+			s.index = m_FreeSlot;
+			m_FreeSlot = m_ObjectSlots[i];
+		}
+		m_Size = 0;
+	}
+
+	template<typename T>
+	void SlotMap<T>::reserve(size_t capacity) {
+		if (capacity > m_Capacity) grow(capacity);
+	}
+
+	template<typename T>
+	T* SlotMap<T>::get(slot_handle handle) {
+		return contains(handle) ? m_Objects + m_Slots[handle.index].index : nullptr;
+	}
+
+	template<typename T>
+	const T* SlotMap<T>::get(slot_handle handle) const {
+		return contains(handle) ? m_Objects + m_Slots[handle.index].index : nullptr;
+	}
+
+	template<typename T>
+	bool SlotMap<T>::contains(slot_handle handle) const {
+		// The generation of a free slot is even, so it never matches the odd generation of a handle
+		return handle.index < m_SlotCount && m_Slots[handle.index].generation == handle.generation;
+	}
+
+	template<typename T>
+	slot_handle SlotMap<T>::handleAt(size_t index) const {
+		uint32 s = m_ObjectSlots[index];
+		return { s, m_Slots[s].generation };
+	}
+
+	template<typename T>
+	size_t SlotMap<T>::storageSize(size_t capacity) {
+		// The objects come first, the two index arrays follow at the next multiple of four
+		size_t objectsSize = (capacity * sizeof(T) + alignof(uint32) - 1) & ~(alignof(uint32) - 1);
+		return objectsSize + capacity * sizeof(uint32) + capacity * sizeof(slot);
+	}
+
+	template<typename T>
+	void SlotMap<T>::grow(size_t capacity) {
+		if (capacity >= EndOfList) throw std::bad_alloc();
+
+		size_t allignment = alignof(T) > alignof(slot) ? alignof(T) : alignof(slot);
+		void* storage = m_Allocator.allocate(storageSize(capacity), allignment);
+		size_t objectsSize = storageSize(capacity) - capacity * (sizeof(uint32) + sizeof(slot));
+
+		T* objects = reinterpret_cast<T*>(storage);
+		uint32* objectSlots = reinterpret_cast<uint32*>(pointer_functions::shift_forward(storage, objectsSize));
+		slot* slots = reinterpret_cast<slot*>(objectSlots + capacity);
+
+		for (uint32 i = 0; i < m_Size; i++) {
+			new (objects + i) T(std::move(m_Objects[i]));
+			m_Objects[i].~T();
+		}
+		if (m_Size > 0) memcpy(objectSlots, m_ObjectSlots, m_Size * sizeof(uint32));
+		if (m_SlotCount > 0) memcpy(slots, m_Slots, m_SlotCount * sizeof(slot));
+
+		if (m_Objects != nullptr) m_Allocator.deallocate(m_Objects, storageSize(m_Capacity));
+		m_Objects = objects;
+		m_ObjectSlots = objectSlots;
+		m_Slots = slots;
+		m_Capacity = (uint32)capacity;
+	}
+}
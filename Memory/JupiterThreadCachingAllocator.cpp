@@ -0,0 +1,334 @@
+#include "JupiterThreadCachingAllocator.h"
+
+#include <bit>
+#include <new>
+#include <vector>
+
+namespace Jupiter {
+
+	namespace {
+
+		/// <summary>
+		/// Node stored inside of a cached block, links the block to the next block in a free list or remote free queue
+		/// </summary>
+		struct free_block {
+			free_block* next;
+		};
+
+		/// <summary>
+		/// Header stored in front of every block handed out by the thread caching allocator
+		/// </summary>
+		struct allocation_header {
+			ThreadCachingAllocator::thread_cache* owner;		// The cache the block belongs to, nullptr for large blocks
+			uint32 sizeClass;									// The size class of the block, LargeSizeClass for large blocks
+			uint32 offset;										// Offset from the start of the backend allocation to the payload
+		};
+
+		static_assert(sizeof(allocation_header) <= ThreadCachingAllocator::HeaderSize, "Allocation header does not fit in the header size!");
+
+		// Mutex guarding the creation, adoption and release of thread caches, these only happen when threads start, exit or
+		// when an allocator is destroyed so a single mutex is fine
+		std::mutex& lifecycleMutex() {
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		inline allocation_header* header_from_ptr(void* p) {
+			return reinterpret_cast<allocation_header*>(pointer_functions::shift_back(p, ThreadCachingAllocator::HeaderSize));
+		}
+
+		// The amount of blocks moved between a cache and the backend at once, smaller size classes move more blocks
+		inline uint32 batch_size(uint32 sizeClass) {
+			size_t count = (16 * 1024) / ThreadCachingAllocator::sizeClassSize(sizeClass);
+			if (count < 2) return 2;
+			if (count > 64) return 64;
+			return (uint32)count;
+		}
+	}
+
+	/// <summary>
+	/// Cache owned by a single thread.
+	/// The remote free queue is written by other threads, so it is kept on its own cache line apart from the free lists
+	/// </summary>
+	struct alignas(CacheLineSize) ThreadCachingAllocator::thread_cache {
+		std::atomic<free_block*> remoteFrees{ nullptr };						// Blocks deallocated by other threads
+
+		alignas(CacheLineSize) free_block* freeLists[SizeClassCount]{};		// Free blocks per size class
+		uint32 counts[SizeClassCount]{};										// The amount of blocks in every free list
+
+		ThreadCachingAllocator* allocator = nullptr;		// The allocator that created the cache, nullptr once it is destroyed
+		std::atomic<bool> threadAlive{ false };				// Flag wether or not a thread is using the cache
+		thread_cache* next = nullptr;						// The next cache created by the same allocator
+	};
+
+	/// <summary>
+	/// Thread local list of caches used by the thread, releases the caches when the thread exits
+	/// </summary>
+	struct thread_cache_registry {
+		std::vector<ThreadCachingAllocator::thread_cache*> caches;
+
+		~thread_cache_registry() {
+			std::lock_guard<std::mutex> lock(lifecycleMutex());
+			for (ThreadCachingAllocator::thread_cache* cache : caches) {
+				if (cache->allocator == nullptr) {
+					// The allocator is already destroyed, the thread is the last user of the cache
+					delete cache;
+				}
+				else {
+					// Return the cached blocks and leave the cache behind, so another thread can adopt it
+					cache->allocator->flushAll(cache);
+					cache->threadAlive.store(false, std::memory_order_release);
+				}
+			}
+			caches.clear();
+		}
+	};
+
+	static thread_local thread_cache_registry t_Registry;							// The caches of the calling thread
+	static thread_local ThreadCachingAllocator::thread_cache* t_LastCache = nullptr;	// The most recently used cache of the calling thread
+
+	ThreadCachingAllocator::ThreadCachingAllocator(IAllocator& backend) :
+		m_Backend(backend), m_Caches(nullptr)
+	{}
+
+	ThreadCachingAllocator::~ThreadCachingAllocator() {
+		std::lock_guard<std::mutex> lock(lifecycleMutex());
+
+		thread_cache* cache = m_Caches;
+		while (cache != nullptr) {
+			thread_cache* next = cache->next;
+			flushAll(cache);
+
+			// A cache still registered to a running thread is deleted by that thread when it exits
+			if (cache->threadAlive.load(std::memory_order_acquire)) cache->allocator = nullptr;
+			else delete cache;
+
+			cache = next;
+		}
+		m_Caches = nullptr;
+	}
+
+	void* ThreadCachingAllocator::allocate(size_t size, size_t allignment) {
+		if (size > MaxCachedSize || allignment > HeaderSize) {
+			return allocateLarge(size, allignment);
+		}
+
+		uint32 sizeClass = sizeClassIndex(size);
+		thread_cache* cache = acquireThreadCache();
+
+		// Pop a block from the free list of the thread, refill the list when it is empty
+		free_block* block = cache->freeLists[sizeClass];
+		if (block == nullptr) {
+			return refill(cache, sizeClass);
+		}
+
+		cache->freeLists[sizeClass] = block->next;
+		cache->counts[sizeClass]--;
+		return block;
+	}
+
+	void ThreadCachingAllocator::deallocate(void* p) {
+		if (p == nullptr) return;
+
+		allocation_header* header = header_from_ptr(p);
+		if (header->sizeClass == LargeSizeClass) {
+			deallocateLarge(p);
+			return;
+		}
+
+		free_block* block = reinterpret_cast<free_block*>(p);
+		thread_cache* owner = header->owner;
+
+		if (owner == findThreadCache()) {
+			// The block belongs to the calling thread, push it on the free list and flush a batch when the list grows too large
+			uint32 sizeClass = header->sizeClass;
+			block->next = owner->freeLists[sizeClass];
+			owner->freeLists[sizeClass] = block;
+
+			uint32 batch = batch_size(sizeClass);
+			if (++owner->counts[sizeClass] > 2 * batch) flush(owner, sizeClass, batch);
+		}
+		else {
+			// The block belongs to another thread, push it on the remote free queue of its owner
+			block->next = owner->remoteFrees.load(std::memory_order_relaxed);
+			while (!owner->remoteFrees.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed));
+		}
+	}
+
+	void ThreadCachingAllocator::deallocate(void* p, size_t size) {
+		deallocate(p);
+	}
+
+	void ThreadCachingAllocator::flushThreadCache() {
+		thread_cache* cache = findThreadCache();
+		if (cache != nullptr) flushAll(cache);
+	}
+
+	uint32 ThreadCachingAllocator::sizeClassIndex(size_t size) {
+		// Sizes up to 256 are rounded up to a multiple of 16
+		if (size <= 256) return size == 0 ? 0 : (uint32)((size + 15) / 16) - 1;
+
+		// Larger sizes are split in 4 classes per power of two
+		uint32 level = (uint32)std::bit_width(size - 1) - 1;
+		uint32 index = (uint32)((size - 1 - ((size_t)1 << level)) >> (level - 2));
+		return 16 + (level - 8) * 4 + index;
+	}
+
+	size_t ThreadCachingAllocator::sizeClassSize(uint32 sizeClass) {
+		if (sizeClass < 16) return (size_t)(sizeClass + 1) * 16;
+
+		uint32 level = 8 + (sizeClass - 16) / 4;
+		uint32 index = (sizeClass - 16) % 4;
+		return ((size_t)1 << level) + (size_t)(index + 1) * ((size_t)1 << (level - 2));
+	}
+
+	ThreadCachingAllocator::thread_cache* ThreadCachingAllocator::findThreadCache() const {
+		// Fast path, the thread mostly uses the same allocator as the last time
+		thread_cache* cache = t_LastCache;
+		if (cache != nullptr && cache->allocator == this) return cache;
+
+		for (thread_cache* registered : t_Registry.caches) {
+			if (registered->allocator == this) {
+				t_LastCache = registered;
+				return registered;
+			}
+		}
+		return nullptr;
+	}
+
+	ThreadCachingAllocator::thread_cache* ThreadCachingAllocator::acquireThreadCache() {
+		thread_cache* cache = findThreadCache();
+		if (cache != nullptr) return cache;
+
+		std::lock_guard<std::mutex> lock(lifecycleMutex());
+
+		// Adopt a cache left behind by a thread that exited, otherwise create a new one
+		for (thread_cache* orphan = m_Caches; orphan != nullptr; orphan = orphan->next) {
+			if (!orphan->threadAlive.load(std::memory_order_acquire)) {
+				cache = orphan;
+				break;
+			}
+		}
+
+		if (cache == nullptr) {
+			cache = new thread_cache();
+			cache->allocator = this;
+			cache->next = m_Caches;
+			m_Caches = cache;
+		}
+		cache->threadAlive.store(true, std::memory_order_release);
+
+		// Release caches of allocators that were destroyed while this thread was running
+		std::vector<thread_cache*>& caches = t_Registry.caches;
+		for (size_t i = 0; i < caches.size();) {
+			if (caches[i]->allocator == nullptr) {
+				delete caches[i];
+				caches[i] = caches.back();
+				caches.pop_back();
+			}
+			else i++;
+		}
+
+		caches.push_back(cache);
+		t_LastCache = cache;
+		return cache;
+	}
+
+	void* ThreadCachingAllocator::refill(thread_cache* cache, uint32 sizeClass) {
+		// Blocks freed by other threads are picked up before going to the backend
+		drainRemoteFrees(cache);
+
+		free_block* list = cache->freeLists[sizeClass];
+		uint32 count = cache->counts[sizeClass];
+
+		if (list == nullptr) {
+			size_t blockSize = sizeClassSize(sizeClass) + HeaderSize;
+			uint32 batch = batch_size(sizeClass);
+
+			std::lock_guard<std::mutex> lock(m_BackendMutex);
+			for (uint32 i = 0; i < batch; i++) {
+				void* data = nullptr;
+				try {
+					data = m_Backend.allocate(blockSize, HeaderSize);
+				}
+				catch (std::bad_alloc&) {
+					// Only fail when not a single block could be allocated
+					if (count == 0) throw;
+					break;
+				}
+
+				allocation_header* header = reinterpret_cast<allocation_header*>(data);
+				header->owner = cache;
+				header->sizeClass = sizeClass;
+				header->offset = (uint32)HeaderSize;
+
+				free_block* block = reinterpret_cast<free_block*>(pointer_functions::shift_forward(data, HeaderSize));
+				block->next = list;
+				list = block;
+				count++;
+			}
+		}
+
+		// Hand out the first block and keep the rest in the free list
+		cache->freeLists[sizeClass] = list->next;
+		cache->counts[sizeClass] = count - 1;
+		return list;
+	}
+
+	void ThreadCachingAllocator::flush(thread_cache* cache, uint32 sizeClass, uint32 count) {
+		std::lock_guard<std::mutex> lock(m_BackendMutex);
+		for (uint32 i = 0; i < count && cache->freeLists[sizeClass] != nullptr; i++) {
+			free_block* block = cache->freeLists[sizeClass];
+			cache->freeLists[sizeClass] = block->next;
+			cache->counts[sizeClass]--;
+			m_Backend.deallocate(pointer_functions::shift_back(block, header_from_ptr(block)->offset));
+		}
+	}
+
+	void ThreadCachingAllocator::flushAll(thread_cache* cache) {
+		drainRemoteFrees(cache);
+		for (uint32 sizeClass = 0; sizeClass < SizeClassCount; sizeClass++) {
+			if (cache->counts[sizeClass] != 0) flush(cache, sizeClass, cache->counts[sizeClass]);
+		}
+	}
+
+	void ThreadCachingAllocator::drainRemoteFrees(thread_cache* cache) {
+		// Take the entire queue at once, only the owner ever takes from the queue so there is no ABA problem
+		free_block* block = cache->remoteFrees.exchange(nullptr, std::memory_order_acquire);
+		while (block != nullptr) {
+			free_block* next = block->next;
+			uint32 sizeClass = header_from_ptr(block)->sizeClass;
+
+			block->next = cache->freeLists[sizeClass];
+			cache->freeLists[sizeClass] = block;
+			cache->counts[sizeClass]++;
+
+			block = next;
+		}
+	}
+
+	void* ThreadCachingAllocator::allocateLarge(size_t size, size_t allignment) {
+		// Over allocate so the payload can be aligned with room for the header in front of it
+		size_t alignment = allignment > HeaderSize ? allignment : HeaderSize;
+		void* data = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_BackendMutex);
+			data = m_Backend.allocate(size + alignment, HeaderSize);
+		}
+
+		uintptr_t payload = reinterpret_cast<uintptr_t>(data) + HeaderSize;
+		payload = (payload + alignment - 1) & ~(uintptr_t)(alignment - 1);
+
+		allocation_header* header = header_from_ptr(reinterpret_cast<void*>(payload));
+		header->owner = nullptr;
+		header->sizeClass = LargeSizeClass;
+		header->offset = (uint32)(payload - reinterpret_cast<uintptr_t>(data));
+		return reinterpret_cast<void*>(payload);
+	}
+
+	void ThreadCachingAllocator::deallocateLarge(void* p) {
+		void* data = pointer_functions::shift_back(p, header_from_ptr(p)->offset);
+		std::lock_guard<std::mutex> lock(m_BackendMutex);
+		m_Backend.deallocate(data);
+	}
+}
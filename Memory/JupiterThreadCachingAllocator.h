@@ -0,0 +1,94 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Thread safe allocator that sits in front of another allocator, the backend.
+	/// Every thread gets its own cache with a free list per size class, allocations and deallocations on the owning thread
+	/// never touch shared state. When a free list is empty it is refilled with a batch of blocks from the backend, when it grows
+	/// too large a batch is flushed back to the backend. The backend is only locked for these batches.
+	/// Blocks that are deallocated on another thread then the one that allocated them are pushed on a lock free remote free
+	/// queue of the owning cache, the owner picks them up the next time one of its free lists runs empty.
+	///
+	/// Every block carries a small header in front of it with its owning cache and size class.
+	/// Allocations larger then MaxCachedSize or with an alignment larger then the header size bypass the caches
+	/// and go to the backend directly. The backend needs to support deallocate(void*), eg. BlockAllocator,
+	/// a PoolAllocator only works as backend for sizes that fit inside of its slots.
+	/// </summary>
+	class ThreadCachingAllocator final : public IAllocator {
+
+	public:
+		struct thread_cache;			// Per thread cache, defined in JupiterThreadCachingAllocator.cpp
+
+		static constexpr size_t HeaderSize = 16;				// Size of the header in front of every block, also the alignment of cached blocks
+		static constexpr size_t MaxCachedSize = 32 * 1024;		// Largest allocation that is served from the thread caches
+		static constexpr uint32 SizeClassCount = 44;			// 16 classes of 16 bytes up to 256, then 4 classes per power of two
+		static constexpr uint32 LargeSizeClass = ~0u;			// Size class stored in the header of blocks that bypass the caches
+
+	public:
+		ThreadCachingAllocator() = delete;
+
+		/// <summary>
+		/// Creates a thread caching allocator in front of a backend allocator
+		/// The backend needs to outlive this allocator, all access to the backend is serialized by this allocator
+		/// </summary>
+		/// <param name="backend">The allocator the thread caches refill from and flush to</param>
+		ThreadCachingAllocator(IAllocator& backend);
+
+		ThreadCachingAllocator(const ThreadCachingAllocator&) = delete;				// Delete copy constructor
+		ThreadCachingAllocator& operator=(const ThreadCachingAllocator&) = delete;	// Delete copy assignment operator
+
+		/// <summary>
+		/// Returns all cached blocks of every thread to the backend.
+		/// Blocks that are still allocated are not returned, no thread may use the allocator while it is destroyed
+		/// </summary>
+		virtual ~ThreadCachingAllocator() override;
+
+		virtual void* allocate(size_t size, size_t allignment = 4) override;		// Allocates a block from the cache of the calling thread
+		virtual void deallocate(void* p) override;								// Returns the block to its owning cache
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate(p), the size class is stored in the header
+
+		/// <summary>
+		/// Returns all blocks cached by the calling thread to the backend
+		/// </summary>
+		void flushThreadCache();
+
+		/// <summary>
+		/// Gets the size class index for an allocation size
+		/// </summary>
+		/// <param name="size">The size of the allocation, needs to be smaller or equal to MaxCachedSize</param>
+		/// <returns>The index of the smallest size class that fits the size</returns>
+		static uint32 sizeClassIndex(size_t size);
+
+		/// <summary>
+		/// Gets the size of the blocks in a size class
+		/// </summary>
+		/// <param name="sizeClass">The index of the size class</param>
+		/// <returns>The size of the payload of every block in the size class</returns>
+		static size_t sizeClassSize(uint32 sizeClass);
+
+	private:
+		thread_cache* findThreadCache() const;							// Gets the cache of the calling thread, nullptr if it has none yet
+		thread_cache* acquireThreadCache();								// Gets the cache of the calling thread, creates or adopts one if needed
+		void* refill(thread_cache* cache, uint32 sizeClass);			// Refills an empty free list and returns a block from it
+		void flush(thread_cache* cache, uint32 sizeClass, uint32 count);	// Returns blocks from a free list to the backend
+		void flushAll(thread_cache* cache);								// Returns every cached block of a cache to the backend
+		void drainRemoteFrees(thread_cache* cache);						// Moves the blocks on the remote free queue into the free lists
+
+		void* allocateLarge(size_t size, size_t allignment);				// Allocates a block directly from the backend
+		void deallocateLarge(void* p);									// Deallocates a block directly to the backend
+
+	private:
+		IAllocator& m_Backend;			// The allocator blocks are refilled from and flushed to
+		std::mutex m_BackendMutex;		// Serializes access to the backend
+
+		thread_cache* m_Caches;			// Linked list of all caches created by this allocator, guarded by the lifecycle mutex
+
+		friend struct thread_cache_registry;		// Releases the caches of a thread when it exits
+	};
+}
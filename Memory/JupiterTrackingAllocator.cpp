@@ -0,0 +1,240 @@
+#include "JupiterTrackingAllocator.h"
+
+#include "JupiterAllocatorExceptions.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+namespace Jupiter {
+
+	namespace {
+
+		constexpr size_t min_capacity = 16;
+
+		void dump_to_cerr(const TrackingAllocator& allocator) {
+			allocator.dumpLeaks(std::cerr);
+		}
+
+		std::atomic<allocator_tracking::report_handler> s_ReportHandler = dump_to_cerr;	// Trackers can be destroyed on any thread
+
+		// Orders records by tag and then by call site, tags are compared by content as the same literal can have several addresses
+		bool record_less(const TrackingAllocator::allocation_record* a, const TrackingAllocator::allocation_record* b) {
+			int order = strcmp(a->tag, b->tag);
+			if (order != 0) return order < 0;
+			order = strcmp(a->file, b->file);
+			if (order != 0) return order < 0;
+			return a->line < b->line;
+		}
+
+		// Collects the live records of a table, sorted by tag and call site
+		std::vector<const TrackingAllocator::allocation_record*> sorted_records(const std::vector<TrackingAllocator::allocation_record>& table) {
+			std::vector<const TrackingAllocator::allocation_record*> records;
+			for (const TrackingAllocator::allocation_record& record : table) {
+				if (record.p != nullptr) records.push_back(&record);
+			}
+			std::sort(records.begin(), records.end(), record_less);
+			return records;
+		}
+	}
+
+	TrackingAllocator::TrackingAllocator(IAllocator& allocator, size_t initialCapacity) :
+		m_Allocator(allocator), m_Tag(DefaultTag), m_Shift(0), m_Count(0), m_Bytes(0)
+	{
+		// Keep the table at most three quarters full with the initial amount of records
+		size_t capacity = std::bit_ceil(initialCapacity + initialCapacity / 3 + 1);
+		if (capacity < min_capacity) capacity = min_capacity;
+		m_Records.resize(capacity, allocation_record{});
+		m_Shift = 64 - (uint32)std::countr_zero(capacity);
+	}
+
+	TrackingAllocator::~TrackingAllocator() {
+		if (m_Count != 0) {
+			allocator_tracking::report_handler handler = s_ReportHandler.load();
+			if (handler != nullptr) handler(*this);
+		}
+	}
+
+	void* TrackingAllocator::allocate(size_t size, size_t allignment) {
+		reserve();
+		return track(m_Allocator.allocate(size, allignment), size, m_Tag, nullptr);
+	}
+
+	void* TrackingAllocator::allocate(size_t size, size_t allignment, const char* tag, std::source_location location) {
+		reserve();
+		return track(m_Allocator.allocate(size, allignment), size, tag, &location);
+	}
+
+	void TrackingAllocator::deallocate(void* p) {
+		if (p == nullptr) return;
+
+		size_t slot = slotOf(p);
+		if (slot == m_Records.size()) {
+			throw jpt_bad_free("Tracking allocator cannot deallocate a block it did not allocate!");
+		}
+		m_Allocator.deallocate(p);
+		erase(slot);
+	}
+
+	void TrackingAllocator::deallocate(void* p, size_t size) {
+		if (p == nullptr) return;
+
+		size_t slot = slotOf(p);
+		if (slot == m_Records.size()) {
+			throw jpt_bad_free("Tracking allocator cannot deallocate a block it did not allocate!");
+		}
+		m_Allocator.deallocate(p, size);
+		erase(slot);
+	}
+
+	bool TrackingAllocator::tryResize(void* p, size_t newSize) {
+		size_t slot = slotOf(p);
+		if (slot == m_Records.size() || !m_Allocator.tryResize(p, newSize)) return false;
+
+		m_Bytes = m_Bytes - m_Records[slot].size + newSize;
+		m_Records[slot].size = newSize;
+		return true;
+	}
+
+	void* TrackingAllocator::reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment) {
+		if (p == nullptr) return allocate(newSize, allignment);
+
+		size_t slot = slotOf(p);
+		if (slot == m_Records.size()) {
+			throw jpt_bad_free("Tracking allocator cannot reallocate a block it did not allocate!");
+		}
+
+		// Make room up front, once the wrapped allocator moved the block the record has to be moved with it
+		allocation_record record = m_Records[slot];
+		reserve();
+		void* moved = m_Allocator.reallocate(p, oldSize, newSize, allignment);
+
+		erase(slotOf(p));
+		record.p = moved;
+		record.size = newSize;
+		insert(record);
+		return moved;
+	}
+
+	const char* TrackingAllocator::setTag(const char* tag) {
+		const char* previous = m_Tag;
+		m_Tag = tag;
+		return previous;
+	}
+
+	const TrackingAllocator::allocation_record* TrackingAllocator::find(const void* p) const {
+		size_t slot = slotOf(p);
+		return slot != m_Records.size() ? &m_Records[slot] : nullptr;
+	}
+
+	std::vector<TrackingAllocator::tag_summary> TrackingAllocator::summarize() const {
+		std::vector<tag_summary> summaries;
+		for (const allocation_record* record : sorted_records(m_Records)) {
+			if (summaries.empty() || strcmp(summaries.back().tag, record->tag) != 0) summaries.push_back({ record->tag, 0, 0 });
+			summaries.back().allocations++;
+			summaries.back().bytes += record->size;
+		}
+
+		std::stable_sort(summaries.begin(), summaries.end(), [](const tag_summary& a, const tag_summary& b) { return a.bytes > b.bytes; });
+		return summaries;
+	}
+
+	void TrackingAllocator::dumpLeaks(std::ostream& stream) const {
+		stream << "TrackingAllocator: " << m_Count << " live allocations (" << m_Bytes << " bytes)" << std::endl;
+
+		std::vector<const allocation_record*> records = sorted_records(m_Records);
+		for (const tag_summary& summary : summarize()) {
+			stream << "  " << summary.tag << ": " << summary.allocations << " allocations (" << summary.bytes << " bytes)" << std::endl;
+
+			// The records of a tag are next to each other, sorted by call site, so every call site is a single run
+			auto first = std::find_if(records.begin(), records.end(), [&](const allocation_record* record) { return strcmp(record->tag, summary.tag) == 0; });
+			while (first != records.end() && strcmp((*first)->tag, summary.tag) == 0) {
+				auto last = first;
+				size_t bytes = 0;
+				while (last != records.end() && !record_less(*first, *last) && !record_less(*last, *first)) bytes += (*last++)->size;
+
+				if ((*first)->line == 0) stream << "    unknown call site";
+				else stream << "    " << (*first)->file << ":" << (*first)->line << " " << (*first)->function;
+				stream << ": " << (last - first) << " allocations (" << bytes << " bytes)" << std::endl;
+				first = last;
+			}
+		}
+	}
+
+	void* TrackingAllocator::track(void* p, size_t size, const char* tag, const std::source_location* location) {
+		allocation_record record = { p, size, tag, "", "", 0 };
+		if (location != nullptr) {
+			record.file = location->file_name();
+			record.function = location->function_name();
+			record.line = location->line();
+		}
+		insert(record);
+		return p;
+	}
+
+	size_t TrackingAllocator::home(const void* p) const {
+		// Fibonacci hashing, the multiply spreads the aligned low bits of the address over the high bits
+		return (size_t)(((uint64)reinterpret_cast<uintptr_t>(p) * 0x9E3779B97F4A7C15ull) >> m_Shift);
+	}
+
+	size_t TrackingAllocator::slotOf(const void* p) const {
+		if (p == nullptr) return m_Records.size();
+
+		size_t mask = m_Records.size() - 1;
+		for (size_t slot = home(p); m_Records[slot].p != nullptr; slot = (slot + 1) & mask) {
+			if (m_Records[slot].p == p) return slot;
+		}
+		return m_Records.size();
+	}
+
+	void TrackingAllocator::insert(const allocation_record& record) {
+		size_t mask = m_Records.size() - 1;
+		size_t slot = home(record.p);
+		while (m_Records[slot].p != nullptr && m_Records[slot].p != record.p) slot = (slot + 1) & mask;
+
+		// An address that is already tracked was handed out again, eg. a zero sized block, the newest record wins
+		if (m_Records[slot].p == nullptr) m_Count++;
+		else m_Bytes -= m_Records[slot].size;
+
+		m_Records[slot] = record;
+		m_Bytes += record.size;
+	}
+
+	void TrackingAllocator::erase(size_t slot) {
+		m_Count--;
+		m_Bytes -= m_Records[slot].size;
+
+		// Shift the records of the same probe sequence back into the hole, a record only moves when its home slot is not in between
+		size_t mask = m_Records.size() - 1;
+		size_t next = slot;
+		while (true) {
+			next = (next + 1) & mask;
+			if (m_Records[next].p == nullptr) break;
+
+			size_t distance = (next - home(m_Records[next].p)) & mask;
+			if (distance >= ((next - slot) & mask)) {
+				m_Records[slot] = m_Records[next];
+				slot = next;
+			}
+		}
+		m_Records[slot].p = nullptr;
+	}
+
+	void TrackingAllocator::reserve() {
+		if ((m_Count + 1) * 4 <= m_Records.size() * 3) return;
+
+		std::vector<allocation_record> records(m_Records.size() * 2, allocation_record{});
+		records.swap(m_Records);
+		m_Shift--;
+		m_Count = 0;
+		m_Bytes = 0;
+		for (const allocation_record& record : records) {
+			if (record.p != nullptr) insert(record);
+		}
+	}
+
+	allocator_tracking::report_handler allocator_tracking::setReportHandler(report_handler handler) {
+		return s_ReportHandler.exchange(handler);
+	}
+}
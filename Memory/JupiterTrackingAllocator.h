@@ -0,0 +1,154 @@
+#pragma once
+
+#include "JupiterAllocator.h"
+
+#include <source_location>
+#include <vector>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// Opt in layer over any IAllocator that remembers a tag and the call site of every live allocation,
+	/// used to find out which subsystem bloats an arena without running a heap profiler.
+	/// Every call is passed on to the wrapped allocator, the tracker only keeps a record per live block.
+	///
+	/// The records are kept in an open addressed hash table keyed by the address of the block, using linear probing and
+	/// backward shift deletion so there are no tombstones. Lookups are a multiply and a short scan over a flat array.
+	/// When the tracker is destroyed while blocks are still live the outstanding blocks are reported grouped by tag.
+	///
+	/// Tags and call sites are stored as pointers, so tags need to be string literals or otherwise outlive the tracker.
+	/// The tracker is not thread safe, just like the allocators it wraps.
+	/// </summary>
+	class TrackingAllocator final : public IAllocator {
+
+	public:
+		/// <summary>
+		/// Record of a single live allocation
+		/// </summary>
+		struct allocation_record {
+			void* p;					// The address of the block, nullptr for an empty slot of the table
+			size_t size;				// The size the block was requested with
+			const char* tag;			// The tag the block was allocated with
+			const char* file;			// The file of the call site, empty when the call site is not known
+			const char* function;		// The function of the call site
+			uint32 line;				// The line of the call site
+		};
+
+		/// <summary>
+		/// The live allocations of a single tag
+		/// </summary>
+		struct tag_summary {
+			const char* tag;			// The tag
+			size_t allocations;			// The amount of live blocks with the tag
+			size_t bytes;				// The requested bytes of all live blocks with the tag
+		};
+
+		static constexpr const char* DefaultTag = "untagged";		// The tag used until setTag is called
+
+	public:
+		TrackingAllocator() = delete;
+
+		/// <summary>
+		/// Creates a tracker around an allocator, the allocator needs to outlive the tracker
+		/// </summary>
+		/// <param name="allocator">The allocator every call is passed on to</param>
+		/// <param name="initialCapacity">The amount of records the table has room for before it grows</param>
+		TrackingAllocator(IAllocator& allocator, size_t initialCapacity = 256);
+
+		TrackingAllocator(const TrackingAllocator&) = delete;					// Delete copy constructor, the records belong to a single tracker
+		TrackingAllocator& operator=(const TrackingAllocator&) = delete;		// Delete copy assignment operator
+
+		virtual ~TrackingAllocator() override;									// Reports the blocks that are still live
+
+		/// <summary>
+		/// Allocates a block with the current tag, the call site is not known through the IAllocator interface
+		/// </summary>
+		virtual void* allocate(size_t size, size_t allignment = 4) override;
+
+		/// <summary>
+		/// Allocates a block and records the tag and call site with it
+		/// Throws std::bad_alloc when the wrapped allocator is out of memory
+		/// </summary>
+		/// <param name="size">The size of the block</param>
+		/// <param name="allignment">The alignment of the block</param>
+		/// <param name="tag">The tag of the block, eg. the name of the subsystem</param>
+		/// <param name="location">The call site, filled in by the compiler</param>
+		void* allocate(size_t size, size_t allignment, const char* tag, std::source_location location = std::source_location::current());
+
+		/// <summary>
+		/// Frees a block and forgets its record
+		/// Throws jpt_bad_free when the block was not allocated through this tracker
+		/// </summary>
+		virtual void deallocate(void* p) override;
+		virtual void deallocate(void* p, size_t size) override;					// Same as deallocate, the size is passed on to the wrapped allocator
+
+		virtual bool tryResize(void* p, size_t newSize) override;				// Passes the resize on, the record keeps its tag and call site
+		virtual void* reallocate(void* p, size_t oldSize, size_t newSize, size_t allignment = 4) override;	// Passes the reallocation on, a moved block keeps its tag and call site
+
+		virtual const AllocatorStats* getStats() const override { return m_Allocator.getStats(); }		// The statistics of the wrapped allocator
+		virtual void resetStats() override { m_Allocator.resetStats(); }								// Resets the statistics of the wrapped allocator
+
+		/// <summary>
+		/// Sets the tag of the blocks allocated without one, eg. through the IAllocator interface
+		/// </summary>
+		/// <returns>The previous tag</returns>
+		const char* setTag(const char* tag);
+
+		/// <summary>
+		/// Gets the record of a live block
+		/// </summary>
+		/// <returns>The record, nullptr when the block is not allocated through this tracker</returns>
+		const allocation_record* find(const void* p) const;
+
+		/// <summary>
+		/// Sums the live blocks per tag, sorted from the most bytes to the least
+		/// </summary>
+		std::vector<tag_summary> summarize() const;
+
+		/// <summary>
+		/// Writes the live blocks grouped by tag, and per tag grouped by call site, eg. when the tracker is destroyed
+		/// </summary>
+		void dumpLeaks(std::ostream& stream) const;
+
+		inline IAllocator& getAllocator() const { return m_Allocator; }		// The wrapped allocator
+		inline const char* getTag() const { return m_Tag; }					// The tag of blocks allocated without one
+		inline size_t getLiveAllocations() const { return m_Count; }		// The amount of blocks currently live
+		inline size_t getLiveBytes() const { return m_Bytes; }				// The requested bytes of all blocks currently live
+
+	private:
+		void* track(void* p, size_t size, const char* tag, const std::source_location* location);	// Records a block that was just allocated
+		size_t slotOf(const void* p) const;									// Gets the slot of a live block, the capacity when it is not tracked
+		void insert(const allocation_record& record);						// Adds a record, the table needs to have room for it
+		void erase(size_t slot);											// Removes the record in a slot and shifts the records after it back
+		void reserve();														// Grows the table when adding a record would make it too full
+
+		inline size_t home(const void* p) const;							// The slot the probe for an address starts at
+
+	private:
+		IAllocator& m_Allocator;					// The allocator every call is passed on to
+		const char* m_Tag;							// The tag of blocks allocated without one
+
+		std::vector<allocation_record> m_Records;	// The table, its size is a power of two
+		uint32 m_Shift;								// 64 minus log2 of the size of the table, used to hash into it
+		size_t m_Count;								// The amount of records in the table
+		size_t m_Bytes;								// The requested bytes of all records in the table
+	};
+
+	/// <summary>
+	/// Namespace containing the report of the blocks still live when a tracker is destroyed
+	/// </summary>
+	namespace allocator_tracking {
+
+		/// <summary>
+		/// Function called when a tracker is destroyed while blocks are still live
+		/// </summary>
+		typedef void (*report_handler)(const TrackingAllocator& allocator);
+
+		/// <summary>
+		/// Sets the function called when a tracker is destroyed with blocks still live.
+		/// The default handler writes the dump of the tracker to std::cerr, nullptr silences the reports
+		/// </summary>
+		/// <returns>The previous handler</returns>
+		report_handler setReportHandler(report_handler handler);
+	}
+}
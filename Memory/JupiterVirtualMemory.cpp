@@ -0,0 +1,190 @@
+#include "JupiterVirtualMemory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#endif
+
+namespace Jupiter {
+
+	namespace {
+
+		inline size_t align_huge(size_t size) {
+			return (size + virtual_memory::HugePageSize - 1) & ~(virtual_memory::HugePageSize - 1);
+		}
+
+#ifdef _WIN32
+		// Reserves (and optionally commits) a range aligned to a power of two, windows cannot release part of a
+		// reservation, so a larger range is reserved to find an aligned address which is then reserved on its own
+		void* reserve_aligned(size_t size, size_t alignment, DWORD type, DWORD protect) {
+			for (int attempt = 0; attempt < 8; attempt++) {
+				void* probe = VirtualAlloc(nullptr, size + alignment, MEM_RESERVE, PAGE_NOACCESS);
+				if (probe == nullptr) return nullptr;
+
+				uintptr_t aligned = (reinterpret_cast<uintptr_t>(probe) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+				VirtualFree(probe, 0, MEM_RELEASE);
+
+				// Another thread may have taken the address in the meantime, in that case try again
+				void* ptr = VirtualAlloc(reinterpret_cast<void*>(aligned), size, type, protect);
+				if (ptr != nullptr) return ptr;
+			}
+			return nullptr;
+		}
+#else
+		// Maps a range aligned to a power of two by mapping a larger range and unmapping the unaligned head and tail
+		void* map_aligned(size_t size, size_t alignment, int protect) {
+			void* probe = mmap(nullptr, size + alignment, protect, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+			if (probe == MAP_FAILED) return nullptr;
+
+			uintptr_t start = reinterpret_cast<uintptr_t>(probe);
+			uintptr_t aligned = (start + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			if (aligned != start) munmap(probe, aligned - start);
+			if (aligned + size != start + size + alignment) {
+				munmap(reinterpret_cast<void*>(aligned + size), start + size + alignment - (aligned + size));
+			}
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		// Transparent huge pages only back madvised memory when the system is not configured to never use them
+		bool transparent_huge_pages_enabled() {
+			std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+			std::string setting;
+			if (!std::getline(file, setting)) return false;
+			return setting.find("[never]") == std::string::npos;
+		}
+
+		// Asks the system to back a range with transparent huge pages, returns the kind of pages that back the range
+		EnumPageBacking advise_huge(void* ptr, size_t size) {
+#ifdef MADV_HUGEPAGE
+			if (transparent_huge_pages_enabled() && madvise(ptr, size, MADV_HUGEPAGE) == 0) return EnumPageBacking::TransparentHugePages;
+#endif
+			return EnumPageBacking::Default;
+		}
+#endif
+	}
+
+	size_t virtual_memory::page_size() {
+		static size_t pageSize = 0;
+		if (pageSize == 0) {
+#ifdef _WIN32
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			pageSize = (size_t)info.dwPageSize;
+#else
+			pageSize = (size_t)sysconf(_SC_PAGESIZE);
+#endif
+		}
+		return pageSize;
+	}
+
+	void* virtual_memory::reserve(size_t size) {
+#ifdef _WIN32
+		return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+		void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		return ptr == MAP_FAILED ? nullptr : ptr;
+#endif
+	}
+
+	bool virtual_memory::commit(void* ptr, size_t size) {
+#ifdef _WIN32
+		return VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+		return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+	}
+
+	void virtual_memory::decommit(void* ptr, size_t size) {
+#ifdef _WIN32
+		VirtualFree(ptr, size, MEM_DECOMMIT);
+#else
+		// Drop the pages first so the physical memory is returned, then make the range inaccessible again
+		madvise(ptr, size, MADV_DONTNEED);
+		mprotect(ptr, size, PROT_NONE);
+#endif
+	}
+
+	void virtual_memory::release(void* ptr, size_t size) {
+		if (ptr == nullptr) return;
+#ifdef _WIN32
+		VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+		munmap(ptr, size);
+#endif
+	}
+
+	void* virtual_memory::allocate_aligned(size_t size, size_t alignment) {
+		size_t pageSize = page_size();
+		size = (size + pageSize - 1) & ~(pageSize - 1);
+#ifdef _WIN32
+		// Allocations are aligned to the allocation granularity (64KB) already
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		if (alignment <= (size_t)info.dwAllocationGranularity) return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		return reserve_aligned(size, alignment, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+		if (alignment <= pageSize) {
+			void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			return ptr == MAP_FAILED ? nullptr : ptr;
+		}
+		return map_aligned(size, alignment, PROT_READ | PROT_WRITE);
+#endif
+	}
+
+	void* virtual_memory::allocate_huge(size_t size, EnumPageBacking& backing) {
+		size = align_huge(size);
+#ifdef _WIN32
+		// Large pages need the SeLockMemoryPrivilege, without it the allocation fails and normal pages are used
+		size_t largePageSize = GetLargePageMinimum();
+		if (largePageSize != 0) {
+			size_t largeSize = (size + largePageSize - 1) & ~(largePageSize - 1);
+			void* ptr = VirtualAlloc(nullptr, largeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (ptr != nullptr) {
+				backing = EnumPageBacking::HugePages;
+				return ptr;
+			}
+		}
+
+		backing = EnumPageBacking::Default;
+		return reserve_aligned(size, virtual_memory::HugePageSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+		void* ptr = nullptr;
+#ifdef MAP_HUGETLB
+		// Explicit huge pages only succeed when the system has huge pages reserved
+		ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (ptr != MAP_FAILED) {
+			backing = EnumPageBacking::HugePages;
+			return ptr;
+		}
+#endif
+		ptr = map_aligned(size, HugePageSize, PROT_READ | PROT_WRITE);
+		if (ptr == nullptr) return nullptr;
+
+		backing = advise_huge(ptr, size);
+		return ptr;
+#endif
+	}
+
+	void* virtual_memory::reserve_huge(size_t size, EnumPageBacking& backing) {
+		size = align_huge(size);
+#ifdef _WIN32
+		// Large pages cannot be committed on demand on windows
+		backing = EnumPageBacking::Default;
+		return reserve_aligned(size, virtual_memory::HugePageSize, MEM_RESERVE, PAGE_NOACCESS);
+#else
+		void* ptr = map_aligned(size, HugePageSize, PROT_NONE);
+		if (ptr == nullptr) return nullptr;
+
+		// The advice is kept when the pages are committed later on
+		backing = advise_huge(ptr, size);
+		return ptr;
+#endif
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Jupiter {
+
+	/// <summary>
+	/// The kind of pages backing a range of memory
+	/// </summary>
+	enum class EnumPageBacking {
+		Default = 0,				// Normal sized pages
+		TransparentHugePages = 1,	// Normal pages that the system is asked to promote to huge pages (MADV_HUGEPAGE)
+		HugePages = 2				// Explicit huge pages (MAP_HUGETLB or MEM_LARGE_PAGES)
+	};
+
+	/// <summary>
+	/// Namespace containing functions to reserve and commit virtual memory.
+	/// Reserving memory only claims a range of addresses, the range only takes up physical memory once it is committed.
+	/// Uses VirtualAlloc on windows and mmap on other platforms
+	/// </summary>
+	namespace virtual_memory {
+
+		constexpr size_t HugePageSize = 2 * 1024 * 1024;		// Size of a huge page, memory backed by huge pages is aligned to this size
+
+		/// <summary>
+		/// Gets the size of a page, every commit and decommit is done in whole pages
+		/// </summary>
+		/// <returns>The page size in bytes</returns>
+		size_t page_size();
+
+		/// <summary>
+		/// Reserves a range of addresses without committing any memory to it, accessing the range is not allowed until it is committed
+		/// </summary>
+		/// <param name="size">The size of the range in bytes, rounded up to whole pages</param>
+		/// <returns>The start of the reserved range, nullptr when the range could not be reserved</returns>
+		void* reserve(size_t size);
+
+		/// <summary>
+		/// Commits a part of a reserved range so it can be read from and written to
+		/// </summary>
+		/// <param name="ptr">The start of the part to commit, needs to be page aligned</param>
+		/// <param name="size">The size of the part in bytes</param>
+		/// <returns>True when the memory was committed</returns>
+		bool commit(void* ptr, size_t size);
+
+		/// <summary>
+		/// Decommits a part of a reserved range, the physical memory is returned to the system but the addresses stay reserved
+		/// </summary>
+		/// <param name="ptr">The start of the part to decommit, needs to be page aligned</param>
+		/// <param name="size">The size of the part in bytes</param>
+		void decommit(void* ptr, size_t size);
+
+		/// <summary>
+		/// Releases an entire reserved range
+		/// </summary>
+		/// <param name="ptr">The start of the range returned by reserve</param>
+		/// <param name="size">The size that was passed to reserve</param>
+		void release(void* ptr, size_t size);
+
+		/// <summary>
+		/// Allocates committed memory aligned to a power of two, the memory is taken directly from the system
+		/// so releasing it returns the physical memory immediately
+		/// </summary>
+		/// <param name="size">The size of the memory in bytes, rounded up to whole pages</param>
+		/// <param name="alignment">The alignment of the start of the memory, a power of two</param>
+		/// <returns>The start of the memory, nullptr when no memory could be allocated. Release it with release(ptr, size)</returns>
+		void* allocate_aligned(size_t size, size_t alignment);
+
+		/// <summary>
+		/// Allocates committed memory aligned to the huge page size, trying explicit huge pages first,
+		/// then transparent huge pages and normal pages last
+		/// </summary>
+		/// <param name="size">The size of the memory in bytes, rounded up to whole huge pages</param>
+		/// <param name="backing">Receives the kind of pages that were obtained</param>
+		/// <returns>The start of the memory, nullptr when no memory could be allocated. Release it with release(ptr, size)</returns>
+		void* allocate_huge(size_t size, EnumPageBacking& backing);
+
+		/// <summary>
+		/// Reserves a range of addresses aligned to the huge page size and asks the system to back it with transparent huge
+		/// pages once it is committed. Explicit huge pages cannot be committed on demand, so they are never used for a reserve
+		/// </summary>
+		/// <param name="size">The size of the range in bytes, rounded up to whole huge pages</param>
+		/// <param name="backing">Receives the kind of pages that will back the range</param>
+		/// <returns>The start of the reserved range, nullptr when the range could not be reserved. Release it with release(ptr, size)</returns>
+		void* reserve_huge(size_t size, EnumPageBacking& backing);
+	}
+}
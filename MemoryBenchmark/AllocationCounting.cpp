@@ -0,0 +1,109 @@
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+// Counts every call into the heap of the benchmark process.
+// On Linux with glibc the malloc family is interposed: the definitions below take the place of the glibc functions for the
+// whole process, including the C++ runtime, and pass the call on to the glibc implementation after counting it.
+// The global operator new and delete are replaced as well, they are counted on their own and then go through malloc and free.
+// The counters are relaxed atomics, so every heap call of every benchmark pays the same small cost for them.
+
+namespace {
+
+	std::atomic<size_t> s_Mallocs = 0;
+	std::atomic<size_t> s_Frees = 0;
+	std::atomic<size_t> s_News = 0;
+	std::atomic<size_t> s_Deletes = 0;
+}
+
+#if defined(__linux__) && defined(__GLIBC__)
+
+extern "C" {
+
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* p, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void* p);
+
+	void* malloc(size_t size) {
+		s_Mallocs.fetch_add(1, std::memory_order_relaxed);
+		return __libc_malloc(size);
+	}
+
+	void* calloc(size_t count, size_t size) {
+		s_Mallocs.fetch_add(1, std::memory_order_relaxed);
+		return __libc_calloc(count, size);
+	}
+
+	void* realloc(void* p, size_t size) {
+		s_Mallocs.fetch_add(1, std::memory_order_relaxed);
+		return __libc_realloc(p, size);
+	}
+
+	void* aligned_alloc(size_t alignment, size_t size) {
+		s_Mallocs.fetch_add(1, std::memory_order_relaxed);
+		return __libc_memalign(alignment, size);
+	}
+
+	void* memalign(size_t alignment, size_t size) {
+		s_Mallocs.fetch_add(1, std::memory_order_relaxed);
+		return __libc_memalign(alignment, size);
+	}
+
+	int posix_memalign(void** p, size_t alignment, size_t size) {
+		if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+
+		s_Mallocs.fetch_add(1, std::memory_order_relaxed);
+		void* block = __libc_memalign(alignment, size);
+		if (block == nullptr) return ENOMEM;
+		*p = block;
+		return 0;
+	}
+
+	void free(void* p) {
+		if (p != nullptr) s_Frees.fetch_add(1, std::memory_order_relaxed);
+		__libc_free(p);
+	}
+}
+
+// The array, nothrow and sized versions of the standard library all end up in these
+void* operator new(size_t size) {
+	s_News.fetch_add(1, std::memory_order_relaxed);
+	void* p = malloc(size > 0 ? size : 1);
+	if (p == nullptr) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept {
+	if (p != nullptr) s_Deletes.fetch_add(1, std::memory_order_relaxed);
+	free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept {
+	operator delete(p);
+}
+
+bool Benchmark::allocationCountingAvailable() {
+	return true;
+}
+
+#else
+
+bool Benchmark::allocationCountingAvailable() {
+	return false;
+}
+
+#endif
+
+Benchmark::allocation_counts Benchmark::allocationCounts() {
+	return {
+		s_Mallocs.load(std::memory_order_relaxed),
+		s_Frees.load(std::memory_order_relaxed),
+		s_News.load(std::memory_order_relaxed),
+		s_Deletes.load(std::memory_order_relaxed)
+	};
+}
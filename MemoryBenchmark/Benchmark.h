@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+// ----- Benchmark Suites Start -----
+
+void runPoolAllocatorBenchmarks();
+void runThreadCachingAllocatorBenchmarks();
+void runConcurrentPoolAllocatorBenchmarks();
+void runHugePageBenchmarks();
+void runMemoryResourceBenchmarks();
+void runComposableAllocatorBenchmarks();
+void runDispatchBenchmarks();
+void runSlabAllocatorBenchmarks();
+void runBuddyAllocatorBenchmarks();
+void runFrameAllocatorBenchmarks();
+void runScratchArenaBenchmarks();
+void runResizeBenchmarks();
+void runInlineStackAllocatorBenchmarks();
+void runIsolationBenchmarks();
+void runTrackingAllocatorBenchmarks();
+void runWorkloadBenchmarks();
+void runTraceReplayBenchmarks();
+void runSlotMapBenchmarks();
+void runCompactingHeapBenchmarks();
+void runRingAllocatorBenchmarks();
+
+// ----- Benchmark Suites End -----
+
+namespace Benchmark {
+
+	/// <summary>
+	/// Simple wall clock timer used to time a benchmark loop
+	/// </summary>
+	class Timer {
+
+	public:
+		Timer() : m_Start(std::chrono::steady_clock::now()) {}
+
+		inline void reset() { m_Start = std::chrono::steady_clock::now(); }
+
+		inline double elapsedNanoseconds() const {
+			return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_Start).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point m_Start;
+	};
+
+	inline void* volatile g_Sink = nullptr;		// Volatile sink values are written to so the compiler cannot drop them
+
+	/// <summary>
+	/// Keeps the compiler from optimizing away a value that is otherwise unused
+	/// </summary>
+	/// <param name="p">The value that needs to be kept alive</param>
+	inline void doNotOptimize(void* p) { g_Sink = p; }
+
+	/// <summary>
+	/// The amount of calls into the heap since the start of the process, counted by AllocationCounting.cpp
+	/// </summary>
+	struct allocation_counts {
+		size_t mallocs;			// Calls to malloc, calloc, realloc and the aligned allocation functions, including the ones made by operator new
+		size_t frees;			// Calls to free with a block that is not nullptr
+		size_t news;			// Calls to the global operator new
+		size_t deletes;			// Calls to the global operator delete with a block that is not nullptr
+	};
+
+	/// <summary>
+	/// Checks if the heap calls are counted, malloc is only interposed on Linux with glibc
+	/// </summary>
+	bool allocationCountingAvailable();
+
+	/// <summary>
+	/// Gets the amount of calls into the heap since the start of the process, all zero when counting is not available
+	/// </summary>
+	allocation_counts allocationCounts();
+
+	/// <summary>
+	/// Prints the title of a group of benchmark results
+	/// </summary>
+	inline void printHeader(const std::string& title) {
+		std::cout << "\n----- " << title << " -----" << std::endl;
+	}
+
+	/// <summary>
+	/// Prints a single benchmark result as the average time per operation
+	/// </summary>
+	/// <param name="name">The name of the benchmark</param>
+	/// <param name="operations">The amount of operations that were timed</param>
+	/// <param name="nanoseconds">The total time the operations took</param>
+	inline void printResult(const std::string& name, size_t operations, double nanoseconds) {
+		std::cout << std::left << std::setw(48) << name
+			<< std::right << std::setw(10) << std::fixed << std::setprecision(2) << (nanoseconds / operations) << " ns/op"
+			<< std::setw(14) << std::setprecision(1) << (operations / nanoseconds * 1000.0) << " Mops/s" << std::endl;
+	}
+
+	/// <summary>
+	/// Gets the resident set size of the process, the amount of physical memory it currently uses
+	/// Only available on Linux, read from /proc/self/statm
+	/// </summary>
+	/// <returns>The resident set size in bytes, 0 when it is not available</returns>
+	inline size_t currentRSS() {
+#ifdef __linux__
+		std::ifstream file("/proc/self/statm");
+		size_t pages = 0, residentPages = 0;
+		if (!(file >> pages >> residentPages)) return 0;
+		return residentPages * (size_t)sysconf(_SC_PAGESIZE);
+#else
+		return 0;
+#endif
+	}
+
+	/// <summary>
+	/// Resets the peak resident set size of the process to its current resident set size
+	/// Only available on Linux, by writing 5 to /proc/self/clear_refs
+	/// </summary>
+	inline void resetPeakRSS() {
+#ifdef __linux__
+		std::ofstream file("/proc/self/clear_refs");
+		file << "5";
+#endif
+	}
+
+	/// <summary>
+	/// Gets the peak resident set size of the process since the start or since the last resetPeakRSS
+	/// Only available on Linux, read from the VmHWM line of /proc/self/status
+	/// </summary>
+	/// <returns>The peak resident set size in bytes, 0 when it is not available</returns>
+	inline size_t peakRSS() {
+#ifdef __linux__
+		std::ifstream file("/proc/self/status");
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.compare(0, 6, "VmHWM:") == 0) return (size_t)std::stoull(line.substr(6)) * 1024;
+		}
+#endif
+		return 0;
+	}
+}
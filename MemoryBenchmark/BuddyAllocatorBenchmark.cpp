@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+
+#include "JupiterBuddyAllocator.h"
+
+#include <random>
+#include <stdlib.h>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of buffers alive at the same time and the amount of random replacements
+#define BUDDY_BENCHMARK_BUFFERS 256
+#define BUDDY_BENCHMARK_OPERATIONS 1000000
+
+// Power of two buffers between 4KB and 256KB, replaced in random order so blocks are split and merged constantly
+template<typename Allocate, typename Deallocate>
+static void benchmarkBuffers(const std::string& name, Allocate allocate, Deallocate deallocate) {
+	std::mt19937 random(5);
+	std::vector<size_t> sizes(BUDDY_BENCHMARK_OPERATIONS);
+	std::vector<size_t> slots(BUDDY_BENCHMARK_OPERATIONS);
+	for (size_t i = 0; i < BUDDY_BENCHMARK_OPERATIONS; i++) {
+		sizes[i] = (size_t)4096 << (random() % 7);
+		slots[i] = random() % BUDDY_BENCHMARK_BUFFERS;
+	}
+
+	std::vector<void*> buffers(BUDDY_BENCHMARK_BUFFERS, nullptr);
+	std::vector<size_t> bufferSizes(BUDDY_BENCHMARK_BUFFERS, 0);
+
+	Benchmark::Timer timer;
+	for (size_t i = 0; i < BUDDY_BENCHMARK_OPERATIONS; i++) {
+		size_t slot = slots[i];
+		if (buffers[slot] != nullptr) deallocate(buffers[slot], bufferSizes[slot]);
+		buffers[slot] = allocate(sizes[i]);
+		bufferSizes[slot] = sizes[i];
+	}
+	Benchmark::printResult(name, BUDDY_BENCHMARK_OPERATIONS, timer.elapsedNanoseconds());
+
+	for (size_t slot = 0; slot < BUDDY_BENCHMARK_BUFFERS; slot++) {
+		if (buffers[slot] != nullptr) deallocate(buffers[slot], bufferSizes[slot]);
+	}
+}
+
+void runBuddyAllocatorBenchmarks() {
+	Benchmark::printHeader("Buddy allocator, power of two buffers 4KB-256KB, free + allocate");
+
+	// 256 buffers of at most 256KB fit in 64MB, with room for the fragmentation of the buddy system
+	{
+		BuddyAllocator allocator(128 * 1024 * 1024, 4096);
+		benchmarkBuffers("BuddyAllocator",
+			[&](size_t size) { return allocator.allocate(size, 8); },
+			[&](void* p, size_t size) { allocator.deallocate(p, size); });
+	}
+	{
+		BlockAllocator allocator(128 * 1024 * 1024);
+		benchmarkBuffers("BlockAllocator",
+			[&](size_t size) { return allocator.allocate(size, 8); },
+			[&](void* p, size_t size) { allocator.deallocate(p, size); });
+	}
+	{
+		benchmarkBuffers("malloc",
+			[](size_t size) { return malloc(size); },
+			[](void* p, size_t size) { free(p); });
+	}
+}
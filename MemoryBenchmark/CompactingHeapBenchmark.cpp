@@ -0,0 +1,136 @@
+#include "Benchmark.h"
+
+#include "JupiterCompactingHeap.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace Jupiter;
+
+// Amount of live blocks, simulated days and blocks replaced per day
+#define COMPACTING_BENCHMARK_BLOCKS 10000
+#define COMPACTING_BENCHMARK_DAYS 56
+#define COMPACTING_BENCHMARK_REPLACED 5000
+
+// Amount of operations between two defragment ticks and the time budget of a tick
+#define COMPACTING_BENCHMARK_TICK_OPERATIONS 500
+#define COMPACTING_BENCHMARK_TICK_BUDGET std::chrono::microseconds(500)
+
+/// <summary>
+/// The size of a block replaced on a day. The average size stays the same, but on odd days the sizes are either small or large,
+/// so the free blocks left by the even days fit badly and the other way around
+/// </summary>
+static size_t blockSize(std::mt19937& random, uint32 day) {
+	if (day % 2 == 0) return 32 + random() % 2048;
+	return random() % 2 == 0 ? 32 + random() % 64 : 1984 + random() % 128;
+}
+
+/// <summary>
+/// The result of running the simulated days on a compacting heap
+/// </summary>
+struct heap_days {
+	std::vector<size_t> committed;		// The committed memory at the end of every day
+	std::vector<size_t> live;			// The usable bytes of the live blocks at the end of every day
+	double tickNanoseconds = 0;			// The total time of all defragment ticks
+	size_t ticks = 0;					// The amount of defragment ticks
+	size_t movedBytes = 0;				// The bytes moved by all defragment ticks
+};
+
+/// <summary>
+/// Runs the simulated days on a compacting heap, with or without defragment ticks
+/// </summary>
+static heap_days runHeapDays(bool defragment) {
+	CompactingHeap heap((size_t)1024 * 1024 * 1024);
+	std::mt19937 random(21);
+	std::vector<slot_handle> handles(COMPACTING_BENCHMARK_BLOCKS);
+	heap_days result;
+
+	for (slot_handle& handle : handles) {
+		handle = heap.allocate(blockSize(random, 0));
+		memset(heap.pin(handle).get(), 1, heap.sizeOf(handle));
+	}
+
+	Benchmark::Timer timer;
+	for (uint32 day = 0; day < COMPACTING_BENCHMARK_DAYS; day++) {
+		for (uint32 i = 0; i < COMPACTING_BENCHMARK_REPLACED; i++) {
+			slot_handle& handle = handles[random() % handles.size()];
+			heap.free(handle);
+			handle = heap.allocate(blockSize(random, day));
+			memset(heap.pin(handle).get(), 1, heap.sizeOf(handle));
+
+			if (defragment && i % COMPACTING_BENCHMARK_TICK_OPERATIONS == 0) {
+				timer.reset();
+				result.movedBytes += heap.defragment(COMPACTING_BENCHMARK_TICK_BUDGET);
+				result.tickNanoseconds += timer.elapsedNanoseconds();
+				result.ticks++;
+			}
+		}
+		result.committed.push_back(heap.getCommittedSize());
+		result.live.push_back(heap.getUsedMemory());
+	}
+
+	for (slot_handle handle : handles) heap.free(handle);
+	return result;
+}
+
+/// <summary>
+/// Runs the simulated days on malloc
+/// </summary>
+/// <returns>The growth of the resident memory of the process at the end of every day</returns>
+static std::vector<size_t> runMallocDays() {
+#ifdef __GLIBC__
+	malloc_trim(0);
+#endif
+	size_t baseline = Benchmark::currentRSS();
+	std::mt19937 random(21);
+	std::vector<void*> blocks(COMPACTING_BENCHMARK_BLOCKS);
+	std::vector<size_t> resident;
+
+	for (void*& block : blocks) {
+		size_t size = blockSize(random, 0);
+		block = std::malloc(size);
+		memset(block, 1, size);
+	}
+
+	for (uint32 day = 0; day < COMPACTING_BENCHMARK_DAYS; day++) {
+		for (uint32 i = 0; i < COMPACTING_BENCHMARK_REPLACED; i++) {
+			void*& block = blocks[random() % blocks.size()];
+			std::free(block);
+			size_t size = blockSize(random, day);
+			block = std::malloc(size);
+			memset(block, 1, size);
+		}
+		size_t rss = Benchmark::currentRSS();
+		resident.push_back(rss > baseline ? rss - baseline : 0);
+	}
+
+	for (void* block : blocks) std::free(block);
+	return resident;
+}
+
+void runCompactingHeapBenchmarks() {
+	Benchmark::printHeader("Compacting heap, " + std::to_string(COMPACTING_BENCHMARK_BLOCKS) + " live blocks with "
+		+ std::to_string(COMPACTING_BENCHMARK_REPLACED) + " replaced per simulated day");
+
+	heap_days withoutTicks = runHeapDays(false);
+	heap_days withTicks = runHeapDays(true);
+	std::vector<size_t> mallocGrowth = runMallocDays();
+
+	// The memory of the heaps is their committed memory, the memory of malloc is the growth of the resident memory of the process
+	std::cout << std::right << std::setw(6) << "day" << std::setw(12) << "live_kb" << std::setw(16) << "no_defrag_kb"
+		<< std::setw(16) << "defrag_kb" << std::setw(16) << "malloc_rss_kb" << std::endl;
+	for (uint32 day = 0; day < COMPACTING_BENCHMARK_DAYS; day += 7) {
+		std::cout << std::setw(6) << day + 1 << std::setw(12) << withTicks.live[day] / 1024 << std::setw(16) << withoutTicks.committed[day] / 1024
+			<< std::setw(16) << withTicks.committed[day] / 1024 << std::setw(16) << mallocGrowth[day] / 1024 << std::endl;
+	}
+
+	std::cout << std::left << std::setw(48) << "defragment tick"
+		<< std::right << std::setw(10) << std::fixed << std::setprecision(2) << withTicks.tickNanoseconds / withTicks.ticks / 1000.0 << " us/tick"
+		<< std::setw(14) << withTicks.movedBytes / withTicks.ticks / 1024 << " kb moved/tick" << std::endl;
+}
@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+
+#include "JupiterComposableAllocators.h"
+
+#include <stdlib.h>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of blocks alive at the same time and the amount of times they are churned
+#define COMPOSABLE_BENCHMARK_BLOCKS 4096
+#define COMPOSABLE_BENCHMARK_ROUNDS 128
+
+// Pools per 16 byte size class up to 256 bytes, a block heap for everything larger
+typedef Segregator<256, Bucketizer<PoolBucket, 16, 256, 16>, BlockAllocator> SmallObjectAllocator;
+
+// Stack arena that spills over to the system heap
+typedef FallbackAllocator<StackAllocator, MallocAllocator> ArenaAllocator;
+
+// Mostly small sizes with the occasional large one, like a typical object graph
+static std::vector<size_t> makeSizes() {
+	std::vector<size_t> sizes(COMPOSABLE_BENCHMARK_BLOCKS);
+	uint32 state = 0x12345678u;
+	for (size_t i = 0; i < sizes.size(); i++) {
+		state = state * 1664525u + 1013904223u;
+		sizes[i] = (state >> 8) % 16 == 0 ? 512 + (state >> 16) % 2048 : 8 + (state >> 16) % 248;
+	}
+	return sizes;
+}
+
+template<typename Allocator>
+static void benchmarkChurn(const std::string& name, Allocator& allocator, const std::vector<size_t>& sizes) {
+	const size_t operations = (size_t)COMPOSABLE_BENCHMARK_BLOCKS * COMPOSABLE_BENCHMARK_ROUNDS;
+	std::vector<void*> blocks(COMPOSABLE_BENCHMARK_BLOCKS);
+
+	Benchmark::Timer timer;
+	for (size_t round = 0; round < COMPOSABLE_BENCHMARK_ROUNDS; round++) {
+		for (size_t i = 0; i < COMPOSABLE_BENCHMARK_BLOCKS; i++) blocks[i] = allocator.allocate(sizes[i], 8);
+		Benchmark::doNotOptimize(blocks[round % COMPOSABLE_BENCHMARK_BLOCKS]);
+		for (size_t i = 0; i < COMPOSABLE_BENCHMARK_BLOCKS; i++) allocator.deallocate(blocks[i], sizes[i]);
+	}
+	Benchmark::printResult(name, operations, timer.elapsedNanoseconds());
+}
+
+void runComposableAllocatorBenchmarks() {
+	std::vector<size_t> sizes = makeSizes();
+
+	Benchmark::printHeader("Composed allocators, mixed sizes alloc + free");
+	{
+		SmallObjectAllocator allocator(std::piecewise_construct, std::forward_as_tuple(1024, true), std::forward_as_tuple(16 * 1024 * 1024));
+		benchmarkChurn("Segregator<Bucketizer<PoolBucket>, Block>", allocator, sizes);
+	}
+	{
+		BlockAllocator allocator(16 * 1024 * 1024);
+		benchmarkChurn("BlockAllocator", allocator, sizes);
+	}
+	{
+		BlockAllocator block(16 * 1024 * 1024);
+		IAllocator& allocator = block;
+		benchmarkChurn("BlockAllocator through IAllocator&", allocator, sizes);
+	}
+	{
+		MallocAllocator allocator;
+		benchmarkChurn("MallocAllocator", allocator, sizes);
+	}
+
+	Benchmark::printHeader("Composed allocators, stack arena with heap fallback");
+	{
+		// Every round fills the arena past its size, the rest spills over to the heap
+		const size_t operations = (size_t)COMPOSABLE_BENCHMARK_BLOCKS * COMPOSABLE_BENCHMARK_ROUNDS;
+		ArenaAllocator allocator(std::piecewise_construct, std::forward_as_tuple(512 * 1024), std::forward_as_tuple());
+		std::vector<void*> blocks(COMPOSABLE_BENCHMARK_BLOCKS);
+
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < COMPOSABLE_BENCHMARK_ROUNDS; round++) {
+			for (size_t i = 0; i < COMPOSABLE_BENCHMARK_BLOCKS; i++) blocks[i] = allocator.allocate(sizes[i], 8);
+			Benchmark::doNotOptimize(blocks[round % COMPOSABLE_BENCHMARK_BLOCKS]);
+			for (size_t i = 0; i < COMPOSABLE_BENCHMARK_BLOCKS; i++) allocator.deallocate(blocks[i], sizes[i]);
+			allocator.getPrimary().clear();
+		}
+		Benchmark::printResult("FallbackAllocator<Stack, Malloc>", operations, timer.elapsedNanoseconds());
+	}
+	{
+		MallocAllocator allocator;
+		benchmarkChurn("MallocAllocator", allocator, sizes);
+	}
+}
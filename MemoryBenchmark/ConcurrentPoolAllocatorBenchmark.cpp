@@ -0,0 +1,107 @@
+#include "Benchmark.h"
+
+#include "JupiterConcurrentPoolAllocator.h"
+
+#include <barrier>
+#include <mutex>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+using namespace Jupiter;
+
+// The amount of messages every thread keeps alive and the amount of times they are churned
+#define CONTENTION_BENCHMARK_MESSAGES 64
+#define CONTENTION_BENCHMARK_ROUNDS 20000
+
+// Message object allocated by the benchmark threads
+struct BenchmarkMessage {
+	uint64 payload[8];
+};
+
+/// <summary>
+/// Pool allocator guarded by a single mutex, the baseline the lock free pool needs to beat
+/// </summary>
+class LockedPoolAllocator {
+
+public:
+	LockedPoolAllocator() : m_Pool(4096, true) {}
+
+	void* allocate() {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Pool.allocate();
+	}
+
+	void deallocate(void* p) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Pool.deallocate(p);
+	}
+
+private:
+	PoolAllocator<BenchmarkMessage> m_Pool;
+	std::mutex m_Mutex;
+};
+
+/// <summary>
+/// Malloc and free with the same interface as the pools
+/// </summary>
+class MallocMessages {
+
+public:
+	void* allocate() { return malloc(sizeof(BenchmarkMessage)); }
+	void deallocate(void* p) { free(p); }
+};
+
+/// <summary>
+/// Runs a tight alloc/free loop on every thread, all threads hammer the same allocator
+/// </summary>
+template<typename Allocator>
+static double runContention(Allocator& allocator, uint32 threadCount) {
+	std::barrier<> barrier(threadCount + 1);
+	std::vector<std::thread> threads;
+
+	for (uint32 t = 0; t < threadCount; t++) {
+		threads.emplace_back([&]() {
+			void* messages[CONTENTION_BENCHMARK_MESSAGES];
+			barrier.arrive_and_wait();
+			for (uint32 round = 0; round < CONTENTION_BENCHMARK_ROUNDS; round++) {
+				for (uint32 i = 0; i < CONTENTION_BENCHMARK_MESSAGES; i++) messages[i] = allocator.allocate();
+				Benchmark::doNotOptimize(messages[round % CONTENTION_BENCHMARK_MESSAGES]);
+				for (uint32 i = 0; i < CONTENTION_BENCHMARK_MESSAGES; i++) allocator.deallocate(messages[i]);
+			}
+		});
+	}
+
+	barrier.arrive_and_wait();
+	Benchmark::Timer timer;
+	for (std::thread& thread : threads) thread.join();
+	return timer.elapsedNanoseconds();
+}
+
+void runConcurrentPoolAllocatorBenchmarks() {
+	Benchmark::printHeader("Concurrent pool contention, all threads share one pool");
+
+	uint32 maxThreads = std::thread::hardware_concurrency();
+	if (maxThreads == 0) maxThreads = 4;
+
+	for (uint32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+		const size_t operations = (size_t)threadCount * CONTENTION_BENCHMARK_MESSAGES * CONTENTION_BENCHMARK_ROUNDS;
+		std::string suffix = " (" + std::to_string(threadCount) + " threads)";
+
+		{
+			ConcurrentPoolAllocator<BenchmarkMessage> pool(4096, true);
+			Benchmark::printResult("ConcurrentPoolAllocator" + suffix, operations, runContention(pool, threadCount));
+		}
+		{
+			LockedPoolAllocator pool;
+			Benchmark::printResult("Locked PoolAllocator" + suffix, operations, runContention(pool, threadCount));
+		}
+		{
+			MallocMessages messages;
+			Benchmark::printResult("malloc/free" + suffix, operations, runContention(messages, threadCount));
+		}
+
+		// Always include the maximum amount of threads, even if it is not a power of two
+		if (threadCount < maxThreads && threadCount * 2 > maxThreads) threadCount = maxThreads / 2;
+	}
+}
@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+
+#include "JupiterAllocator.h"
+
+#include <vector>
+
+using namespace Jupiter;
+
+// The amount of small blocks allocated before the stack is cleared and the amount of times the stack is filled
+#define DISPATCH_BENCHMARK_ALLOCATIONS 4096
+#define DISPATCH_BENCHMARK_ROUNDS 2048
+
+// Index the type erased allocator is picked with, volatile so the compiler cannot see its dynamic type
+static volatile size_t g_AllocatorIndex = 0;
+
+// Fills the stack through the compile time interface, every allocate call can be inlined
+template<StaticAllocator A>
+static void fillStatic(A& allocator, void** blocks) {
+	for (size_t i = 0; i < DISPATCH_BENCHMARK_ALLOCATIONS; i++) blocks[i] = allocator.allocate(16, 8);
+}
+
+// Fills the stack through the type erased interface, every allocate call goes through the vtable
+static void fillVirtual(IAllocator& allocator, void** blocks) {
+	for (size_t i = 0; i < DISPATCH_BENCHMARK_ALLOCATIONS; i++) blocks[i] = allocator.allocate(16, 8);
+}
+
+void runDispatchBenchmarks() {
+	const size_t operations = (size_t)DISPATCH_BENCHMARK_ALLOCATIONS * DISPATCH_BENCHMARK_ROUNDS;
+	std::vector<void*> blocks(DISPATCH_BENCHMARK_ALLOCATIONS);
+
+	Benchmark::printHeader("Dispatch, StackAllocator allocate(16)");
+	{
+		StackAllocator stack(DISPATCH_BENCHMARK_ALLOCATIONS * 32);
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < DISPATCH_BENCHMARK_ROUNDS; round++) {
+			fillStatic(stack, blocks.data());
+			Benchmark::doNotOptimize(blocks[round % DISPATCH_BENCHMARK_ALLOCATIONS]);
+			stack.clear();
+		}
+		Benchmark::printResult("Static dispatch (StackAllocator&)", operations, timer.elapsedNanoseconds());
+	}
+	{
+		StackAllocator stack(DISPATCH_BENCHMARK_ALLOCATIONS * 32);
+		MallocAllocator heap;
+		IAllocator* allocators[] = { &stack, &heap };
+		IAllocator& allocator = *allocators[g_AllocatorIndex];
+
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < DISPATCH_BENCHMARK_ROUNDS; round++) {
+			fillVirtual(allocator, blocks.data());
+			Benchmark::doNotOptimize(blocks[round % DISPATCH_BENCHMARK_ALLOCATIONS]);
+			stack.clear();
+		}
+		Benchmark::printResult("Virtual dispatch (IAllocator&)", operations, timer.elapsedNanoseconds());
+	}
+	{
+		StackAllocator stack(DISPATCH_BENCHMARK_ALLOCATIONS * 32);
+		AllocatorAdapter<StackAllocator> adapter(stack);
+		MallocAllocator heap;
+		IAllocator* allocators[] = { &adapter, &heap };
+		IAllocator& allocator = *allocators[g_AllocatorIndex];
+
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < DISPATCH_BENCHMARK_ROUNDS; round++) {
+			fillVirtual(allocator, blocks.data());
+			Benchmark::doNotOptimize(blocks[round % DISPATCH_BENCHMARK_ALLOCATIONS]);
+			stack.clear();
+		}
+		Benchmark::printResult("Virtual dispatch (AllocatorAdapter)", operations, timer.elapsedNanoseconds());
+	}
+}
@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+
+#include "JupiterFrameAllocator.h"
+
+#include <random>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of frames simulated and the amount of short lived blocks every frame allocates
+#define FRAME_BENCHMARK_FRAMES 1000
+#define FRAME_BENCHMARK_BLOCKS 2000
+#define FRAME_BENCHMARK_LIFETIME 3
+
+void runFrameAllocatorBenchmarks() {
+	std::mt19937 random(3);
+	std::vector<size_t> sizes(FRAME_BENCHMARK_BLOCKS);
+	for (size_t& size : sizes) size = 16 + random() % 1024;
+
+	Benchmark::printHeader("Frame allocator, 2000 blocks of 16-1040 bytes per frame, living 3 frames");
+
+	{
+		FrameAllocator<FRAME_BENCHMARK_LIFETIME> allocator(4 * 1024 * 1024);
+
+		Benchmark::Timer timer;
+		for (uint32 frame = 0; frame < FRAME_BENCHMARK_FRAMES; frame++) {
+			allocator.beginFrame();
+			for (size_t size : sizes) Benchmark::doNotOptimize(allocator.allocate(size, 16));
+		}
+		Benchmark::printResult("FrameAllocator<3>", (size_t)FRAME_BENCHMARK_FRAMES * FRAME_BENCHMARK_BLOCKS, timer.elapsedNanoseconds());
+		std::cout << "    high watermark " << allocator.getHighWatermark() / 1024 << " KB per frame" << std::endl;
+	}
+	{
+		// Every frame keeps its blocks for the lifetime, then deletes them
+		std::vector<char*> frames[FRAME_BENCHMARK_LIFETIME];
+		for (std::vector<char*>& blocks : frames) blocks.reserve(FRAME_BENCHMARK_BLOCKS);
+
+		Benchmark::Timer timer;
+		for (uint32 frame = 0; frame < FRAME_BENCHMARK_FRAMES; frame++) {
+			std::vector<char*>& blocks = frames[frame % FRAME_BENCHMARK_LIFETIME];
+			for (char* block : blocks) delete[] block;
+			blocks.clear();
+			for (size_t size : sizes) {
+				blocks.push_back(new char[size]);
+				Benchmark::doNotOptimize(blocks.back());
+			}
+		}
+		Benchmark::printResult("new/delete", (size_t)FRAME_BENCHMARK_FRAMES * FRAME_BENCHMARK_BLOCKS, timer.elapsedNanoseconds());
+
+		for (std::vector<char*>& blocks : frames) {
+			for (char* block : blocks) delete[] block;
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+
+#include "JupiterAllocator.h"
+
+#include <stdlib.h>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Jupiter;
+
+// Size of the arena that is accessed at random and the amount of random accesses
+#define HUGE_PAGE_BENCHMARK_ARENA_SIZE ((size_t)512 * 1024 * 1024)
+#define HUGE_PAGE_BENCHMARK_ACCESSES ((size_t)16 * 1024 * 1024)
+
+/// <summary>
+/// Counts the data TLB load misses of the calling thread, only available on Linux when perf events are permitted
+/// </summary>
+class TlbMissCounter {
+
+public:
+	TlbMissCounter() {
+#ifdef __linux__
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		m_Fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+
+	~TlbMissCounter() {
+#ifdef __linux__
+		if (m_Fd >= 0) close(m_Fd);
+#endif
+	}
+
+	inline bool isAvailable() const { return m_Fd >= 0; }
+
+	void start() {
+#ifdef __linux__
+		if (m_Fd < 0) return;
+		ioctl(m_Fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(m_Fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+
+	uint64 stop() {
+		uint64 count = 0;
+#ifdef __linux__
+		if (m_Fd < 0) return 0;
+		ioctl(m_Fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(m_Fd, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+		return count;
+	}
+
+private:
+	int m_Fd = -1;
+};
+
+static const char* pageBackingName(EnumPageBacking backing) {
+	switch (backing) {
+		case EnumPageBacking::TransparentHugePages: return "transparent huge pages";
+		case EnumPageBacking::HugePages: return "huge pages";
+		default: return "normal pages";
+	}
+}
+
+// Touches random cache lines of the arena, every access most likely lands on another page
+static void benchmarkRandomAccess(const std::string& name, StackAllocator& allocator) {
+	uint8* arena = reinterpret_cast<uint8*>(allocator.allocate(HUGE_PAGE_BENCHMARK_ARENA_SIZE, 64));
+	memset(arena, 1, HUGE_PAGE_BENCHMARK_ARENA_SIZE);
+
+	TlbMissCounter counter;
+	uint64 state = 0x9E3779B97F4A7C15ull;
+	uint64 sum = 0;
+
+	Benchmark::Timer timer;
+	counter.start();
+	for (size_t i = 0; i < HUGE_PAGE_BENCHMARK_ACCESSES; i++) {
+		// xorshift, cheap enough to not hide the cost of the access
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		sum += arena[(state % (HUGE_PAGE_BENCHMARK_ARENA_SIZE / 64)) * 64];
+	}
+	uint64 misses = counter.stop();
+	double nanoseconds = timer.elapsedNanoseconds();
+
+	Benchmark::doNotOptimize(reinterpret_cast<void*>(sum));
+	Benchmark::printResult(name + " (" + pageBackingName(allocator.getPageBacking()) + ")", HUGE_PAGE_BENCHMARK_ACCESSES, nanoseconds);
+	std::cout << "    dTLB load misses: ";
+	if (counter.isAvailable()) std::cout << misses << " (" << std::setprecision(3) << (double)misses / HUGE_PAGE_BENCHMARK_ACCESSES << " per access)";
+	else std::cout << "n/a";
+	std::cout << std::endl;
+	allocator.clear();
+}
+
+void runHugePageBenchmarks() {
+	Benchmark::printHeader("Huge pages, random access over a 512MB arena");
+
+	{
+		StackAllocator allocator(HUGE_PAGE_BENCHMARK_ARENA_SIZE + 64, EnumStackBacking::Heap);
+		benchmarkRandomAccess("StackAllocator Heap", allocator);
+	}
+	{
+		StackAllocator allocator(HUGE_PAGE_BENCHMARK_ARENA_SIZE + 64, EnumStackBacking::HugePages);
+		benchmarkRandomAccess("StackAllocator HugePages", allocator);
+	}
+	{
+		StackAllocator allocator(HUGE_PAGE_BENCHMARK_ARENA_SIZE + 64, EnumStackBacking::VirtualHugePages);
+		benchmarkRandomAccess("StackAllocator VirtualHugePages", allocator);
+	}
+}
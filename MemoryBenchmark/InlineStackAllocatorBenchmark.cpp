@@ -0,0 +1,50 @@
+#include "Benchmark.h"
+
+#include "JupiterInlineStackAllocator.h"
+
+#include <cstring>
+#include <stdlib.h>
+
+using namespace Jupiter;
+
+// Amount of calls to a small function that needs a few hundred bytes of temporary space
+#define INLINE_BENCHMARK_CALLS 10000000
+
+// Fills two temporary buffers and combines them, the buffers come from the given allocator
+template<typename A>
+static uint32 combine(A& allocator, uint32 seed) {
+	uint32* a = reinterpret_cast<uint32*>(allocator.allocate(32 * sizeof(uint32), 16));
+	uint32* b = reinterpret_cast<uint32*>(allocator.allocate(32 * sizeof(uint32), 16));
+	for (uint32 i = 0; i < 32; i++) {
+		a[i] = seed + i;
+		b[i] = seed * i;
+	}
+	uint32 result = 0;
+	for (uint32 i = 0; i < 32; i++) result += a[i] ^ b[i];
+	allocator.deallocate(b);
+	allocator.deallocate(a);
+	return result;
+}
+
+void runInlineStackAllocatorBenchmarks() {
+	Benchmark::printHeader("Inline stack allocator, two 128 byte temporary buffers per call");
+
+	MallocAllocator heap;
+	{
+		// One allocator for every call, the buffers of a call are popped when it returns so the buffer never overflows
+		uint32 result = 0;
+		InlineStackAllocator<512> allocator(&heap);
+		Benchmark::Timer timer;
+		for (uint32 i = 0; i < INLINE_BENCHMARK_CALLS; i++) result += combine(allocator, i);
+		Benchmark::printResult("InlineStackAllocator<512>", INLINE_BENCHMARK_CALLS, timer.elapsedNanoseconds());
+		Benchmark::doNotOptimize(reinterpret_cast<void*>((uintptr_t)result));
+		if (allocator.getOverflows() != 0) std::cout << "    overflows: " << allocator.getOverflows() << std::endl;
+	}
+	{
+		uint32 result = 0;
+		Benchmark::Timer timer;
+		for (uint32 i = 0; i < INLINE_BENCHMARK_CALLS; i++) result += combine(heap, i);
+		Benchmark::printResult("MallocAllocator", INLINE_BENCHMARK_CALLS, timer.elapsedNanoseconds());
+		Benchmark::doNotOptimize(reinterpret_cast<void*>((uintptr_t)result));
+	}
+}
@@ -0,0 +1,52 @@
+#include "Benchmark.h"
+
+#include "JupiterAllocator.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of increments every thread does on its own counter
+#define ISOLATION_BENCHMARK_INCREMENTS 10000000
+
+/// <summary>
+/// Every thread increments its own counter, the counters are allocated one after another from the same allocator
+/// </summary>
+template<typename Allocate>
+static void benchmarkCounters(const std::string& name, uint32 threadCount, Allocate allocate) {
+	std::vector<std::atomic<uint64>*> counters;
+	for (uint32 t = 0; t < threadCount; t++) counters.push_back(new (allocate()) std::atomic<uint64>(0));
+
+	Benchmark::Timer timer;
+	std::vector<std::thread> threads;
+	for (uint32 t = 0; t < threadCount; t++) {
+		threads.emplace_back([counter = counters[t]]() {
+			for (uint32 i = 0; i < ISOLATION_BENCHMARK_INCREMENTS; i++) counter->fetch_add(1, std::memory_order_relaxed);
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+	Benchmark::printResult(name, (size_t)threadCount * ISOLATION_BENCHMARK_INCREMENTS, timer.elapsedNanoseconds());
+}
+
+void runIsolationBenchmarks() {
+	uint32 threadCount = std::thread::hardware_concurrency();
+	if (threadCount < 2) threadCount = 2;
+	if (threadCount > 8) threadCount = 8;
+
+	Benchmark::printHeader("Isolated allocations, " + std::to_string(threadCount) + " threads incrementing their own counter");
+
+	{
+		StackAllocator allocator(64 * 1024);
+		benchmarkCounters("StackAllocator packed", threadCount,
+			[&]() { return allocator.allocate(sizeof(std::atomic<uint64>), alignof(std::atomic<uint64>)); });
+		allocator.clear();
+	}
+	{
+		StackAllocator allocator(64 * 1024);
+		benchmarkCounters("StackAllocator isolated", threadCount,
+			[&]() { return Allocator::allocateIsolated(allocator, sizeof(std::atomic<uint64>)); });
+		allocator.clear();
+	}
+}
@@ -0,0 +1,28 @@
+#include "Benchmark.h"
+
+int main() {
+	std::cout << "Running memory benchmarks..." << std::endl;
+
+	runPoolAllocatorBenchmarks();
+	runThreadCachingAllocatorBenchmarks();
+	runConcurrentPoolAllocatorBenchmarks();
+	runHugePageBenchmarks();
+	runMemoryResourceBenchmarks();
+	runComposableAllocatorBenchmarks();
+	runDispatchBenchmarks();
+	runSlabAllocatorBenchmarks();
+	runBuddyAllocatorBenchmarks();
+	runFrameAllocatorBenchmarks();
+	runScratchArenaBenchmarks();
+	runResizeBenchmarks();
+	runInlineStackAllocatorBenchmarks();
+	runIsolationBenchmarks();
+	runTrackingAllocatorBenchmarks();
+	runWorkloadBenchmarks();
+	runTraceReplayBenchmarks();
+	runSlotMapBenchmarks();
+	runCompactingHeapBenchmarks();
+	runRingAllocatorBenchmarks();
+
+	return 0;
+}
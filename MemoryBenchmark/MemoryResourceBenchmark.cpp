@@ -0,0 +1,78 @@
+#include "Benchmark.h"
+
+#include "JupiterMemoryResource.h"
+
+#include <memory_resource>
+#include <set>
+#include <vector>
+
+using namespace Jupiter;
+
+// The amount of elements inserted into every container and the amount of containers built
+#define RESOURCE_BENCHMARK_ELEMENTS 4096
+#define RESOURCE_BENCHMARK_ROUNDS 256
+
+// Builds a vector by pushing back one element at a time, so the buffer is regrown a couple of times
+static void buildVector(std::pmr::memory_resource* resource) {
+	std::pmr::vector<uint32> values(resource);
+	for (uint32 i = 0; i < RESOURCE_BENCHMARK_ELEMENTS; i++) values.push_back(i);
+	Benchmark::doNotOptimize(values.data());
+}
+
+// Builds a set from scattered keys, every insert allocates a node
+static void buildSet(std::pmr::memory_resource* resource) {
+	std::pmr::set<uint32> values(resource);
+	for (uint32 i = 0; i < RESOURCE_BENCHMARK_ELEMENTS; i++) values.insert(i * 2654435761u);
+	Benchmark::doNotOptimize(reinterpret_cast<void*>((uintptr_t)*values.rbegin()));
+}
+
+template<typename Build>
+static void benchmarkContainer(const std::string& container, Build build) {
+	const size_t operations = (size_t)RESOURCE_BENCHMARK_ELEMENTS * RESOURCE_BENCHMARK_ROUNDS;
+
+	// Default resource, new and delete
+	{
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < RESOURCE_BENCHMARK_ROUNDS; round++) build(std::pmr::new_delete_resource());
+		Benchmark::printResult(container + " default resource", operations, timer.elapsedNanoseconds());
+	}
+
+	// Stack allocator, deallocations are ignored and the stack is cleared after every container
+	{
+		StackAllocator allocator(16 * 1024 * 1024);
+		JupiterMemoryResource resource(allocator);
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < RESOURCE_BENCHMARK_ROUNDS; round++) {
+			build(&resource);
+			allocator.clear();
+		}
+		Benchmark::printResult(container + " StackAllocator", operations, timer.elapsedNanoseconds());
+	}
+
+	// Standard monotonic buffer over the same amount of memory, the reference for a monotonic resource
+	{
+		std::vector<uint8> buffer(16 * 1024 * 1024);
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < RESOURCE_BENCHMARK_ROUNDS; round++) {
+			std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+			build(&resource);
+		}
+		Benchmark::printResult(container + " monotonic_buffer_resource", operations, timer.elapsedNanoseconds());
+	}
+
+	// Block allocator, deallocations are passed on sized
+	{
+		BlockAllocator allocator(16 * 1024 * 1024);
+		JupiterMemoryResource resource(allocator);
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < RESOURCE_BENCHMARK_ROUNDS; round++) build(&resource);
+		Benchmark::printResult(container + " BlockAllocator", operations, timer.elapsedNanoseconds());
+	}
+}
+
+void runMemoryResourceBenchmarks() {
+	Benchmark::printHeader("pmr containers, time per inserted element");
+
+	benchmarkContainer("pmr::vector<uint32>", buildVector);
+	benchmarkContainer("pmr::set<uint32>", buildSet);
+}
@@ -0,0 +1,71 @@
+#include "Benchmark.h"
+
+#include "JupiterAllocator.h"
+
+#include <stdlib.h>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of objects alive at the same time and the amount of times they are churned
+#define POOL_BENCHMARK_OBJECTS 4096
+#define POOL_BENCHMARK_ROUNDS 256
+
+// Object with a configurable size, used to benchmark the pool for different sizeof(T) values
+template<size_t Size>
+struct PoolPayload {
+	uint8 data[Size];
+};
+
+template<size_t Size>
+static void benchmarkPayload() {
+	const size_t operations = (size_t)POOL_BENCHMARK_OBJECTS * POOL_BENCHMARK_ROUNDS;
+	std::vector<void*> objects(POOL_BENCHMARK_OBJECTS);
+	std::string suffix = " (sizeof(T) = " + std::to_string(Size) + ")";
+
+	// Pool allocator, a single slab big enough for all objects
+	{
+		PoolAllocator<PoolPayload<Size>> pool(POOL_BENCHMARK_OBJECTS, false);
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < POOL_BENCHMARK_ROUNDS; round++) {
+			for (size_t i = 0; i < POOL_BENCHMARK_OBJECTS; i++) objects[i] = pool.allocate(sizeof(PoolPayload<Size>), alignof(PoolPayload<Size>));
+			Benchmark::doNotOptimize(objects[round % POOL_BENCHMARK_OBJECTS]);
+			for (size_t i = 0; i < POOL_BENCHMARK_OBJECTS; i++) pool.deallocate(objects[i]);
+		}
+		Benchmark::printResult("PoolAllocator" + suffix, operations, timer.elapsedNanoseconds());
+	}
+
+	// Malloc and free
+	{
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < POOL_BENCHMARK_ROUNDS; round++) {
+			for (size_t i = 0; i < POOL_BENCHMARK_OBJECTS; i++) objects[i] = malloc(sizeof(PoolPayload<Size>));
+			Benchmark::doNotOptimize(objects[round % POOL_BENCHMARK_OBJECTS]);
+			for (size_t i = 0; i < POOL_BENCHMARK_OBJECTS; i++) free(objects[i]);
+		}
+		Benchmark::printResult("malloc/free" + suffix, operations, timer.elapsedNanoseconds());
+	}
+
+	// New and delete
+	{
+		Benchmark::Timer timer;
+		for (size_t round = 0; round < POOL_BENCHMARK_ROUNDS; round++) {
+			for (size_t i = 0; i < POOL_BENCHMARK_OBJECTS; i++) objects[i] = new PoolPayload<Size>;
+			Benchmark::doNotOptimize(objects[round % POOL_BENCHMARK_OBJECTS]);
+			for (size_t i = 0; i < POOL_BENCHMARK_OBJECTS; i++) delete reinterpret_cast<PoolPayload<Size>*>(objects[i]);
+		}
+		Benchmark::printResult("new/delete" + suffix, operations, timer.elapsedNanoseconds());
+	}
+}
+
+void runPoolAllocatorBenchmarks() {
+	Benchmark::printHeader("PoolAllocator vs malloc/new, allocate then deallocate");
+
+	benchmarkPayload<8>();
+	benchmarkPayload<16>();
+	benchmarkPayload<32>();
+	benchmarkPayload<64>();
+	benchmarkPayload<128>();
+	benchmarkPayload<256>();
+	benchmarkPayload<1024>();
+}
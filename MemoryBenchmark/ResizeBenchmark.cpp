@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+
+#include "JupiterAllocator.h"
+
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of lists built and the amount of elements appended to every list
+#define RESIZE_BENCHMARK_LISTS 2000
+#define RESIZE_BENCHMARK_ELEMENTS 4096
+
+/// <summary>
+/// Builds lists by appending one element at a time, the capacity doubles through reallocate when the list is full
+/// </summary>
+template<typename A>
+static void benchmarkAppend(const std::string& name, A& allocator, bool interleave) {
+	Benchmark::Timer timer;
+	for (uint32 list = 0; list < RESIZE_BENCHMARK_LISTS; list++) {
+		size_t capacity = 16;
+		uint32* elements = reinterpret_cast<uint32*>(allocator.allocate(capacity * sizeof(uint32), 4));
+		for (uint32 i = 0; i < RESIZE_BENCHMARK_ELEMENTS; i++) {
+			if (i == capacity) {
+				// An allocation in between leaves the list below the top, so every growth has to copy
+				if (interleave) allocator.allocate(4, 4);
+				elements = reinterpret_cast<uint32*>(allocator.reallocate(elements, capacity * sizeof(uint32), capacity * 2 * sizeof(uint32), 4));
+				capacity *= 2;
+			}
+			elements[i] = i;
+		}
+		Benchmark::doNotOptimize(elements);
+		if constexpr (requires { allocator.clear(); }) allocator.clear();
+		else allocator.deallocate(elements);
+	}
+	Benchmark::printResult(name, (size_t)RESIZE_BENCHMARK_LISTS * RESIZE_BENCHMARK_ELEMENTS, timer.elapsedNanoseconds());
+}
+
+void runResizeBenchmarks() {
+	Benchmark::printHeader("Resize, appending 4096 elements one at a time with doubling capacity");
+
+	{
+		StackAllocator allocator(1024 * 1024);
+		benchmarkAppend("StackAllocator grow in place", allocator, false);
+		benchmarkAppend("StackAllocator copy", allocator, true);
+	}
+	{
+		BlockAllocator allocator(1024 * 1024);
+		benchmarkAppend("BlockAllocator", allocator, false);
+	}
+	{
+		MallocAllocator allocator;
+		benchmarkAppend("MallocAllocator (realloc)", allocator, false);
+	}
+	{
+		Benchmark::Timer timer;
+		for (uint32 list = 0; list < RESIZE_BENCHMARK_LISTS; list++) {
+			std::vector<uint32> elements;
+			elements.reserve(16);
+			for (uint32 i = 0; i < RESIZE_BENCHMARK_ELEMENTS; i++) elements.push_back(i);
+			Benchmark::doNotOptimize(elements.data());
+		}
+		Benchmark::printResult("std::vector", (size_t)RESIZE_BENCHMARK_LISTS * RESIZE_BENCHMARK_ELEMENTS, timer.elapsedNanoseconds());
+	}
+}
@@ -0,0 +1,157 @@
+#include "Benchmark.h"
+
+#include "JupiterRingAllocator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace Jupiter;
+
+// Amount of messages, the amount of messages in flight in the single threaded benchmark and the size of the rings
+#define RING_BENCHMARK_MESSAGES 2000000
+#define RING_BENCHMARK_IN_FLIGHT 64
+#define RING_BENCHMARK_CAPACITY (256 * 1024)
+
+// Message sizes between 16 and 256 bytes, a mix of small events and larger payloads
+static inline size_t messageSize(uint32 i) {
+	return 16 + (i * 2654435761u >> 24);
+}
+
+/// <summary>
+/// Message queue from the producer to the consumer guarded by a mutex, the messages are allocated with malloc
+/// </summary>
+class LockedMallocQueue {
+
+public:
+	void send(void* p, size_t size) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Messages.push_back({ p, size });
+	}
+
+	void* receive(size_t& size) {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Messages.empty()) return nullptr;
+		void* p = m_Messages.front().first;
+		size = m_Messages.front().second;
+		m_Messages.pop_front();
+		return p;
+	}
+
+private:
+	std::mutex m_Mutex;
+	std::deque<std::pair<void*, size_t>> m_Messages;
+};
+
+/// <summary>
+/// Sends every message from a producer thread to the calling thread through the ring
+/// </summary>
+static double runRingPipeline(SpscRingAllocator& ring) {
+	Benchmark::Timer timer;
+	std::thread producer([&ring]() {
+		for (uint32 i = 0; i < RING_BENCHMARK_MESSAGES; i++) {
+			size_t size = messageSize(i);
+			void* p;
+			while ((p = ring.tryAllocate(size)) == nullptr) {
+				ring.publish();
+				std::this_thread::yield();
+			}
+			memset(p, (int)i, size);
+			ring.publish();
+		}
+	});
+
+	for (uint32 received = 0; received < RING_BENCHMARK_MESSAGES;) {
+		size_t size;
+		void* p = ring.receive(size);
+		if (p == nullptr) {
+			std::this_thread::yield();
+			continue;
+		}
+		Benchmark::doNotOptimize(p);
+		ring.deallocate(p);
+		received++;
+	}
+	producer.join();
+	return timer.elapsedNanoseconds();
+}
+
+/// <summary>
+/// Sends every message from a producer thread to the calling thread through the locked queue
+/// </summary>
+static double runLockedPipeline(LockedMallocQueue& queue) {
+	Benchmark::Timer timer;
+	std::thread producer([&queue]() {
+		for (uint32 i = 0; i < RING_BENCHMARK_MESSAGES; i++) {
+			size_t size = messageSize(i);
+			void* p = malloc(size);
+			memset(p, (int)i, size);
+			queue.send(p, size);
+		}
+	});
+
+	for (uint32 received = 0; received < RING_BENCHMARK_MESSAGES;) {
+		size_t size;
+		void* p = queue.receive(size);
+		if (p == nullptr) {
+			std::this_thread::yield();
+			continue;
+		}
+		Benchmark::doNotOptimize(p);
+		free(p);
+		received++;
+	}
+	producer.join();
+	return timer.elapsedNanoseconds();
+}
+
+void runRingAllocatorBenchmarks() {
+	Benchmark::printHeader("Ring allocator, FIFO messages of 16 to 256 bytes");
+
+	// Single thread, a fixed amount of messages in flight with the oldest one freed for every new one
+	{
+		RingAllocator ring(RING_BENCHMARK_CAPACITY);
+		void* inFlight[RING_BENCHMARK_IN_FLIGHT];
+		for (uint32 i = 0; i < RING_BENCHMARK_IN_FLIGHT; i++) inFlight[i] = ring.allocate(messageSize(i));
+
+		Benchmark::Timer timer;
+		for (uint32 i = RING_BENCHMARK_IN_FLIGHT; i < RING_BENCHMARK_MESSAGES; i++) {
+			ring.deallocate(inFlight[i % RING_BENCHMARK_IN_FLIGHT]);
+			inFlight[i % RING_BENCHMARK_IN_FLIGHT] = ring.allocate(messageSize(i));
+		}
+		Benchmark::printResult("RingAllocator FIFO", RING_BENCHMARK_MESSAGES - RING_BENCHMARK_IN_FLIGHT, timer.elapsedNanoseconds());
+		for (void* p : inFlight) ring.deallocate(p);
+	}
+	{
+		void* inFlight[RING_BENCHMARK_IN_FLIGHT];
+		for (uint32 i = 0; i < RING_BENCHMARK_IN_FLIGHT; i++) inFlight[i] = malloc(messageSize(i));
+
+		Benchmark::Timer timer;
+		for (uint32 i = RING_BENCHMARK_IN_FLIGHT; i < RING_BENCHMARK_MESSAGES; i++) {
+			free(inFlight[i % RING_BENCHMARK_IN_FLIGHT]);
+			inFlight[i % RING_BENCHMARK_IN_FLIGHT] = malloc(messageSize(i));
+			Benchmark::doNotOptimize(inFlight[i % RING_BENCHMARK_IN_FLIGHT]);
+		}
+		Benchmark::printResult("malloc FIFO", RING_BENCHMARK_MESSAGES - RING_BENCHMARK_IN_FLIGHT, timer.elapsedNanoseconds());
+		for (void* p : inFlight) free(p);
+	}
+
+	// A producer thread and a consumer thread, the heap calls made during the run show the ring never touches the heap.
+	// Starting the producer thread is the only heap call
+	{
+		SpscRingAllocator ring(RING_BENCHMARK_CAPACITY);
+		Benchmark::allocation_counts before = Benchmark::allocationCounts();
+		double nanoseconds = runRingPipeline(ring);
+		Benchmark::allocation_counts after = Benchmark::allocationCounts();
+		Benchmark::printResult("SpscRingAllocator producer to consumer", RING_BENCHMARK_MESSAGES, nanoseconds);
+		if (Benchmark::allocationCountingAvailable()) {
+			std::cout << "    heap calls during the run: " << after.mallocs - before.mallocs << " mallocs, " << after.frees - before.frees << " frees" << std::endl;
+		}
+	}
+	{
+		LockedMallocQueue queue;
+		Benchmark::printResult("malloc and locked queue producer to consumer", RING_BENCHMARK_MESSAGES, runLockedPipeline(queue));
+	}
+}
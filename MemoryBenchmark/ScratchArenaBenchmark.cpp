@@ -0,0 +1,40 @@
+#include "Benchmark.h"
+
+#include "JupiterScratchArena.h"
+
+#include <cstring>
+#include <stdlib.h>
+
+using namespace Jupiter;
+
+// Amount of calls to a function that needs a temporary buffer
+#define SCRATCH_BENCHMARK_CALLS 2000000
+
+void runScratchArenaBenchmarks() {
+	Benchmark::printHeader("Scratch arena, temporary buffer of 64-4096 bytes per call");
+
+	{
+		StackAllocator& arena = scratch_arena::get();
+
+		Benchmark::Timer timer;
+		for (size_t i = 0; i < SCRATCH_BENCHMARK_CALLS; i++) {
+			ScratchScope scope(arena);
+			size_t size = 64 + (i & 63) * 64;
+			void* buffer = scope.allocate(size, 16);
+			memset(buffer, (int)i, 64);
+			Benchmark::doNotOptimize(buffer);
+		}
+		Benchmark::printResult("ScratchScope", SCRATCH_BENCHMARK_CALLS, timer.elapsedNanoseconds());
+	}
+	{
+		Benchmark::Timer timer;
+		for (size_t i = 0; i < SCRATCH_BENCHMARK_CALLS; i++) {
+			size_t size = 64 + (i & 63) * 64;
+			void* buffer = malloc(size);
+			memset(buffer, (int)i, 64);
+			Benchmark::doNotOptimize(buffer);
+			free(buffer);
+		}
+		Benchmark::printResult("malloc/free", SCRATCH_BENCHMARK_CALLS, timer.elapsedNanoseconds());
+	}
+}
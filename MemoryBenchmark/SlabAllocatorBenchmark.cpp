@@ -0,0 +1,116 @@
+#include "Benchmark.h"
+
+#include "JupiterSlabAllocator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdlib.h>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of blocks allocated in the first phase, the amount freed in the second and the amount allocated in the third
+#define SLAB_BENCHMARK_BLOCKS 1000000
+#define SLAB_BENCHMARK_FREED 750000
+#define SLAB_BENCHMARK_REFILL 500000
+
+/// <summary>
+/// The sizes and free order of the mixed size workload, generated up front so both allocators see the same workload
+/// </summary>
+struct MixedWorkload {
+	std::vector<size_t> sizes;			// Sizes of the blocks of the first phase
+	std::vector<size_t> freeOrder;		// Indices of the blocks freed in the second phase
+	std::vector<size_t> refillSizes;	// Sizes of the blocks of the third phase
+
+	MixedWorkload() : sizes(SLAB_BENCHMARK_BLOCKS), freeOrder(SLAB_BENCHMARK_BLOCKS), refillSizes(SLAB_BENCHMARK_REFILL) {
+		std::mt19937 random(1234);
+
+		// Mostly small strings and nodes, some larger callbacks and buffers
+		for (size_t& size : sizes) {
+			uint32 pick = random() % 100;
+			if (pick < 70) size = 8 + random() % 57;
+			else if (pick < 95) size = 65 + random() % 192;
+			else size = 257 + random() % 256;
+		}
+		for (size_t i = 0; i < freeOrder.size(); i++) freeOrder[i] = i;
+		std::shuffle(freeOrder.begin(), freeOrder.end(), random);
+		freeOrder.resize(SLAB_BENCHMARK_FREED);
+
+		// The refill uses a different distribution, so freed slots of one size do not simply fit the new blocks
+		for (size_t& size : refillSizes) size = 8 + random() % 505;
+	}
+};
+
+/// <summary>
+/// Runs the mixed size workload in three phases and prints the time and the resident memory after every phase.
+/// The overhead is the resident memory divided by the bytes requested by the live blocks
+/// </summary>
+template<typename Allocate, typename Deallocate>
+static void benchmarkWorkload(const std::string& name, const MixedWorkload& workload, Allocate allocate, Deallocate deallocate) {
+	std::vector<void*> blocks(SLAB_BENCHMARK_BLOCKS);
+	std::vector<void*> refill(SLAB_BENCHMARK_REFILL);
+	size_t live = 0;
+
+	size_t baseline = Benchmark::currentRSS();
+	auto report = [&](const std::string& phase, size_t operations, double nanoseconds) {
+		size_t rss = Benchmark::currentRSS() - baseline;
+		Benchmark::printResult(name + " " + phase, operations, nanoseconds);
+		std::cout << "    live " << std::setw(8) << live / 1024 << " KB, resident " << std::setw(8) << rss / 1024 << " KB, overhead "
+			<< std::setprecision(2) << (live != 0 ? (double)rss / live : 0.0) << "x" << std::endl;
+	};
+
+	Benchmark::Timer timer;
+	for (size_t i = 0; i < SLAB_BENCHMARK_BLOCKS; i++) {
+		blocks[i] = allocate(workload.sizes[i]);
+		live += workload.sizes[i];
+	}
+	double nanoseconds = timer.elapsedNanoseconds();
+
+	// Write every block like a real program would, memory that is never touched is never made resident
+	for (size_t i = 0; i < SLAB_BENCHMARK_BLOCKS; i++) memset(blocks[i], 0xAB, workload.sizes[i]);
+	report("allocate", SLAB_BENCHMARK_BLOCKS, nanoseconds);
+
+	timer.reset();
+	for (size_t index : workload.freeOrder) {
+		deallocate(blocks[index], workload.sizes[index]);
+		live -= workload.sizes[index];
+		blocks[index] = nullptr;
+	}
+	report("free 75%", SLAB_BENCHMARK_FREED, timer.elapsedNanoseconds());
+
+	timer.reset();
+	for (size_t i = 0; i < SLAB_BENCHMARK_REFILL; i++) {
+		refill[i] = allocate(workload.refillSizes[i]);
+		live += workload.refillSizes[i];
+	}
+	nanoseconds = timer.elapsedNanoseconds();
+
+	for (size_t i = 0; i < SLAB_BENCHMARK_REFILL; i++) memset(refill[i], 0xAB, workload.refillSizes[i]);
+	report("refill", SLAB_BENCHMARK_REFILL, nanoseconds);
+
+	for (size_t i = 0; i < SLAB_BENCHMARK_BLOCKS; i++) {
+		if (blocks[i] != nullptr) deallocate(blocks[i], workload.sizes[i]);
+	}
+	for (size_t i = 0; i < SLAB_BENCHMARK_REFILL; i++) deallocate(refill[i], workload.refillSizes[i]);
+}
+
+void runSlabAllocatorBenchmarks() {
+	MixedWorkload workload;
+
+	Benchmark::printHeader("Slab allocator, mixed sizes 8-512 bytes, time and resident memory");
+	if (Benchmark::currentRSS() == 0) std::cout << "Resident memory is not available on this platform" << std::endl;
+
+	// The slab allocator runs first, it returns its slabs to the system on destruction while malloc may keep its heap
+	{
+		SlabAllocator allocator;
+		benchmarkWorkload("SlabAllocator", workload,
+			[&](size_t size) { return allocator.allocate(size); },
+			[&](void* p, size_t size) { allocator.deallocate(p, size); });
+	}
+	{
+		benchmarkWorkload("malloc", workload,
+			[](size_t size) { return malloc(size); },
+			[](void* p, size_t size) { free(p); });
+	}
+}
@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+
+#include "JupiterSlotMap.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of objects in the table and the amount of times all objects are updated
+#define SLOTMAP_BENCHMARK_OBJECTS 100000
+#define SLOTMAP_BENCHMARK_PASSES 100
+
+// Typical small entity component, a transform with a velocity
+struct BenchmarkTransform {
+	float position[3];
+	float velocity[3];
+	uint32 flags;
+	uint32 padding;
+};
+
+static inline void updateTransform(BenchmarkTransform& transform) {
+	for (uint32 i = 0; i < 3; i++) transform.position[i] += transform.velocity[i] * 0.016f;
+}
+
+void runSlotMapBenchmarks() {
+	Benchmark::printHeader("Slot map, updating " + std::to_string(SLOTMAP_BENCHMARK_OBJECTS) + " objects per pass");
+	const size_t operations = (size_t)SLOTMAP_BENCHMARK_OBJECTS * SLOTMAP_BENCHMARK_PASSES;
+	std::mt19937 random(3);
+
+	// Objects allocated one by one and reached through pointers, after a while of churn the pointers are in no particular order
+	{
+		std::vector<BenchmarkTransform*> objects(SLOTMAP_BENCHMARK_OBJECTS);
+		for (BenchmarkTransform*& object : objects) object = new BenchmarkTransform{ { 0, 0, 0 }, { 1, 1, 1 }, 0, 0 };
+		std::shuffle(objects.begin(), objects.end(), random);
+
+		Benchmark::Timer timer;
+		for (uint32 pass = 0; pass < SLOTMAP_BENCHMARK_PASSES; pass++) {
+			for (BenchmarkTransform* object : objects) updateTransform(*object);
+		}
+		Benchmark::printResult("pointers to heap objects", operations, timer.elapsedNanoseconds());
+		Benchmark::doNotOptimize(objects[0]);
+
+		for (BenchmarkTransform* object : objects) delete object;
+	}
+
+	// The same objects in a slot map, with the same churn behind them, are a single linear walk
+	{
+		MallocAllocator heap;
+		SlotMap<BenchmarkTransform> map(heap, SLOTMAP_BENCHMARK_OBJECTS);
+		std::vector<slot_handle> handles(SLOTMAP_BENCHMARK_OBJECTS);
+		for (slot_handle& handle : handles) handle = map.insert({ { 0, 0, 0 }, { 1, 1, 1 }, 0, 0 });
+		for (uint32 i = 0; i < SLOTMAP_BENCHMARK_OBJECTS; i++) {
+			size_t index = random() % handles.size();
+			map.erase(handles[index]);
+			handles[index] = map.insert({ { 0, 0, 0 }, { 1, 1, 1 }, 0, 0 });
+		}
+
+		Benchmark::Timer timer;
+		for (uint32 pass = 0; pass < SLOTMAP_BENCHMARK_PASSES; pass++) {
+			for (BenchmarkTransform& object : map) updateTransform(object);
+		}
+		Benchmark::printResult("SlotMap dense iteration", operations, timer.elapsedNanoseconds());
+
+		// Lookups through handles in random order, every lookup checks the generation
+		std::shuffle(handles.begin(), handles.end(), random);
+		timer.reset();
+		for (uint32 pass = 0; pass < SLOTMAP_BENCHMARK_PASSES; pass++) {
+			for (slot_handle handle : handles) updateTransform(*map.get(handle));
+		}
+		Benchmark::printResult("SlotMap lookup by handle", operations, timer.elapsedNanoseconds());
+		Benchmark::doNotOptimize(map.data());
+
+		timer.reset();
+		for (uint32 i = 0; i < operations / 2; i++) {
+			size_t index = i % handles.size();
+			map.erase(handles[index]);
+			handles[index] = map.insert({ { 0, 0, 0 }, { 1, 1, 1 }, 0, 0 });
+		}
+		Benchmark::printResult("SlotMap erase and insert", operations, timer.elapsedNanoseconds());
+	}
+}
@@ -0,0 +1,120 @@
+#include "Benchmark.h"
+
+#include "JupiterThreadCachingAllocator.h"
+
+#include <barrier>
+#include <mutex>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+using namespace Jupiter;
+
+// The amount of blocks every thread keeps alive and the amount of times they are churned
+#define THREAD_BENCHMARK_BLOCKS 256
+#define THREAD_BENCHMARK_ROUNDS 2000
+
+/// <summary>
+/// Block allocator guarded by a single mutex, the baseline a thread caching front-end needs to beat
+/// </summary>
+class LockedBlockAllocator : public IAllocator {
+
+public:
+	LockedBlockAllocator(size_t size) : m_Allocator(size) {}
+
+	virtual void* allocate(size_t size, size_t allignment = 4) override {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		return m_Allocator.allocate(size, allignment);
+	}
+
+	virtual void deallocate(void* p) override {
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Allocator.deallocate(p);
+	}
+
+	virtual void deallocate(void* p, size_t size) override { deallocate(p); }
+
+private:
+	BlockAllocator m_Allocator;
+	std::mutex m_Mutex;
+};
+
+/// <summary>
+/// IAllocator wrapper around malloc and free
+/// </summary>
+class MallocBaseline : public IAllocator {
+
+public:
+	virtual void* allocate(size_t size, size_t allignment = 4) override { return malloc(size); }
+	virtual void deallocate(void* p) override { free(p); }
+	virtual void deallocate(void* p, size_t size) override { free(p); }
+};
+
+/// <summary>
+/// Runs the alloc/free workload on a number of threads and returns the total time it took.
+/// When remote is set every thread frees the blocks allocated by its neighbour each round
+/// </summary>
+static double runWorkload(IAllocator& allocator, uint32 threadCount, bool remote) {
+	std::vector<std::vector<void*>> blocks(threadCount, std::vector<void*>(THREAD_BENCHMARK_BLOCKS));
+	std::barrier<> barrier(threadCount + 1);
+	std::vector<std::thread> threads;
+
+	for (uint32 t = 0; t < threadCount; t++) {
+		threads.emplace_back([&, t]() {
+			barrier.arrive_and_wait();
+			uint32 victim = remote ? (t + 1) % threadCount : t;
+			for (uint32 round = 0; round < THREAD_BENCHMARK_ROUNDS; round++) {
+				for (uint32 i = 0; i < THREAD_BENCHMARK_BLOCKS; i++) blocks[t][i] = allocator.allocate(16 + ((i * 7 + round) % 32) * 16);
+				if (remote) barrier.arrive_and_wait();
+				for (uint32 i = 0; i < THREAD_BENCHMARK_BLOCKS; i++) allocator.deallocate(blocks[victim][i]);
+				if (remote) barrier.arrive_and_wait();
+			}
+		});
+	}
+
+	// The main thread takes part in the barriers so it can start the timer once every thread is ready
+	barrier.arrive_and_wait();
+	Benchmark::Timer timer;
+	if (remote) {
+		for (uint32 round = 0; round < THREAD_BENCHMARK_ROUNDS; round++) {
+			barrier.arrive_and_wait();
+			barrier.arrive_and_wait();
+		}
+	}
+	for (std::thread& thread : threads) thread.join();
+	return timer.elapsedNanoseconds();
+}
+
+static void benchmarkScaling(bool remote) {
+	uint32 maxThreads = std::thread::hardware_concurrency();
+	if (maxThreads == 0) maxThreads = 4;
+
+	Benchmark::printHeader(remote ? "Thread scaling, blocks freed by a neighbouring thread" : "Thread scaling, blocks freed by the allocating thread");
+
+	for (uint32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+		const size_t operations = (size_t)threadCount * THREAD_BENCHMARK_BLOCKS * THREAD_BENCHMARK_ROUNDS;
+		std::string suffix = " (" + std::to_string(threadCount) + " threads)";
+
+		{
+			BlockAllocator backend(256 * 1024 * 1024);
+			ThreadCachingAllocator allocator(backend);
+			Benchmark::printResult("ThreadCachingAllocator" + suffix, operations, runWorkload(allocator, threadCount, remote));
+		}
+		{
+			LockedBlockAllocator allocator(256 * 1024 * 1024);
+			Benchmark::printResult("Locked BlockAllocator" + suffix, operations, runWorkload(allocator, threadCount, remote));
+		}
+		{
+			MallocBaseline allocator;
+			Benchmark::printResult("malloc/free" + suffix, operations, runWorkload(allocator, threadCount, remote));
+		}
+
+		// Always include the maximum amount of threads, even if it is not a power of two
+		if (threadCount < maxThreads && threadCount * 2 > maxThreads) threadCount = maxThreads / 2;
+	}
+}
+
+void runThreadCachingAllocatorBenchmarks() {
+	benchmarkScaling(false);
+	benchmarkScaling(true);
+}
@@ -0,0 +1,145 @@
+#include "Benchmark.h"
+
+#include "JupiterAllocationTrace.h"
+#include "JupiterAllocatorExceptions.h"
+#include "JupiterBuddyAllocator.h"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace Jupiter;
+
+// Amount of simulated frames in the built in trace
+#define TRACE_BENCHMARK_FRAMES 2000
+
+/// <summary>
+/// Records the built in trace, used when no trace file is given.
+/// Every frame allocates short lived strings, some buffers that live for a couple of frames and grows a long lived array
+/// </summary>
+static std::vector<uint8> recordBuiltInTrace() {
+	MallocAllocator heap;
+	TraceRecorder recorder(heap);
+	std::mt19937 random(77);
+
+	struct buffer { void* p; size_t size; uint32 freeFrame; };
+	std::vector<buffer> buffers;
+	void* array = nullptr;
+	size_t arraySize = 0;
+
+	for (uint32 frame = 0; frame < TRACE_BENCHMARK_FRAMES; frame++) {
+		std::vector<std::pair<void*, size_t>> strings;
+		for (uint32 i = 0; i < 200; i++) {
+			size_t size = 16 + random() % 113;
+			strings.push_back({ recorder.allocate(size, 8), size });
+		}
+
+		for (uint32 i = 0; i < 10; i++) {
+			size_t size = 1024 + random() % (63 * 1024);
+			buffers.push_back({ recorder.allocate(size, 16), size, frame + 1 + (uint32)(random() % 60) });
+		}
+
+		if (frame % 100 == 0) {
+			size_t newSize = arraySize == 0 ? 4096 : arraySize * 2;
+			if (newSize <= 8 * 1024 * 1024) {
+				array = recorder.reallocate(array, arraySize, newSize, 16);
+				arraySize = newSize;
+			}
+		}
+
+		for (size_t i = strings.size(); i-- > 0;) recorder.deallocate(strings[i].first, strings[i].second);
+		for (size_t i = 0; i < buffers.size();) {
+			if (buffers[i].freeFrame != frame) {
+				i++;
+				continue;
+			}
+			recorder.deallocate(buffers[i].p, buffers[i].size);
+			buffers[i] = buffers.back();
+			buffers.pop_back();
+		}
+	}
+
+	for (buffer& block : buffers) recorder.deallocate(block.p, block.size);
+	recorder.deallocate(array, arraySize);
+	return recorder.getData();
+}
+
+/// <summary>
+/// Replays the trace against an allocator and prints a row of the result table.
+/// The growth of the peak resident memory divided by the peak requested bytes includes the free memory between blocks
+/// </summary>
+static void replayTrace(const char* name, const std::vector<trace_event>& events, IAllocator& allocator) {
+#ifdef __GLIBC__
+	// Hand the memory freed by earlier replays back to the system, so it does not hide the growth of this replay
+	malloc_trim(0);
+#endif
+	Benchmark::resetPeakRSS();
+	size_t baseline = Benchmark::currentRSS();
+
+	allocation_trace::replay_result result = allocation_trace::replay(events, allocator);
+	size_t peak = Benchmark::peakRSS();
+	size_t growth = peak > baseline ? peak - baseline : 0;
+
+	std::cout << std::left << std::setw(16) << name
+		<< std::right << std::setw(12) << result.operations
+		<< std::setw(10) << std::fixed << std::setprecision(2) << result.nanoseconds / result.operations
+		<< std::setw(8) << result.failedAllocations
+		<< std::setw(14) << result.peakRequestedBytes / 1024;
+
+	// An allocator without statistics has no peak of its own, eg. malloc
+	if (allocator.getStats() != nullptr) {
+		std::cout << std::setw(14) << result.peakAllocatorBytes / 1024 << std::setw(10) << std::setprecision(3) << result.getFragmentation();
+	}
+	else {
+		std::cout << std::setw(14) << "n/a" << std::setw(10) << "n/a";
+	}
+
+	std::cout << std::setw(12) << growth / 1024
+		<< std::setw(10) << std::setprecision(2) << (result.peakRequestedBytes != 0 ? (double)growth / result.peakRequestedBytes : 0.0) << std::endl;
+}
+
+void runTraceReplayBenchmarks() {
+	// A trace recorded by a TraceRecorder in another program is replayed when its path is given
+	std::vector<trace_event> events;
+	const char* path = std::getenv("JUPITER_TRACE");
+	if (path != nullptr) {
+		Benchmark::printHeader(std::string("Trace replay of ") + path);
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			std::cout << "Could not open the trace, the replay is skipped" << std::endl;
+			return;
+		}
+		try {
+			events = allocation_trace::read(file);
+		}
+		catch (const jpt_bad_trace& e) {
+			std::cout << e.what() << " The replay is skipped" << std::endl;
+			return;
+		}
+	}
+	else {
+		events = allocation_trace::decode(recordBuiltInTrace());
+		Benchmark::printHeader("Trace replay of the built in trace, set JUPITER_TRACE to replay a recorded trace");
+	}
+
+	std::cout << std::left << std::setw(16) << "allocator"
+		<< std::right << std::setw(12) << "operations" << std::setw(10) << "ns/op" << std::setw(8) << "failed"
+		<< std::setw(14) << "requested_kb" << std::setw(14) << "allocator_kb" << std::setw(10) << "frag" << std::setw(12) << "peak_rss_kb" << std::setw(10) << "rss/req" << std::endl;
+
+	{
+		BlockAllocator allocator((size_t)512 * 1024 * 1024);
+		replayTrace("BlockAllocator", events, allocator);
+	}
+	{
+		BuddyAllocator allocator((size_t)512 * 1024 * 1024, 16);
+		replayTrace("BuddyAllocator", events, allocator);
+	}
+	{
+		MallocAllocator allocator;
+		replayTrace("malloc", events, allocator);
+	}
+}
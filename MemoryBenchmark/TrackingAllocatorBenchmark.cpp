@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+
+#include "JupiterTrackingAllocator.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace Jupiter;
+
+// Amount of blocks allocated and freed in every round, and the amount of rounds
+#define TRACKING_BENCHMARK_BLOCKS 100000
+#define TRACKING_BENCHMARK_ROUNDS 10
+
+/// <summary>
+/// Allocates the blocks and frees them in a random order, the same order for every allocator
+/// </summary>
+static void benchmarkAllocator(const std::string& name, IAllocator& allocator, const std::vector<size_t>& freeOrder) {
+	std::vector<void*> blocks(TRACKING_BENCHMARK_BLOCKS);
+
+	Benchmark::Timer timer;
+	for (uint32 round = 0; round < TRACKING_BENCHMARK_ROUNDS; round++) {
+		for (size_t i = 0; i < TRACKING_BENCHMARK_BLOCKS; i++) blocks[i] = allocator.allocate(16 + (i & 127), 8);
+		for (size_t index : freeOrder) allocator.deallocate(blocks[index]);
+	}
+	Benchmark::printResult(name, (size_t)TRACKING_BENCHMARK_BLOCKS * TRACKING_BENCHMARK_ROUNDS * 2, timer.elapsedNanoseconds());
+}
+
+void runTrackingAllocatorBenchmarks() {
+	std::vector<size_t> freeOrder(TRACKING_BENCHMARK_BLOCKS);
+	for (size_t i = 0; i < freeOrder.size(); i++) freeOrder[i] = i;
+	std::shuffle(freeOrder.begin(), freeOrder.end(), std::mt19937(42));
+
+	Benchmark::printHeader("Tracking allocator, allocate and free in random order");
+
+	{
+		MallocAllocator allocator;
+		benchmarkAllocator("MallocAllocator", allocator, freeOrder);
+	}
+	{
+		MallocAllocator heap;
+		TrackingAllocator allocator(heap, TRACKING_BENCHMARK_BLOCKS);
+		benchmarkAllocator("TrackingAllocator over MallocAllocator", allocator, freeOrder);
+	}
+	{
+		BlockAllocator allocator(64 * 1024 * 1024);
+		benchmarkAllocator("BlockAllocator", allocator, freeOrder);
+	}
+	{
+		BlockAllocator block(64 * 1024 * 1024);
+		TrackingAllocator allocator(block, TRACKING_BENCHMARK_BLOCKS);
+		benchmarkAllocator("TrackingAllocator over BlockAllocator", allocator, freeOrder);
+	}
+}
@@ -0,0 +1,333 @@
+#include "Benchmark.h"
+
+#include "JupiterAllocator.h"
+#include "JupiterBuddyAllocator.h"
+#include "JupiterSlabAllocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdlib.h>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace Jupiter;
+
+// Amount of blocks alive at the peak of the small size workloads and of the mixed size workload, and the amount of rounds
+#define WORKLOAD_BENCHMARK_BLOCKS 100000
+#define WORKLOAD_BENCHMARK_MIXED_BLOCKS 20000
+#define WORKLOAD_BENCHMARK_ROUNDS 10
+
+// Amount of blocks in flight between the producer and the consumer
+#define WORKLOAD_BENCHMARK_QUEUE 1024
+
+// Largest block of the small size workloads and of the mixed size workload
+#define WORKLOAD_BENCHMARK_SMALL_SIZE 256
+#define WORKLOAD_BENCHMARK_MIXED_SIZE (16 * 1024)
+
+/// <summary>
+/// The standard workloads, every allocator runs the workloads its deallocation pattern supports
+/// </summary>
+enum EnumWorkload : uint32 {
+	WorkloadLifo = 1 << 0,					// Allocate a batch, free it in reverse order
+	WorkloadRandomFree = 1 << 1,			// Allocate a batch, free it in random order
+	WorkloadProducerConsumer = 1 << 2,		// Blocks are freed in the order they were allocated, a fixed amount is in flight
+	WorkloadFixedChurn = 1 << 3,			// Free a random block of a fixed size and allocate a new one
+	WorkloadMixedSizes = 1 << 4,			// Free a random block and allocate a new one of a random size, from tiny to large
+
+	WorkloadsSmall = WorkloadLifo | WorkloadRandomFree | WorkloadProducerConsumer | WorkloadFixedChurn,
+	WorkloadsAll = WorkloadsSmall | WorkloadMixedSizes
+};
+
+/// <summary>
+/// The sizes and orders of all workloads, generated up front so every allocator sees the same workload
+/// </summary>
+struct StandardWorkloads {
+	std::vector<size_t> sizes;				// Sizes of the small size workloads, 16 to 256 bytes
+	std::vector<size_t> freeOrder;			// The order the random free workload frees the blocks in
+	std::vector<size_t> churn;				// The block replaced in every step of the churn workloads
+	std::vector<size_t> mixedSizes;			// Sizes of the mixed size workload, log uniform from 8 bytes to 16KB
+
+	StandardWorkloads() :
+		sizes(WORKLOAD_BENCHMARK_BLOCKS), freeOrder(WORKLOAD_BENCHMARK_BLOCKS),
+		churn((size_t)WORKLOAD_BENCHMARK_BLOCKS * WORKLOAD_BENCHMARK_ROUNDS), mixedSizes((size_t)WORKLOAD_BENCHMARK_BLOCKS * WORKLOAD_BENCHMARK_ROUNDS)
+	{
+		std::mt19937 random(2024);
+		for (size_t& size : sizes) size = 16 + random() % (WORKLOAD_BENCHMARK_SMALL_SIZE - 15);
+		for (size_t i = 0; i < freeOrder.size(); i++) freeOrder[i] = i;
+		std::shuffle(freeOrder.begin(), freeOrder.end(), random);
+		for (size_t& index : churn) index = random() % WORKLOAD_BENCHMARK_BLOCKS;
+
+		// Small blocks are far more common than large ones, every power of two range is picked equally often
+		std::uniform_real_distribution<double> exponent(3.0, std::log2(WORKLOAD_BENCHMARK_MIXED_SIZE));
+		for (size_t& size : mixedSizes) size = (size_t)std::exp2(exponent(random));
+	}
+};
+
+/// <summary>
+/// Result of a single workload against a single allocator
+/// </summary>
+struct WorkloadResult {
+	size_t operations = 0;					// The amount of allocations and deallocations
+	double nanoseconds = 0.0;				// The time all operations took
+	size_t peakRSS = 0;						// The growth of the resident memory at the peak of the workload
+};
+
+/// <summary>
+/// Measures a workload, the resident memory is sampled by the workload at the moment the most blocks are alive
+/// </summary>
+class WorkloadRun {
+
+public:
+	WorkloadRun() : m_Baseline(0) {
+#ifdef __GLIBC__
+		// Hand the memory freed by earlier runs back to the system, otherwise malloc reuses pages that are already resident
+		malloc_trim(0);
+#endif
+		m_Baseline = Benchmark::currentRSS();
+	}
+
+	// Blocks are written once so their pages count towards the resident memory
+	inline void touch(void* p) { *reinterpret_cast<volatile uint8*>(p) = 1; }
+
+	inline void samplePeak() {
+		size_t rss = Benchmark::currentRSS();
+		if (rss > m_Baseline && rss - m_Baseline > m_Result.peakRSS) m_Result.peakRSS = rss - m_Baseline;
+	}
+
+	inline void finish(size_t operations, double nanoseconds) {
+		m_Result.operations = operations;
+		m_Result.nanoseconds = nanoseconds;
+	}
+
+	inline const WorkloadResult& getResult() const { return m_Result; }
+
+private:
+	size_t m_Baseline;
+	WorkloadResult m_Result;
+};
+
+template<typename Subject>
+static void runLifo(Subject& subject, const StandardWorkloads& workloads, WorkloadRun& run) {
+	std::vector<void*> blocks(WORKLOAD_BENCHMARK_BLOCKS);
+	double nanoseconds = 0.0;
+
+	for (uint32 round = 0; round < WORKLOAD_BENCHMARK_ROUNDS; round++) {
+		Benchmark::Timer timer;
+		for (size_t i = 0; i < blocks.size(); i++) blocks[i] = subject.allocate(workloads.sizes[i]);
+		nanoseconds += timer.elapsedNanoseconds();
+
+		if (round == 0) {
+			for (void* p : blocks) run.touch(p);
+			run.samplePeak();
+		}
+
+		timer.reset();
+		for (size_t i = blocks.size(); i-- > 0;) subject.deallocate(blocks[i], workloads.sizes[i]);
+		nanoseconds += timer.elapsedNanoseconds();
+	}
+	run.finish((size_t)WORKLOAD_BENCHMARK_BLOCKS * WORKLOAD_BENCHMARK_ROUNDS * 2, nanoseconds);
+}
+
+template<typename Subject>
+static void runRandomFree(Subject& subject, const StandardWorkloads& workloads, WorkloadRun& run) {
+	std::vector<void*> blocks(WORKLOAD_BENCHMARK_BLOCKS);
+	double nanoseconds = 0.0;
+
+	for (uint32 round = 0; round < WORKLOAD_BENCHMARK_ROUNDS; round++) {
+		Benchmark::Timer timer;
+		for (size_t i = 0; i < blocks.size(); i++) blocks[i] = subject.allocate(workloads.sizes[i]);
+		nanoseconds += timer.elapsedNanoseconds();
+
+		if (round == 0) {
+			for (void* p : blocks) run.touch(p);
+			run.samplePeak();
+		}
+
+		timer.reset();
+		for (size_t index : workloads.freeOrder) subject.deallocate(blocks[index], workloads.sizes[index]);
+		nanoseconds += timer.elapsedNanoseconds();
+	}
+	run.finish((size_t)WORKLOAD_BENCHMARK_BLOCKS * WORKLOAD_BENCHMARK_ROUNDS * 2, nanoseconds);
+}
+
+template<typename Subject>
+static void runProducerConsumer(Subject& subject, const StandardWorkloads& workloads, WorkloadRun& run) {
+	// The queue is a ring, the consumer frees the oldest block right before the producer puts a new one in its place
+	std::vector<void*> queue(WORKLOAD_BENCHMARK_QUEUE);
+	std::vector<size_t> queueSizes(WORKLOAD_BENCHMARK_QUEUE);
+	size_t steps = (size_t)WORKLOAD_BENCHMARK_BLOCKS * WORKLOAD_BENCHMARK_ROUNDS;
+
+	Benchmark::Timer timer;
+	for (size_t i = 0; i < steps; i++) {
+		size_t slot = i % WORKLOAD_BENCHMARK_QUEUE;
+		if (i >= WORKLOAD_BENCHMARK_QUEUE) subject.deallocate(queue[slot], queueSizes[slot]);
+		queueSizes[slot] = workloads.sizes[i % WORKLOAD_BENCHMARK_BLOCKS];
+		queue[slot] = subject.allocate(queueSizes[slot]);
+		run.touch(queue[slot]);
+	}
+	for (size_t slot = 0; slot < WORKLOAD_BENCHMARK_QUEUE; slot++) subject.deallocate(queue[slot], queueSizes[slot]);
+	double nanoseconds = timer.elapsedNanoseconds();
+
+	run.samplePeak();
+	run.finish(steps * 2, nanoseconds);
+}
+
+template<typename Subject>
+static void runChurn(Subject& subject, const StandardWorkloads& workloads, WorkloadRun& run, bool mixed) {
+	size_t count = mixed ? WORKLOAD_BENCHMARK_MIXED_BLOCKS : WORKLOAD_BENCHMARK_BLOCKS;
+	std::vector<void*> blocks(count);
+	std::vector<size_t> sizes(count, 64);
+	if (mixed) std::copy(workloads.mixedSizes.begin(), workloads.mixedSizes.begin() + count, sizes.begin());
+
+	for (size_t i = 0; i < count; i++) {
+		blocks[i] = subject.allocate(sizes[i]);
+		run.touch(blocks[i]);
+	}
+	run.samplePeak();
+
+	Benchmark::Timer timer;
+	for (size_t i = 0; i < workloads.churn.size(); i++) {
+		size_t index = workloads.churn[i] % count;
+		subject.deallocate(blocks[index], sizes[index]);
+		if (mixed) sizes[index] = workloads.mixedSizes[i];
+		blocks[index] = subject.allocate(sizes[index]);
+	}
+	double nanoseconds = timer.elapsedNanoseconds();
+
+	for (size_t i = 0; i < count; i++) subject.deallocate(blocks[i], sizes[i]);
+	run.samplePeak();
+	run.finish(workloads.churn.size() * 2, nanoseconds);
+}
+
+// ----- Subjects Start -----
+// Every subject is created fresh for every workload, the calls go straight to the concrete allocator so they can be inlined
+
+struct StackSubject {
+	static constexpr uint32 Workloads = WorkloadLifo;
+	StackAllocator allocator{ (size_t)64 * 1024 * 1024 };
+
+	// The state of the stack before a block is kept on the stack right in front of the block, popping the block restores it
+	inline void* allocate(size_t size) {
+		StackAllocator::stack_state state = allocator.getState();
+		new (allocator.allocate(sizeof(StackAllocator::stack_state), 8)) StackAllocator::stack_state(state);
+		return allocator.allocate(size, 8);
+	}
+	inline void deallocate(void* p, size_t size) {
+		allocator.restore(*reinterpret_cast<StackAllocator::stack_state*>(pointer_functions::shift_back(p, sizeof(StackAllocator::stack_state))));
+	}
+};
+
+struct PoolSubject {
+	struct slot { uint8 data[WORKLOAD_BENCHMARK_SMALL_SIZE]; };
+
+	static constexpr uint32 Workloads = WorkloadsSmall;
+	PoolAllocator<slot> allocator{ 4096 };
+
+	inline void* allocate(size_t size) { return allocator.allocate(size, 8); }
+	inline void deallocate(void* p, size_t size) { allocator.deallocate(p); }
+};
+
+struct SlabSubject {
+	static constexpr uint32 Workloads = WorkloadsSmall;
+	SlabAllocator allocator;
+
+	inline void* allocate(size_t size) { return allocator.allocate(size, 8); }
+	inline void deallocate(void* p, size_t size) { allocator.deallocate(p, size); }
+};
+
+struct BlockSubject {
+	static constexpr uint32 Workloads = WorkloadsAll;
+	BlockAllocator allocator{ (size_t)256 * 1024 * 1024 };
+
+	inline void* allocate(size_t size) { return allocator.allocate(size, 8); }
+	inline void deallocate(void* p, size_t size) { allocator.deallocate(p, size); }
+};
+
+struct BuddySubject {
+	static constexpr uint32 Workloads = WorkloadsAll;
+	BuddyAllocator allocator{ (size_t)256 * 1024 * 1024, 16 };
+
+	inline void* allocate(size_t size) { return allocator.allocate(size, 8); }
+	inline void deallocate(void* p, size_t size) { allocator.deallocate(p, size); }
+};
+
+struct MallocSubject {
+	static constexpr uint32 Workloads = WorkloadsAll;
+
+	inline void* allocate(size_t size) {
+		void* p = malloc(size);
+		if (p == nullptr) throw std::bad_alloc();
+		return p;
+	}
+	inline void deallocate(void* p, size_t size) { free(p); }
+};
+
+// ----- Subjects End -----
+
+/// <summary>
+/// Prints the column names of the result table, the table has one row per workload and allocator.
+/// The names never contain spaces, so every row splits into the same columns, eg. with awk, to compare releases
+/// </summary>
+static void printTableHeader() {
+	std::cout << std::left << std::setw(20) << "workload" << std::setw(16) << "allocator"
+		<< std::right << std::setw(12) << "operations" << std::setw(10) << "ns/op" << std::setw(12) << "mallocs"
+		<< std::setw(12) << "frees" << std::setw(10) << "news" << std::setw(12) << "peak_rss_kb" << std::endl;
+}
+
+static void printTableRow(const char* workload, const char* allocator, const WorkloadResult& result,
+	const Benchmark::allocation_counts& before, const Benchmark::allocation_counts& after) {
+	std::cout << std::left << std::setw(20) << workload << std::setw(16) << allocator
+		<< std::right << std::setw(12) << result.operations
+		<< std::setw(10) << std::fixed << std::setprecision(2) << result.nanoseconds / result.operations
+		<< std::setw(12) << after.mallocs - before.mallocs << std::setw(12) << after.frees - before.frees
+		<< std::setw(10) << after.news - before.news << std::setw(12) << result.peakRSS / 1024 << std::endl;
+}
+
+/// <summary>
+/// Runs every workload the subject supports, the heap calls are counted from creating the subject until it is destroyed
+/// </summary>
+template<typename Subject>
+static void runSubject(const char* name, const StandardWorkloads& workloads) {
+	auto runWorkload = [&](EnumWorkload workload, const char* workloadName, auto body) {
+		if ((Subject::Workloads & workload) == 0) return;
+
+		WorkloadRun run;
+		Benchmark::allocation_counts before = Benchmark::allocationCounts();
+		{
+			std::unique_ptr<Subject> subject = std::make_unique<Subject>();
+			body(*subject, run);
+		}
+		Benchmark::allocation_counts after = Benchmark::allocationCounts();
+		printTableRow(workloadName, name, run.getResult(), before, after);
+	};
+
+	runWorkload(WorkloadLifo, "lifo", [&](Subject& subject, WorkloadRun& run) { runLifo(subject, workloads, run); });
+	runWorkload(WorkloadRandomFree, "random_free", [&](Subject& subject, WorkloadRun& run) { runRandomFree(subject, workloads, run); });
+	runWorkload(WorkloadProducerConsumer, "producer_consumer", [&](Subject& subject, WorkloadRun& run) { runProducerConsumer(subject, workloads, run); });
+	runWorkload(WorkloadFixedChurn, "fixed_churn", [&](Subject& subject, WorkloadRun& run) { runChurn(subject, workloads, run, false); });
+	runWorkload(WorkloadMixedSizes, "mixed_sizes", [&](Subject& subject, WorkloadRun& run) { runChurn(subject, workloads, run, true); });
+}
+
+void runWorkloadBenchmarks() {
+	StandardWorkloads workloads;
+
+	Benchmark::printHeader("Standard workloads, time, heap calls and peak resident memory per workload and allocator");
+	if (!Benchmark::allocationCountingAvailable()) std::cout << "Heap calls are only counted on Linux with glibc" << std::endl;
+	if (Benchmark::currentRSS() == 0) std::cout << "Resident memory is not available on this platform" << std::endl;
+
+	std::cout << "StackAllocator pops a block by restoring a " << sizeof(StackAllocator::stack_state) << " byte state kept in front of it, saving the state is part of every allocation" << std::endl;
+
+	printTableHeader();
+	runSubject<StackSubject>("StackAllocator", workloads);
+	runSubject<PoolSubject>("PoolAllocator", workloads);
+	runSubject<SlabSubject>("SlabAllocator", workloads);
+	runSubject<BlockSubject>("BlockAllocator", workloads);
+	runSubject<BuddySubject>("BuddyAllocator", workloads);
+	runSubject<MallocSubject>("malloc", workloads);
+}
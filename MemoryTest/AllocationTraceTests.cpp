@@ -0,0 +1,118 @@
+#include "pch.h"
+
+#include "JupiterAllocationTrace.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace Jupiter;
+
+TEST(AllocationTraceTests, RoundTrip) {
+	MallocAllocator heap;
+	TraceRecorder recorder(heap);
+
+	void* p0 = recorder.allocate(100, 8);
+	void* p1 = recorder.allocate(5000, 64);
+	recorder.deallocate(p0);
+	void* p2 = recorder.reallocate(p1, 5000, 10000, 64);
+	recorder.deallocate(p2, 10000);
+	EXPECT_EQ(5, recorder.getEventCount());
+
+	std::vector<trace_event> events = allocation_trace::decode(recorder.getData());
+	ASSERT_EQ(5, events.size());
+
+	EXPECT_EQ(EnumTraceOp::Allocate, events[0].op);
+	EXPECT_EQ(0, events[0].block);
+	EXPECT_EQ(100, events[0].size);
+	EXPECT_EQ(8, events[0].allignment);
+
+	EXPECT_EQ(EnumTraceOp::Allocate, events[1].op);
+	EXPECT_EQ(1, events[1].block);
+	EXPECT_EQ(64, events[1].allignment);
+
+	EXPECT_EQ(EnumTraceOp::Deallocate, events[2].op);
+	EXPECT_EQ(0, events[2].block);
+
+	// The resized block gets the next id
+	EXPECT_EQ(EnumTraceOp::Reallocate, events[3].op);
+	EXPECT_EQ(1, events[3].block);
+	EXPECT_EQ(10000, events[3].size);
+
+	EXPECT_EQ(EnumTraceOp::Deallocate, events[4].op);
+	EXPECT_EQ(2, events[4].block);
+
+	// Every event of a single thread fits in a handful of bytes, apart from the time delta
+	for (const trace_event& event : events) EXPECT_EQ(events[0].thread, event.thread);
+
+	// Writing and reading gives the same trace
+	std::stringstream stream;
+	recorder.write(stream);
+	EXPECT_EQ(events.size(), allocation_trace::read(stream).size());
+}
+
+TEST(AllocationTraceTests, Threads) {
+	MallocAllocator heap;
+	TraceRecorder recorder(heap);
+
+	void* p = recorder.allocate(16);
+	std::thread thread([&]() { recorder.deallocate(p); });
+	thread.join();
+
+	std::vector<trace_event> events = allocation_trace::decode(recorder.getData());
+	ASSERT_EQ(2, events.size());
+	EXPECT_NE(events[0].thread, events[1].thread);
+	EXPECT_EQ(0, events[1].block);
+}
+
+TEST(AllocationTraceTests, BadTrace) {
+	std::vector<uint8> data = { 'J', 'T', 'R', 'X', TraceRecorder::Version };
+	EXPECT_THROW(allocation_trace::decode(data), jpt_bad_trace);
+
+	data = { 'J', 'T', 'R', 'C', TraceRecorder::Version + 1 };
+	EXPECT_THROW(allocation_trace::decode(data), jpt_bad_trace);
+
+	// A deallocation of a block that was never allocated
+	data = { 'J', 'T', 'R', 'C', TraceRecorder::Version, (uint8)EnumTraceOp::Deallocate, 0, 0, 0 };
+	EXPECT_THROW(allocation_trace::decode(data), jpt_bad_trace);
+
+	// An allocation without its size
+	data = { 'J', 'T', 'R', 'C', TraceRecorder::Version, (uint8)EnumTraceOp::Allocate, 0, 0 };
+	EXPECT_THROW(allocation_trace::decode(data), jpt_bad_trace);
+
+	data = { 'J', 'T', 'R', 'C', TraceRecorder::Version };
+	EXPECT_TRUE(allocation_trace::decode(data).empty());
+}
+
+TEST(AllocationTraceTests, Replay) {
+	MallocAllocator heap;
+	TraceRecorder recorder(heap);
+
+	// Blocks that are never freed in the trace are freed by the replay
+	std::vector<void*> blocks;
+	for (uint32 i = 0; i < 100; i++) blocks.push_back(recorder.allocate(64 + i, 16));
+	for (uint32 i = 0; i < 100; i += 2) recorder.deallocate(blocks[i]);
+	blocks[1] = recorder.reallocate(blocks[1], 65, 4000, 16);
+	std::vector<trace_event> events = allocation_trace::decode(recorder.getData());
+	for (uint32 i = 1; i < 100; i += 2) recorder.deallocate(blocks[i]);
+
+	BlockAllocator allocator(1024 * 1024);
+	allocation_trace::replay_result result = allocation_trace::replay(events, allocator);
+	EXPECT_EQ(events.size(), result.operations);
+	EXPECT_EQ(0, result.failedAllocations);
+	EXPECT_EQ(0, allocator.getAllocations());
+
+	size_t requested = 0;
+	for (uint32 i = 0; i < 100; i++) requested += 64 + i;
+	EXPECT_EQ(requested, result.peakRequestedBytes);
+	if (AllocatorStats::Enabled) {
+		EXPECT_GE(result.peakAllocatorBytes, result.peakRequestedBytes);
+		EXPECT_GE(result.getFragmentation(), 0.0);
+		EXPECT_LT(result.getFragmentation(), 1.0);
+	}
+
+	// Allocations that do not fit are counted and the events on their blocks are skipped
+	BlockAllocator small(4096);
+	result = allocation_trace::replay(events, small);
+	EXPECT_NE(0, result.failedAllocations);
+	EXPECT_EQ(0, small.getAllocations());
+}
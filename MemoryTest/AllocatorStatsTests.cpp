@@ -0,0 +1,158 @@
+#include "pch.h"
+
+#include "JupiterAllocator.h"
+#include "JupiterBuddyAllocator.h"
+#include "JupiterSlabAllocator.h"
+
+#include <string>
+
+using namespace Jupiter;
+
+namespace {
+
+	struct leak_record {
+		std::string allocator;
+		size_t allocations = 0;
+		size_t bytes = 0;
+	};
+
+	leak_record s_LastLeak;
+
+	void record_leak(const char* allocator, size_t allocations, size_t bytes) {
+		s_LastLeak = { allocator, allocations, bytes };
+	}
+}
+
+TEST(AllocatorStatsTests, Histogram) {
+	EXPECT_EQ(0, AllocatorStats::histogramBucket(0));
+	EXPECT_EQ(1, AllocatorStats::histogramBucket(1));
+	EXPECT_EQ(4, AllocatorStats::histogramBucket(8));
+	EXPECT_EQ(4, AllocatorStats::histogramBucket(15));
+	EXPECT_EQ(5, AllocatorStats::histogramBucket(16));
+	EXPECT_EQ(AllocatorStats::HistogramBuckets - 1, AllocatorStats::histogramBucket((size_t)1 << 40));
+}
+
+TEST(AllocatorStatsTests, StackAllocator) {
+	if (!AllocatorStats::Enabled) GTEST_SKIP();
+
+	StackAllocator allocator(1024);
+	const AllocatorStats* stats = allocator.getStats();
+	ASSERT_NE(nullptr, stats);
+
+	// The second allocation is padded up to its alignment, the padding is counted as waste
+	StackAllocator::stack_state state = allocator.getState();
+	allocator.allocate(10, 1);
+	allocator.allocate(16, 16);
+	EXPECT_EQ(allocator.getUsedMemory(), stats->getCurrentBytes());
+	EXPECT_EQ(2, stats->getCurrentAllocations());
+	EXPECT_EQ(allocator.getUsedMemory() - 26, stats->getAlignmentWaste());
+	EXPECT_EQ(1, stats->getHistogram(AllocatorStats::histogramBucket(10)));
+	EXPECT_EQ(1, stats->getHistogram(AllocatorStats::histogramBucket(16)));
+
+	// Rewinding keeps the peaks
+	size_t peak = stats->getCurrentBytes();
+	allocator.restore(state);
+	EXPECT_EQ(0, stats->getCurrentBytes());
+	EXPECT_EQ(0, stats->getCurrentAllocations());
+	EXPECT_EQ(peak, stats->getPeakBytes());
+	EXPECT_EQ(2, stats->getPeakAllocations());
+	EXPECT_EQ(2, stats->getTotalAllocations());
+
+	EXPECT_EQ(nullptr, allocator.tryAllocate(2048));
+	EXPECT_THROW(allocator.allocate(2048), std::bad_alloc);
+	EXPECT_EQ(2, stats->getFailedAllocations());
+
+	allocator.resetStats();
+	EXPECT_EQ(0, stats->getPeakBytes());
+	EXPECT_EQ(0, stats->getTotalAllocations());
+	EXPECT_EQ(0, stats->getFailedAllocations());
+}
+
+TEST(AllocatorStatsTests, BlockAllocator) {
+	if (!AllocatorStats::Enabled) GTEST_SKIP();
+
+	BlockAllocator allocator(64 * 1024);
+	const AllocatorStats* stats = allocator.getStats();
+
+	void* p0 = allocator.allocate(100);
+	void* p1 = allocator.allocate(1000);
+	EXPECT_EQ(allocator.getUsedMemory(), stats->getCurrentBytes());
+	EXPECT_EQ(2, stats->getCurrentAllocations());
+
+	// Resizing in place moves the current bytes with the block
+	if (allocator.tryResize(p1, 4000)) {
+		EXPECT_EQ(allocator.getUsedMemory(), stats->getCurrentBytes());
+	}
+
+	size_t peak = stats->getCurrentBytes();
+	allocator.deallocate(p0);
+	allocator.deallocate(p1);
+	EXPECT_EQ(0, stats->getCurrentBytes());
+	EXPECT_EQ(0, stats->getCurrentAllocations());
+	EXPECT_EQ(peak, stats->getPeakBytes());
+}
+
+TEST(AllocatorStatsTests, PoolAndSlab) {
+	if (!AllocatorStats::Enabled) GTEST_SKIP();
+
+	struct node { uint64 key; uint64 value; };
+	PoolAllocator<node> pool;
+	void* slot = pool.allocate(12);
+	EXPECT_EQ(16, pool.getStats()->getCurrentBytes());
+	EXPECT_EQ(4, pool.getStats()->getAlignmentWaste());
+	pool.deallocate(slot);
+	EXPECT_EQ(0, pool.getStats()->getCurrentBytes());
+
+	SlabAllocator slab;
+	void* p = slab.allocate(20);
+	EXPECT_EQ(24, slab.getStats()->getCurrentBytes());
+	EXPECT_EQ(nullptr, slab.tryAllocate(SlabAllocator::MaxSize + 1));
+	EXPECT_EQ(1, slab.getStats()->getFailedAllocations());
+	slab.deallocate(p);
+	EXPECT_EQ(0, slab.getStats()->getCurrentAllocations());
+}
+
+TEST(AllocatorStatsTests, Interface) {
+	BuddyAllocator buddy(64 * 1024, 1024);
+	MallocAllocator malloc;
+
+	// Allocators without statistics return nullptr through the common interface
+	IAllocator* allocators[] = { &buddy, &malloc };
+	EXPECT_NE(nullptr, allocators[0]->getStats());
+	EXPECT_EQ(nullptr, allocators[1]->getStats());
+
+	void* p = allocators[0]->allocate(3000);
+	if (AllocatorStats::Enabled) {
+		EXPECT_EQ(4096, allocators[0]->getStats()->getCurrentBytes());
+		EXPECT_EQ(4096 - 3000, allocators[0]->getStats()->getAlignmentWaste());
+	}
+	else {
+		EXPECT_EQ(0, allocators[0]->getStats()->getCurrentBytes());
+	}
+	allocators[0]->deallocate(p);
+}
+
+TEST(AllocatorStatsTests, LeakHandler) {
+	if (!AllocatorStats::Enabled) GTEST_SKIP();
+
+	allocator_stats::leak_handler previous = allocator_stats::setLeakHandler(record_leak);
+	s_LastLeak = {};
+	{
+		StackAllocator allocator(1024);
+		allocator.allocate(100, 1);
+		allocator.allocate(28, 1);
+	}
+	EXPECT_EQ("StackAllocator", s_LastLeak.allocator);
+	EXPECT_EQ(2, s_LastLeak.allocations);
+	EXPECT_EQ(128, s_LastLeak.bytes);
+
+	// Allocators that were cleaned up do not report anything
+	s_LastLeak = {};
+	{
+		BuddyAllocator allocator(64 * 1024, 1024);
+		allocator.deallocate(allocator.allocate(100));
+	}
+	EXPECT_EQ("", s_LastLeak.allocator);
+
+	allocator_stats::setLeakHandler(previous);
+}
@@ -7,8 +7,8 @@ TEST(AllignmentTests, CalculateForwardAdjustment) {
 	void* ptr0 = &value0;
 	uintptr_t address0 = reinterpret_cast<uintptr_t>(ptr0) & 0xFF;
 
-	uint8 alignment0 = 32;
-	uint8 adjustment0 = pointer_functions::calc_forward_alignment_adjustment(ptr0, alignment0);
+	size_t alignment0 = 32;
+	size_t adjustment0 = pointer_functions::calc_forward_alignment_adjustment(ptr0, alignment0);
 
 	std::cout << "Memory adress = " << std::hex << address0 << std::endl;
 	std::cout << "Adjustment = " << std::hex << (uint32)adjustment0 << std::endl;
@@ -17,6 +17,17 @@ TEST(AllignmentTests, CalculateForwardAdjustment) {
 	EXPECT_TRUE(((address0 + adjustment0) % alignment0 == 0));
 }
 
+TEST(AllignmentTests, AlreadyAligned) {
+	alignas(4096) uint8 buffer[8192];
+
+	// An aligned address needs no adjustment, any other address moves to the next aligned address
+	for (size_t alignment = 1; alignment <= 4096; alignment <<= 1) {
+		EXPECT_EQ(0, pointer_functions::calc_forward_alignment_adjustment(buffer, alignment));
+		EXPECT_EQ(alignment - 1, pointer_functions::calc_forward_alignment_adjustment(buffer + 1, alignment));
+		EXPECT_EQ(0, pointer_functions::calc_backward_alignment_adjustment(buffer, alignment));
+	}
+}
+
 TEST(StackAllocatorTests, Default) {
 
 	size_t val0 = 1;
@@ -27,3 +38,524 @@ TEST(StackAllocatorTests, Default) {
 	EXPECT_EQ(val0, alignment);
 
 }
+
+// Test object stored in the pool allocator
+struct PoolObject {
+	uint64 value0;
+	uint32 value1;
+
+	PoolObject(uint64 v0, uint32 v1) : value0(v0), value1(v1) {}
+};
+
+TEST(PoolAllocatorTests, AllocateDeallocate) {
+	PoolAllocator<PoolObject> pool(4, false);
+
+	void* p0 = pool.allocate();
+	void* p1 = pool.allocate();
+	EXPECT_NE(p0, p1);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p0) % alignof(PoolObject));
+	EXPECT_EQ(2, pool.getAllocations());
+	EXPECT_EQ(2 * PoolAllocator<PoolObject>::SlotSize, pool.getUsedMemory());
+
+	// The most recently freed slot is handed out first
+	pool.deallocate(p1);
+	void* p2 = pool.allocate();
+	EXPECT_EQ(p1, p2);
+
+	pool.deallocate(p0);
+	pool.deallocate(p2);
+	EXPECT_EQ(0, pool.getAllocations());
+	EXPECT_EQ(0, pool.getUsedMemory());
+}
+
+TEST(PoolAllocatorTests, Exhausted) {
+	PoolAllocator<PoolObject> pool(2, false);
+
+	void* p0 = pool.allocate();
+	void* p1 = pool.allocate();
+	EXPECT_THROW(pool.allocate(), std::bad_alloc);
+	EXPECT_THROW(pool.allocate(sizeof(PoolObject) * 2), std::bad_alloc);
+
+	pool.deallocate(p0);
+	EXPECT_EQ(p0, pool.allocate());
+	pool.deallocate(p0);
+	pool.deallocate(p1);
+}
+
+TEST(PoolAllocatorTests, Grow) {
+	PoolAllocator<PoolObject> pool(8, true);
+	std::vector<PoolObject*> objects;
+
+	for (uint32 i = 0; i < 100; i++) objects.push_back(pool.create(i, i * 2));
+	EXPECT_EQ(13, pool.getSlabCount());
+	EXPECT_EQ(100, pool.getAllocations());
+
+	for (uint32 i = 0; i < 100; i++) {
+		EXPECT_EQ(i, objects[i]->value0);
+		EXPECT_EQ(i * 2, objects[i]->value1);
+	}
+
+	// Every slot is handed out only once
+	std::set<PoolObject*> unique(objects.begin(), objects.end());
+	EXPECT_EQ(objects.size(), unique.size());
+
+	for (PoolObject* object : objects) pool.destroy(object);
+	EXPECT_EQ(0, pool.getAllocations());
+
+	// Released slots are reused before a new slab is chained
+	for (uint32 i = 0; i < 100; i++) objects[i] = pool.create(i, i);
+	EXPECT_EQ(13, pool.getSlabCount());
+	for (PoolObject* object : objects) pool.destroy(object);
+}
+
+TEST(BlockAllocatorTests, AllocateDeallocate) {
+	BlockAllocator allocator(1024 * 1024);
+
+	void* p0 = allocator.allocate(100);
+	void* p1 = allocator.allocate(2000);
+	void* p2 = allocator.allocate(8);
+	EXPECT_EQ(3, allocator.getAllocations());
+	EXPECT_LE(2108, allocator.getUsedMemory());
+
+	memset(p0, 0xAA, 100);
+	memset(p1, 0xBB, 2000);
+	memset(p2, 0xCC, 8);
+
+	// Free out of order
+	allocator.deallocate(p1);
+	allocator.deallocate(p0, 100);
+	allocator.deallocate(p2);
+	EXPECT_EQ(0, allocator.getAllocations());
+	EXPECT_EQ(0, allocator.getUsedMemory());
+
+	EXPECT_THROW(allocator.deallocate(p2), jpt_bad_free);
+}
+
+TEST(BlockAllocatorTests, Alignment) {
+	BlockAllocator allocator(1024 * 1024);
+	std::vector<void*> blocks;
+
+	for (uint32 i = 0; i < 64; i++) {
+		uint8 alignment = (uint8)(1 << (i % 8));
+		void* p = allocator.allocate(24 + i * 3, alignment);
+		EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) % alignment);
+		blocks.push_back(p);
+	}
+
+	for (void* p : blocks) allocator.deallocate(p);
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(BlockAllocatorTests, Coalesce) {
+	const size_t size = 64 * 1024;
+	BlockAllocator allocator(size);
+	std::vector<void*> blocks;
+
+	// Fill the allocator with small blocks until it is exhausted
+	try {
+		while (true) blocks.push_back(allocator.allocate(48));
+	}
+	catch (std::bad_alloc&) {}
+	EXPECT_LT(100, blocks.size());
+
+	// A large block cannot be allocated while the memory is fragmented
+	allocator.deallocate(blocks[10]);
+	allocator.deallocate(blocks[20]);
+	EXPECT_THROW(allocator.allocate(size / 2), std::bad_alloc);
+
+	// Free every other block first, then the rest so both neighbours are merged
+	for (size_t i = 0; i < blocks.size(); i += 2) if (i != 10 && i != 20) allocator.deallocate(blocks[i]);
+	for (size_t i = 1; i < blocks.size(); i += 2) allocator.deallocate(blocks[i]);
+	EXPECT_EQ(0, allocator.getAllocations());
+
+	// All blocks are merged back into a single block
+	void* large = allocator.allocate(size - 1024);
+	EXPECT_NE(nullptr, large);
+	allocator.deallocate(large);
+}
+
+TEST(BlockAllocatorTests, RandomOrder) {
+	BlockAllocator allocator(4 * 1024 * 1024);
+	std::vector<std::pair<uint8*, size_t>> blocks;
+	uint32 seed = 12345;
+	auto random = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+
+	for (uint32 i = 0; i < 20000; i++) {
+		if (blocks.empty() || random() % 2 != 0) {
+			size_t size = 1 + random() % 2048;
+			uint8* p = reinterpret_cast<uint8*>(allocator.allocate(size, 8));
+			memset(p, (int)(size & 0xFF), size);
+			blocks.push_back({ p, size });
+		}
+		else {
+			size_t index = random() % blocks.size();
+			auto block = blocks[index];
+
+			// The contents of a block are never touched by other allocations
+			for (size_t j = 0; j < block.second; j++) ASSERT_EQ((uint8)(block.second & 0xFF), block.first[j]);
+
+			allocator.deallocate(block.first, block.second);
+			blocks[index] = blocks.back();
+			blocks.pop_back();
+		}
+	}
+
+	for (auto& block : blocks) allocator.deallocate(block.first);
+	EXPECT_EQ(0, allocator.getAllocations());
+	void* large = allocator.allocate(3 * 1024 * 1024);
+	allocator.deallocate(large);
+}
+
+TEST(BlockAllocatorTests, Resize) {
+	BlockAllocator allocator(64 * 1024);
+
+	uint8* p0 = reinterpret_cast<uint8*>(allocator.allocate(256));
+	uint8* p1 = reinterpret_cast<uint8*>(allocator.allocate(256));
+	memset(p0, 0xAB, 256);
+
+	// The next block is in use, so the first block cannot grow
+	EXPECT_FALSE(allocator.tryResize(p0, 1024));
+
+	// Shrinking returns the tail, growing absorbs it again
+	EXPECT_TRUE(allocator.tryResize(p0, 64));
+	EXPECT_GT(256, allocator.getUsedMemory() - 256);
+	EXPECT_TRUE(allocator.tryResize(p0, 200));
+
+	// The last block can grow into the free memory after it
+	EXPECT_TRUE(allocator.tryResize(p1, 32 * 1024));
+	memset(p1, 0xCD, 32 * 1024);
+	for (size_t i = 0; i < 64; i++) EXPECT_EQ(0xAB, p0[i]);
+
+	// A block that cannot grow in place is moved, the contents come along
+	uint8* moved = reinterpret_cast<uint8*>(allocator.reallocate(p0, 200, 1024));
+	EXPECT_NE(p0, moved);
+	for (size_t i = 0; i < 64; i++) EXPECT_EQ(0xAB, moved[i]);
+	EXPECT_EQ(2, allocator.getAllocations());
+
+	allocator.deallocate(moved);
+	allocator.deallocate(p1);
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	allocator.deallocate(allocator.allocate(60 * 1024));
+}
+
+TEST(ConcurrentStackAllocatorTests, Allocate) {
+	ConcurrentStackAllocator allocator(1024);
+
+	void* p0 = allocator.allocate(100, 8);
+	void* p1 = allocator.allocate(100, 16);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p1) % 16);
+	EXPECT_LE(reinterpret_cast<uintptr_t>(p0) + 100, reinterpret_cast<uintptr_t>(p1));
+	EXPECT_EQ(2, allocator.getAllocations());
+	EXPECT_LE(200, allocator.getUsedMemory());
+
+	EXPECT_THROW(allocator.allocate(1024), std::bad_alloc);
+	EXPECT_THROW(allocator.deallocate(p0), jpt_bad_free);
+
+	allocator.clear();
+	EXPECT_EQ(0, allocator.getAllocations());
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_EQ(p0, allocator.allocate(100, 8));
+}
+
+TEST(ConcurrentStackAllocatorTests, MultiThreaded) {
+	const uint32 threadCount = 8;
+	const uint32 allocationsPerThread = 10000;
+	ConcurrentStackAllocator allocator(threadCount * allocationsPerThread * 64);
+	std::vector<std::vector<uint32*>> blocks(threadCount);
+	std::vector<std::thread> threads;
+
+	// Every thread fills its blocks with its own id, overlapping blocks would overwrite each other
+	for (uint32 t = 0; t < threadCount; t++) {
+		threads.emplace_back([&allocator, &blocks, t]() {
+			for (uint32 i = 0; i < allocationsPerThread; i++) {
+				uint32* block = reinterpret_cast<uint32*>(allocator.allocate(4 * (1 + i % 8), 4));
+				for (uint32 j = 0; j < 1 + i % 8; j++) block[j] = t;
+				blocks[t].push_back(block);
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	EXPECT_EQ(threadCount * allocationsPerThread, allocator.getAllocations());
+	for (uint32 t = 0; t < threadCount; t++) {
+		for (uint32 i = 0; i < allocationsPerThread; i++) {
+			for (uint32 j = 0; j < 1 + i % 8; j++) ASSERT_EQ(t, blocks[t][i][j]);
+		}
+	}
+}
+
+TEST(StackAllocatorTests, AllocateClear) {
+	StackAllocator allocator(1024);
+
+	void* p0 = allocator.allocate(100, 8);
+	void* p1 = allocator.allocate(100, 16);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p1) % 16);
+	EXPECT_LE(reinterpret_cast<uintptr_t>(p0) + 100, reinterpret_cast<uintptr_t>(p1));
+	EXPECT_EQ(1024, allocator.getCommittedMemory());
+
+	// The stack is full
+	EXPECT_THROW(allocator.allocate(1024), std::bad_alloc);
+
+	allocator.clear();
+	EXPECT_EQ(p0, allocator.allocate(100, 8));
+	allocator.clear();
+}
+
+TEST(StackAllocatorTests, VirtualCommitOnDemand) {
+	const size_t reserved = (size_t)1 << 30;
+	StackAllocator allocator(reserved, EnumStackBacking::Virtual, 256 * 1024);
+	EXPECT_EQ(EnumStackBacking::Virtual, allocator.getBacking());
+	EXPECT_EQ(0, allocator.getCommittedMemory());
+
+	// Only the pages the top has reached are committed
+	uint8* p0 = reinterpret_cast<uint8*>(allocator.allocate(10 * 1024 * 1024, 16));
+	memset(p0, 0xAB, 10 * 1024 * 1024);
+	EXPECT_LE(10 * 1024 * 1024, allocator.getCommittedMemory());
+	EXPECT_GT(reserved / 4, allocator.getCommittedMemory());
+
+	// Freeing forward keeps the memory up to the marker and the watermark committed
+	void* marker = allocator.mark();
+	allocator.allocate(1024 * 1024);
+	allocator.freeForward(marker);
+	EXPECT_LE(10 * 1024 * 1024, allocator.getCommittedMemory());
+	EXPECT_GT(11 * 1024 * 1024, allocator.getCommittedMemory());
+
+	// Clearing decommits everything above the watermark
+	allocator.clear();
+	EXPECT_EQ(256 * 1024, allocator.getCommittedMemory());
+
+	// Decommitted memory can be committed and used again
+	uint8* p1 = reinterpret_cast<uint8*>(allocator.allocate(1024 * 1024, 16));
+	memset(p1, 0xCD, 1024 * 1024);
+	EXPECT_EQ(p0, p1);
+	allocator.clear();
+}
+
+TEST(StackAllocatorTests, VirtualExhausted) {
+	StackAllocator allocator(1024 * 1024, EnumStackBacking::Virtual);
+
+	allocator.allocate(1000 * 1024);
+	EXPECT_THROW(allocator.allocate(100 * 1024), std::bad_alloc);
+
+	// Without a watermark the committed memory is kept after a clear
+	allocator.clear();
+	EXPECT_LE(1000 * 1024, allocator.getCommittedMemory());
+}
+
+TEST(StackAllocatorTests, Resize) {
+	StackAllocator allocator(1024);
+
+	// The most recent allocation grows and shrinks by moving the top
+	uint8* p0 = reinterpret_cast<uint8*>(allocator.allocate(100, 8));
+	size_t used = allocator.getUsedMemory();
+	EXPECT_TRUE(allocator.tryResize(p0, 400));
+	EXPECT_EQ(used + 300, allocator.getUsedMemory());
+	EXPECT_TRUE(allocator.tryResize(p0, 50));
+	EXPECT_EQ(used - 50, allocator.getUsedMemory());
+	EXPECT_FALSE(allocator.tryResize(p0, 2048));
+	memset(p0, 0xAB, 50);
+
+	// Once another block is allocated the first block can only be copied
+	uint8* p1 = reinterpret_cast<uint8*>(allocator.allocate(16, 8));
+	EXPECT_FALSE(allocator.tryResize(p0, 100));
+	uint8* moved = reinterpret_cast<uint8*>(allocator.reallocate(p0, 50, 100, 8));
+	EXPECT_LT(p1, moved);
+	for (size_t i = 0; i < 50; i++) EXPECT_EQ(0xAB, moved[i]);
+
+	// The copy is now the most recent allocation, growing it again does not copy
+	EXPECT_EQ(moved, allocator.reallocate(moved, 100, 200, 8));
+
+	// A snapshot remembers the most recent allocation, so a scope does not stop it from growing
+	StackAllocator::stack_state state = allocator.getState();
+	allocator.allocate(16);
+	allocator.restore(state);
+	EXPECT_TRUE(allocator.tryResize(moved, 300));
+
+	// While the snapshot is open the block lies below it, growing it would overlap the blocks allocated after restoring
+	state = allocator.getState();
+	EXPECT_FALSE(allocator.tryResize(moved, 400));
+	allocator.restore(state);
+	EXPECT_TRUE(allocator.tryResize(moved, 400));
+
+	allocator.clear();
+	EXPECT_FALSE(allocator.tryResize(moved, 10));
+}
+
+TEST(DoubleEndedStackAllocatorTests, BothSides) {
+	DoubleEndedStackAllocator allocator(1024);
+
+	// The bottom stack grows up from the start, the top stack grows down from the end
+	uint8* bottom = reinterpret_cast<uint8*>(allocator.allocate(EnumStackSide::Bottom, 100, 8));
+	uint8* top = reinterpret_cast<uint8*>(allocator.allocate(EnumStackSide::Top, 100, 16));
+	EXPECT_TRUE(allocator.owns(bottom));
+	EXPECT_TRUE(allocator.owns(top));
+	EXPECT_LT(bottom, top);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(top) % 16);
+	EXPECT_EQ(1, allocator.getAllocations(EnumStackSide::Bottom));
+	EXPECT_EQ(1, allocator.getAllocations(EnumStackSide::Top));
+	EXPECT_EQ(1024, allocator.getFreeMemory() + allocator.getUsedMemory(EnumStackSide::Bottom) + allocator.getUsedMemory(EnumStackSide::Top));
+
+	// Blocks from the top stack are handed out below each other
+	uint8* top1 = reinterpret_cast<uint8*>(allocator.allocate(EnumStackSide::Top, 100, 16));
+	EXPECT_LE(top1 + 100, top);
+
+	// Clearing one side leaves the other side untouched
+	allocator.clear(EnumStackSide::Top);
+	EXPECT_EQ(0, allocator.getUsedMemory(EnumStackSide::Top));
+	EXPECT_EQ(1, allocator.getAllocations(EnumStackSide::Bottom));
+	EXPECT_EQ(top, allocator.allocate(EnumStackSide::Top, 100, 16));
+	allocator.clear();
+}
+
+TEST(DoubleEndedStackAllocatorTests, Collision) {
+	DoubleEndedStackAllocator allocator(1024);
+
+	// One side can use almost the entire block when the other side is empty
+	allocator.allocate(EnumStackSide::Top, 1000, 8);
+	EXPECT_THROW(allocator.allocate(EnumStackSide::Bottom, 100), std::bad_alloc);
+	EXPECT_EQ(nullptr, allocator.tryAllocate(EnumStackSide::Top, 100));
+
+	// The space between the stacks is shared, whichever side asks first gets it
+	allocator.clear();
+	void* bottom = allocator.allocate(EnumStackSide::Bottom, 600, 8);
+	EXPECT_EQ(nullptr, allocator.tryAllocate(EnumStackSide::Top, 600, 8));
+	void* top = allocator.allocate(EnumStackSide::Top, allocator.getFreeMemory(), 1);
+	EXPECT_EQ(0, allocator.getFreeMemory());
+	EXPECT_LE(reinterpret_cast<uint8*>(bottom) + 600, top);
+	EXPECT_EQ(nullptr, allocator.tryAllocate(EnumStackSide::Bottom, 1, 1));
+	allocator.clear();
+}
+
+TEST(DoubleEndedStackAllocatorTests, Markers) {
+	DoubleEndedStackAllocator allocator(4096);
+	allocator.allocate(EnumStackSide::Bottom, 100);
+	allocator.allocate(EnumStackSide::Top, 100);
+
+	void* bottomMarker = allocator.mark(EnumStackSide::Bottom);
+	void* topMarker = allocator.mark(EnumStackSide::Top);
+	allocator.allocate(EnumStackSide::Bottom, 500);
+	allocator.allocate(EnumStackSide::Top, 500);
+	size_t freeMemory = allocator.getFreeMemory();
+
+	// Freeing forward on one side does not touch the other side, the marker itself is freed as well
+	allocator.freeForward(EnumStackSide::Top, topMarker);
+	EXPECT_EQ(1, allocator.getAllocations(EnumStackSide::Top));
+	EXPECT_EQ(3, allocator.getAllocations(EnumStackSide::Bottom));
+	EXPECT_LT(freeMemory, allocator.getFreeMemory());
+	EXPECT_EQ(topMarker, allocator.mark(EnumStackSide::Top));
+
+	allocator.freeForward(EnumStackSide::Bottom, bottomMarker);
+	EXPECT_EQ(1, allocator.getAllocations(EnumStackSide::Bottom));
+	EXPECT_EQ(bottomMarker, allocator.mark(EnumStackSide::Bottom));
+
+	// Memory freed on one side is available to the other side
+	allocator.clear(EnumStackSide::Bottom);
+	EXPECT_NE(nullptr, allocator.tryAllocate(EnumStackSide::Top, 3000));
+	allocator.clear();
+}
+
+TEST(StackAllocatorTests, HugePages) {
+	StackAllocator allocator(3 * 1024 * 1024, EnumStackBacking::HugePages);
+	EXPECT_EQ(EnumStackBacking::HugePages, allocator.getBacking());
+
+	// The size is rounded up to whole huge pages and the block starts on a huge page boundary, whatever pages backed it
+	EXPECT_EQ(4 * 1024 * 1024, allocator.getSize());
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(allocator.allocate(1, 1)) & (virtual_memory::HugePageSize - 1));
+	EXPECT_EQ(4 * 1024 * 1024, allocator.getCommittedMemory());
+
+	void* p = allocator.allocate(1024 * 1024);
+	memset(p, 0xAB, 1024 * 1024);
+	EXPECT_THROW(allocator.allocate(4 * 1024 * 1024), std::bad_alloc);
+	allocator.clear();
+}
+
+TEST(StackAllocatorTests, VirtualHugePages) {
+	StackAllocator allocator((size_t)1 << 30, EnumStackBacking::VirtualHugePages, 0);
+	EXPECT_EQ(EnumStackBacking::VirtualHugePages, allocator.getBacking());
+	EXPECT_NE(EnumPageBacking::HugePages, allocator.getPageBacking());
+	EXPECT_EQ(0, allocator.getCommittedMemory());
+
+	// Memory is committed a whole huge page at a time
+	void* p = allocator.allocate(100);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & (virtual_memory::HugePageSize - 1));
+	EXPECT_EQ(virtual_memory::HugePageSize, allocator.getCommittedMemory());
+
+	p = allocator.allocate(3 * 1024 * 1024);
+	memset(p, 0xAB, 3 * 1024 * 1024);
+	EXPECT_EQ(2 * virtual_memory::HugePageSize, allocator.getCommittedMemory());
+
+	// A zero watermark decommits everything on a clear
+	allocator.clear();
+	EXPECT_EQ(0, allocator.getCommittedMemory());
+}
+
+// Every allocator satisfies the compile time interface, IAllocator itself as the type erased variant
+static_assert(StaticAllocator<IAllocator>);
+static_assert(StaticAllocator<StackAllocator>);
+static_assert(StaticAllocator<DoubleEndedStackAllocator>);
+static_assert(StaticAllocator<BlockAllocator>);
+static_assert(StaticAllocator<PoolAllocator<uint64>>);
+static_assert(StaticAllocator<MallocAllocator>);
+static_assert(!StaticAllocator<int>);
+
+TEST(StaticAllocatorTests, AllocateNew) {
+	struct Vector3 {
+		float x, y, z;
+		Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
+	};
+
+	PoolAllocator<Vector3> pool(16, false);
+	Vector3* v = Allocator::allocateNew<Vector3>(pool, 1.0f, 2.0f, 3.0f);
+	EXPECT_EQ(2.0f, v->y);
+	EXPECT_EQ(1, pool.getAllocations());
+
+	Allocator::deallocateDelete(pool, v);
+	EXPECT_EQ(0, pool.getAllocations());
+}
+
+TEST(StaticAllocatorTests, Isolated) {
+	BlockAllocator allocator(64 * 1024);
+
+	// Every counter starts on its own cache line, and the padding keeps the next block off that line
+	std::vector<uint64*> counters;
+	for (uint32 i = 0; i < 8; i++) {
+		uint64* counter = Allocator::allocateNewIsolated<uint64>(allocator, (uint64)i);
+		EXPECT_EQ(0, reinterpret_cast<uintptr_t>(counter) % CacheLineSize);
+		for (uint64* other : counters) EXPECT_LE(CacheLineSize, (size_t)std::abs(reinterpret_cast<intptr_t>(counter) - reinterpret_cast<intptr_t>(other)));
+		counters.push_back(counter);
+	}
+	EXPECT_EQ(2 * CacheLineSize, Allocator::isolatedSize(CacheLineSize + 1));
+
+	for (uint64* counter : counters) Allocator::deallocateDeleteIsolated(allocator, counter);
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(StackAllocatorTests, WideAlignment) {
+	StackAllocator allocator(64 * 1024);
+
+	// Alignments beyond 255 bytes, up to a whole page
+	void* p0 = allocator.allocate(10, 256);
+	void* p1 = allocator.allocate(10, 4096);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p0) % 256);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p1) % 4096);
+
+	// A top that is already aligned costs no padding
+	allocator.clear();
+	allocator.allocate(16, 16);
+	size_t used = allocator.getUsedMemory();
+	allocator.allocate(16, 16);
+	EXPECT_EQ(used + 16, allocator.getUsedMemory());
+	allocator.clear();
+}
+
+TEST(StaticAllocatorTests, Adapter) {
+	BlockAllocator block(64 * 1024);
+	AllocatorAdapter<BlockAllocator> adapter(block);
+	IAllocator& allocator = adapter;
+
+	void* p = allocator.allocate(100, 16);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & 15);
+	EXPECT_EQ(1, block.getAllocations());
+	allocator.deallocate(p, 100);
+	EXPECT_EQ(0, block.getAllocations());
+}
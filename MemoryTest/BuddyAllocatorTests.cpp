@@ -0,0 +1,115 @@
+#include "pch.h"
+
+#include "JupiterBuddyAllocator.h"
+#include "JupiterVirtualMemory.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace Jupiter;
+
+TEST(BuddyAllocatorTests, Construct) {
+	BuddyAllocator allocator(1000 * 1000, 50);
+	EXPECT_EQ(1024 * 1024, allocator.getSize());
+	EXPECT_EQ(64, allocator.getMinBlockSize());
+	EXPECT_EQ(15, allocator.getOrderCount());
+	EXPECT_EQ(1, allocator.getFreeBlocks(14));
+	EXPECT_EQ(64, allocator.blockSize(1));
+	EXPECT_EQ(4096, allocator.blockSize(4000));
+	EXPECT_EQ(4096, allocator.blockSize(4096));
+}
+
+TEST(BuddyAllocatorTests, SplitMerge) {
+	BuddyAllocator allocator(64 * 1024, 1024);
+	uint32 top = allocator.getOrderCount() - 1;
+
+	// The root is split all the way down, leaving one free buddy on every order below it
+	void* p0 = allocator.allocate(1000);
+	for (uint32 order = 0; order < top; order++) EXPECT_EQ(1, allocator.getFreeBlocks(order));
+	EXPECT_EQ(0, allocator.getFreeBlocks(top));
+
+	// The buddy of the first block is handed out next, it starts right after it
+	void* p1 = allocator.allocate(1024);
+	EXPECT_EQ(1024, reinterpret_cast<uint8*>(p1) - reinterpret_cast<uint8*>(p0));
+	EXPECT_EQ(0, allocator.getFreeBlocks(0));
+
+	void* p2 = allocator.allocate(8 * 1024);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p2) & (8 * 1024 - 1));
+	EXPECT_EQ(1024 + 1024 + 8 * 1024, allocator.getUsedMemory());
+
+	// Freeing both buddies merges them, freeing everything merges the tree back into the root
+	allocator.deallocate(p0);
+	EXPECT_EQ(1, allocator.getFreeBlocks(0));
+	allocator.deallocate(p1, 1024);
+	EXPECT_EQ(0, allocator.getFreeBlocks(0));
+
+	// The merged block keeps merging with its free buddies until it reaches the buddy of p2
+	EXPECT_EQ(0, allocator.getFreeBlocks(1));
+	EXPECT_EQ(0, allocator.getFreeBlocks(2));
+	EXPECT_EQ(1, allocator.getFreeBlocks(3));
+	allocator.deallocate(p2);
+	EXPECT_EQ(1, allocator.getFreeBlocks(top));
+	for (uint32 order = 0; order < top; order++) EXPECT_EQ(0, allocator.getFreeBlocks(order));
+	EXPECT_EQ(0, allocator.getAllocations());
+
+	// The whole memory block is available again
+	void* root = allocator.allocate(64 * 1024);
+	EXPECT_EQ(p0, root);
+	EXPECT_THROW(allocator.allocate(1), std::bad_alloc);
+	allocator.deallocate(root);
+}
+
+TEST(BuddyAllocatorTests, BadFree) {
+	BuddyAllocator allocator(64 * 1024, 1024);
+	uint8* p = reinterpret_cast<uint8*>(allocator.allocate(4096));
+
+	int value = 0;
+	EXPECT_THROW(allocator.deallocate(&value), jpt_bad_free);
+	EXPECT_THROW(allocator.deallocate(p + 1024), jpt_bad_free);
+	EXPECT_THROW(allocator.deallocate(p, 8192), jpt_bad_free);
+
+	allocator.deallocate(p);
+	EXPECT_THROW(allocator.deallocate(p), jpt_bad_free);
+}
+
+TEST(BuddyAllocatorTests, Alignment) {
+	BuddyAllocator allocator(8 * 1024 * 1024, 64);
+
+	// Blocks are aligned up to the huge page size, the memory block itself is aligned no further
+	void* p = allocator.allocate(64, virtual_memory::HugePageSize);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & (virtual_memory::HugePageSize - 1));
+	EXPECT_EQ(nullptr, allocator.tryAllocate(64, 2 * virtual_memory::HugePageSize));
+	EXPECT_THROW(allocator.allocate(64, 2 * virtual_memory::HugePageSize), std::bad_alloc);
+	allocator.deallocate(p);
+}
+
+TEST(BuddyAllocatorTests, RandomOrder) {
+	BuddyAllocator allocator(4 * 1024 * 1024, 64);
+	std::mt19937 random(99);
+	std::vector<std::pair<uint8*, size_t>> blocks;
+
+	for (uint32 i = 0; i < 20000; i++) {
+		if (blocks.empty() || random() % 2 == 0) {
+			size_t size = (size_t)64 << (random() % 8);
+			uint8* p = reinterpret_cast<uint8*>(allocator.tryAllocate(size));
+			if (p == nullptr) continue;
+			EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & (size - 1));
+			memset(p, (int)(i & 0xFF), size);
+			blocks.push_back({ p, size });
+		}
+		else {
+			size_t index = random() % blocks.size();
+			allocator.deallocate(blocks[index].first, blocks[index].second);
+			blocks[index] = blocks.back();
+			blocks.pop_back();
+		}
+	}
+
+	// Blocks never overlap
+	std::sort(blocks.begin(), blocks.end());
+	for (size_t i = 1; i < blocks.size(); i++) EXPECT_LE(blocks[i - 1].first + blocks[i - 1].second, blocks[i].first);
+
+	for (auto [p, size] : blocks) allocator.deallocate(p);
+	EXPECT_EQ(0, allocator.getAllocations());
+	EXPECT_EQ(1, allocator.getFreeBlocks(allocator.getOrderCount() - 1));
+}
@@ -0,0 +1,214 @@
+#include "pch.h"
+
+#include "JupiterCompactingHeap.h"
+#include "JupiterAllocatorExceptions.h"
+
+#include <random>
+#include <vector>
+
+using namespace Jupiter;
+
+// Fills a block with a byte derived from its handle, so a block that was moved can be checked.
+// A moved block can grow into a rest too small to split off, so the filled size is kept in the first bytes of the block
+static void fillBlock(CompactingHeap& heap, slot_handle handle) {
+	CompactingHeap::Pin pin = heap.pin(handle);
+	size_t size = heap.sizeOf(handle);
+	memset(pin.get(), (int)(handle.index & 0xFF), size);
+	memcpy(pin.get(), &size, sizeof(size_t));
+}
+
+static bool checkBlock(CompactingHeap& heap, slot_handle handle) {
+	CompactingHeap::Pin pin = heap.pin(handle);
+	const uint8* data = pin.as<uint8>();
+	size_t size;
+	memcpy(&size, data, sizeof(size_t));
+	if (size > heap.sizeOf(handle)) return false;
+	for (size_t i = sizeof(size_t); i < size; i++) {
+		if (data[i] != (uint8)(handle.index & 0xFF)) return false;
+	}
+	return true;
+}
+
+TEST(CompactingHeapTests, AllocateFree) {
+	CompactingHeap heap(1024 * 1024);
+
+	slot_handle a = heap.allocate(10);
+	slot_handle b = heap.allocate(100);
+	EXPECT_TRUE(heap.contains(a));
+	EXPECT_EQ(CompactingHeap::MinBlockSize, heap.sizeOf(a));
+	EXPECT_EQ(112, heap.sizeOf(b));
+	EXPECT_EQ(2, heap.getAllocations());
+	EXPECT_EQ(2 * CompactingHeap::HeaderSize + 16 + 112, heap.getHeapSize());
+	EXPECT_EQ(0, (size_t)heap.pin(b).get() % CompactingHeap::Alignment);
+
+	// A free block below the top is reused, a free block at the top lowers the top
+	heap.free(a);
+	EXPECT_FALSE(heap.contains(a));
+	EXPECT_EQ(1, heap.getFreeBlocks());
+	slot_handle c = heap.allocate(16);
+	EXPECT_EQ(0, heap.getFreeBlocks());
+	EXPECT_EQ(a.index, c.index);
+	EXPECT_NE(a.generation, c.generation);
+
+	heap.free(b);
+	heap.free(c);
+	EXPECT_EQ(0, heap.getHeapSize());
+	EXPECT_EQ(0, heap.getUsedMemory());
+	EXPECT_EQ(0, heap.getFreeMemory());
+
+	EXPECT_THROW(heap.free(c), jpt_bad_free);
+	EXPECT_THROW(heap.pin(slot_handle()), jpt_bad_free);
+	EXPECT_THROW(heap.allocate(2 * 1024 * 1024), std::bad_alloc);
+}
+
+TEST(CompactingHeapTests, MergeFreeBlocks) {
+	CompactingHeap heap(1024 * 1024);
+	slot_handle handles[5];
+	for (slot_handle& handle : handles) handle = heap.allocate(64);
+
+	// Freeing both neighbours of a free block leaves a single free block
+	heap.free(handles[1]);
+	heap.free(handles[3]);
+	EXPECT_EQ(2, heap.getFreeBlocks());
+	heap.free(handles[2]);
+	EXPECT_EQ(1, heap.getFreeBlocks());
+	EXPECT_EQ(3 * (CompactingHeap::HeaderSize + 64), heap.getFreeMemory());
+
+	// The merged block is split again, the rest stays free
+	slot_handle a = heap.allocate(64);
+	EXPECT_EQ(1, heap.getFreeBlocks());
+	EXPECT_EQ(2 * (CompactingHeap::HeaderSize + 64), heap.getFreeMemory());
+
+	// Freeing the last block merges it with the free block below it before lowering the top
+	heap.free(handles[4]);
+	EXPECT_EQ(0, heap.getFreeBlocks());
+	EXPECT_EQ(2 * (CompactingHeap::HeaderSize + 64), heap.getHeapSize());
+
+	heap.free(a);
+	heap.free(handles[0]);
+	EXPECT_EQ(0, heap.getHeapSize());
+}
+
+TEST(CompactingHeapTests, Defragment) {
+	CompactingHeap heap(4 * 1024 * 1024);
+	std::vector<slot_handle> handles;
+	for (uint32 i = 0; i < 200; i++) {
+		handles.push_back(heap.allocate(64 + (i % 7) * 48));
+		fillBlock(heap, handles.back());
+	}
+
+	// Free every other block, the heap keeps its size with half of it in free blocks
+	size_t heapSize = heap.getHeapSize();
+	std::vector<slot_handle> live;
+	for (uint32 i = 0; i < handles.size(); i++) {
+		if (i % 2 == 0) heap.free(handles[i]);
+		else live.push_back(handles[i]);
+	}
+	EXPECT_EQ(heapSize, heap.getHeapSize());
+	EXPECT_EQ(100, heap.getFreeBlocks());
+
+	// A budget of zero moves a single block, the last block goes into a free block below it and the top comes down
+	EXPECT_EQ(heap.sizeOf(live.back()), heap.defragment(std::chrono::nanoseconds(0)));
+	EXPECT_LT(heap.getHeapSize(), heapSize);
+
+	while (heap.defragment(std::chrono::milliseconds(10)) != 0) {}
+	EXPECT_EQ(0, heap.getFreeBlocks());
+	EXPECT_EQ(0, heap.getFreeMemory());
+	EXPECT_EQ(live.size() * CompactingHeap::HeaderSize + heap.getUsedMemory(), heap.getHeapSize());
+	EXPECT_EQ(0, heap.defragment(std::chrono::milliseconds(10)));
+
+	for (slot_handle handle : live) {
+		EXPECT_TRUE(checkBlock(heap, handle));
+		heap.free(handle);
+	}
+	EXPECT_EQ(0, heap.getHeapSize());
+}
+
+TEST(CompactingHeapTests, Pinning) {
+	CompactingHeap heap(1024 * 1024);
+	slot_handle a = heap.allocate(64);
+	slot_handle b = heap.allocate(64);
+	slot_handle c = heap.allocate(128);
+	fillBlock(heap, b);
+	fillBlock(heap, c);
+	heap.free(a);
+
+	{
+		// A pinned block is not moved, and the free block below it stays as the last block does not fit in it
+		CompactingHeap::Pin pin = heap.pin(b);
+		void* address = pin.get();
+		EXPECT_THROW(heap.free(b), jpt_bad_free);
+		EXPECT_EQ(0, heap.defragment(std::chrono::milliseconds(10)));
+		EXPECT_EQ(address, pin.get());
+		EXPECT_EQ(1, heap.getFreeBlocks());
+
+		CompactingHeap::Pin moved = std::move(pin);
+		EXPECT_EQ(nullptr, pin.get());
+		EXPECT_EQ(address, moved.get());
+	}
+
+	// Once the pin is released the block is moved into the free block, then the last block slides down as it fits nowhere
+	EXPECT_EQ(64, heap.defragment(std::chrono::milliseconds(10)));
+	EXPECT_EQ(128, heap.defragment(std::chrono::milliseconds(10)));
+	EXPECT_EQ(0, heap.getFreeBlocks());
+	EXPECT_EQ(2 * CompactingHeap::HeaderSize + 64 + 128, heap.getHeapSize());
+	EXPECT_TRUE(checkBlock(heap, b));
+	EXPECT_TRUE(checkBlock(heap, c));
+
+	heap.free(b);
+	heap.free(c);
+}
+
+TEST(CompactingHeapTests, Stats) {
+	CompactingHeap heap(1024 * 1024);
+	slot_handle a = heap.allocate(80);
+	slot_handle b = heap.allocate(16);
+	slot_handle c = heap.allocate(64);
+
+	// The rest of the free block is too small to split off, so the moved block grows into it
+	heap.free(a);
+	EXPECT_EQ(64, heap.defragment(std::chrono::nanoseconds(0)));
+	EXPECT_EQ(80, heap.sizeOf(c));
+#ifdef MEMORY_ALLOCATOR_STATS
+	EXPECT_EQ(heap.getUsedMemory(), heap.getStats().getCurrentBytes());
+#endif //MEMORY_ALLOCATOR_STATS
+
+	heap.free(b);
+	heap.free(c);
+	EXPECT_EQ(0, heap.getStats().getCurrentBytes());
+}
+
+TEST(CompactingHeapTests, Churn) {
+	CompactingHeap heap(64 * 1024 * 1024);
+	std::mt19937 random(11);
+	std::vector<slot_handle> handles;
+
+	// Random frees and allocations with a defragment tick in between, every block keeps its contents
+	for (uint32 round = 0; round < 50; round++) {
+		for (uint32 i = 0; i < 200; i++) {
+			if (!handles.empty() && random() % 2 == 0) {
+				size_t index = random() % handles.size();
+				heap.free(handles[index]);
+				handles[index] = handles.back();
+				handles.pop_back();
+			}
+			else {
+				handles.push_back(heap.allocate(16 + random() % 2000));
+				fillBlock(heap, handles.back());
+			}
+		}
+		heap.defragment(std::chrono::microseconds(50));
+	}
+
+	for (slot_handle handle : handles) EXPECT_TRUE(checkBlock(heap, handle));
+	while (heap.defragment(std::chrono::milliseconds(10)) != 0) {}
+	EXPECT_EQ(0, heap.getFreeBlocks());
+	EXPECT_LE(heap.getCommittedSize(), heap.getHeapSize() + 2 * CompactingHeap::DecommitThreshold);
+
+	for (slot_handle handle : handles) {
+		EXPECT_TRUE(checkBlock(heap, handle));
+		heap.free(handle);
+	}
+	EXPECT_EQ(0, heap.getHeapSize());
+	EXPECT_EQ(0, heap.getAllocations());
+}
@@ -0,0 +1,128 @@
+#include "pch.h"
+
+#include "JupiterComposableAllocators.h"
+
+using namespace Jupiter;
+
+TEST(ComposableAllocatorTests, FallbackStackToHeap) {
+	FallbackAllocator<StackAllocator, MallocAllocator> allocator(std::piecewise_construct, std::forward_as_tuple(1024), std::forward_as_tuple());
+
+	// The first blocks fit in the stack, once it is full the heap takes over
+	void* p0 = allocator.allocate(512, 8);
+	void* p1 = allocator.allocate(400, 8);
+	void* p2 = allocator.allocate(512, 8);
+	EXPECT_TRUE(allocator.getPrimary().owns(p0));
+	EXPECT_TRUE(allocator.getPrimary().owns(p1));
+	EXPECT_FALSE(allocator.getPrimary().owns(p2));
+	EXPECT_EQ(2, allocator.getPrimary().getAllocations());
+
+	// Deallocating a stack block is dropped, deallocating a heap block frees it
+	allocator.deallocate(p0);
+	allocator.deallocate(p1, 400);
+	allocator.deallocate(p2);
+	EXPECT_EQ(2, allocator.getPrimary().getAllocations());
+	allocator.getPrimary().clear();
+}
+
+TEST(ComposableAllocatorTests, FallbackTryAllocate) {
+	FallbackAllocator<StackAllocator, BlockAllocator> allocator(std::piecewise_construct, std::forward_as_tuple(256), std::forward_as_tuple(1024));
+
+	EXPECT_NE(nullptr, allocator.tryAllocate(200));
+	void* p = allocator.tryAllocate(512);
+	EXPECT_NE(nullptr, p);
+	EXPECT_TRUE(allocator.getFallback().owns(p));
+	EXPECT_EQ(nullptr, allocator.tryAllocate(4096));
+	EXPECT_THROW(allocator.allocate(4096), std::bad_alloc);
+
+	allocator.deallocate(p);
+	EXPECT_EQ(0, allocator.getFallback().getAllocations());
+	allocator.getPrimary().clear();
+}
+
+TEST(ComposableAllocatorTests, Segregator) {
+	Segregator<64, PoolAllocator<composable::pool_slot<64>>, BlockAllocator> allocator(std::piecewise_construct, std::forward_as_tuple(16, true), std::forward_as_tuple(64 * 1024));
+
+	void* small = allocator.allocate(48, 8);
+	void* large = allocator.allocate(1000, 8);
+	EXPECT_TRUE(allocator.getSmall().owns(small));
+	EXPECT_TRUE(allocator.getLarge().owns(large));
+	EXPECT_TRUE(allocator.owns(small));
+	EXPECT_TRUE(allocator.owns(large));
+
+	allocator.deallocate(small);
+	allocator.deallocate(large, 1000);
+	EXPECT_EQ(0, allocator.getSmall().getAllocations());
+	EXPECT_EQ(0, allocator.getLarge().getAllocations());
+}
+
+TEST(ComposableAllocatorTests, Bucketizer) {
+	typedef Bucketizer<PoolBucket, 16, 128, 16> Buckets;
+	EXPECT_EQ(8, Buckets::BucketCount);
+	EXPECT_EQ(0, Buckets::bucketIndex(1));
+	EXPECT_EQ(0, Buckets::bucketIndex(16));
+	EXPECT_EQ(1, Buckets::bucketIndex(17));
+	EXPECT_EQ(7, Buckets::bucketIndex(128));
+	EXPECT_EQ(Buckets::BucketCount, Buckets::bucketIndex(129));
+
+	Buckets allocator(64, true);
+	std::vector<std::pair<void*, size_t>> blocks;
+	for (size_t size = 1; size <= 128; size++) {
+		void* p = allocator.allocate(size, 8);
+		memset(p, (int)size, size);
+		blocks.push_back({ p, size });
+	}
+	EXPECT_EQ(16, allocator.getBucket<0>().getAllocations());
+	EXPECT_EQ(16, allocator.getBucket<7>().getAllocations());
+	EXPECT_EQ(nullptr, allocator.tryAllocate(129));
+	EXPECT_THROW(allocator.allocate(129), std::bad_alloc);
+
+	// Half of the blocks are returned by size, the other half by ownership
+	for (size_t i = 0; i < blocks.size(); i++) {
+		EXPECT_TRUE(allocator.owns(blocks[i].first));
+		if (i % 2 == 0) allocator.deallocate(blocks[i].first, blocks[i].second);
+		else allocator.deallocate(blocks[i].first);
+	}
+	EXPECT_EQ(0, allocator.getBucket<0>().getAllocations());
+	EXPECT_EQ(0, allocator.getBucket<7>().getAllocations());
+
+	int value = 0;
+	EXPECT_THROW(allocator.deallocate(&value), jpt_bad_free);
+}
+
+TEST(ComposableAllocatorTests, Nested) {
+	// Pools per size class for small blocks, a block heap for the rest and the system heap once the block heap is full
+	typedef Segregator<256, Bucketizer<PoolBucket, 16, 256, 16>, FallbackAllocator<BlockAllocator, MallocAllocator>> Composed;
+	Composed allocator(std::piecewise_construct, std::forward_as_tuple(32, true),
+		std::forward_as_tuple(std::piecewise_construct, std::forward_as_tuple(4096), std::forward_as_tuple()));
+
+	void* small = allocator.allocate(100);
+	void* medium = allocator.allocate(2048);
+	void* large = allocator.allocate(8192);
+	EXPECT_TRUE(allocator.getSmall().owns(small));
+	EXPECT_TRUE(allocator.getLarge().getPrimary().owns(medium));
+	EXPECT_FALSE(allocator.getLarge().getPrimary().owns(large));
+
+	allocator.deallocate(small, 100);
+	allocator.deallocate(medium, 2048);
+	allocator.deallocate(large, 8192);
+	EXPECT_EQ(0, allocator.getLarge().getPrimary().getAllocations());
+}
+
+TEST(ComposableAllocatorTests, TypeErased) {
+	typedef Segregator<64, PoolBucket<64>, BlockAllocator> Composed;
+	static_assert(StaticAllocator<Composed>);
+
+	// A composed allocator only becomes an IAllocator when it is explicitly wrapped
+	Composed composed(std::piecewise_construct, std::forward_as_tuple(16, true), std::forward_as_tuple(64 * 1024));
+	AllocatorAdapter<Composed> adapter(composed);
+	IAllocator& allocator = adapter;
+
+	void* small = allocator.allocate(32, 8);
+	void* large = allocator.allocate(512, 8);
+	EXPECT_TRUE(composed.getSmall().owns(small));
+	EXPECT_TRUE(composed.getLarge().owns(large));
+	allocator.deallocate(small);
+	allocator.deallocate(large);
+	EXPECT_EQ(0, composed.getSmall().getAllocations());
+	EXPECT_EQ(0, composed.getLarge().getAllocations());
+}
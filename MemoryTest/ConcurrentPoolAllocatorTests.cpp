@@ -0,0 +1,149 @@
+#include "pch.h"
+
+#include "JupiterConcurrentPoolAllocator.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace Jupiter;
+
+// Message object passed from producer to consumer threads
+struct PoolMessage {
+	uint32 producer;
+	uint32 sequence;
+	uint64 checksum;
+
+	PoolMessage(uint32 p, uint32 s) : producer(p), sequence(s), checksum(((uint64)p << 32) ^ s ^ 0x5bd1e995) {}
+	bool valid() const { return checksum == (((uint64)producer << 32) ^ sequence ^ 0x5bd1e995); }
+};
+
+TEST(ConcurrentPoolAllocatorTests, AllocateDeallocate) {
+	ConcurrentPoolAllocator<PoolMessage> pool(4, false);
+	EXPECT_EQ(4, pool.getCapacity());
+
+	std::vector<void*> slots;
+	for (uint32 i = 0; i < 4; i++) slots.push_back(pool.allocate());
+	EXPECT_THROW(pool.allocate(), std::bad_alloc);
+
+	std::set<void*> unique(slots.begin(), slots.end());
+	EXPECT_EQ(4, unique.size());
+
+	int value = 0;
+	EXPECT_THROW(pool.deallocate(&value), jpt_bad_free);
+
+	for (void* slot : slots) pool.deallocate(slot);
+	for (uint32 i = 0; i < 4; i++) slots[i] = pool.allocate();
+	for (void* slot : slots) pool.deallocate(slot);
+}
+
+TEST(ConcurrentPoolAllocatorTests, Grow) {
+	ConcurrentPoolAllocator<PoolMessage> pool(8, true);
+	std::vector<PoolMessage*> messages;
+
+	for (uint32 i = 0; i < 1000; i++) messages.push_back(pool.create(0, i));
+	EXPECT_EQ(7, pool.getSlabCount());
+	EXPECT_EQ(1016, pool.getCapacity());
+
+	std::set<PoolMessage*> unique(messages.begin(), messages.end());
+	EXPECT_EQ(messages.size(), unique.size());
+	for (uint32 i = 0; i < 1000; i++) {
+		EXPECT_EQ(i, messages[i]->sequence);
+		EXPECT_TRUE(messages[i]->valid());
+	}
+	for (PoolMessage* message : messages) pool.destroy(message);
+}
+
+TEST(ConcurrentPoolAllocatorTests, ContendedOwnership) {
+	// Every thread writes its id in the slots it owns and checks it is still there before freeing,
+	// a slot handed out twice would be overwritten by the other owner
+	ConcurrentPoolAllocator<uint64> pool(64, true);
+	std::atomic<bool> failed(false);
+	std::vector<std::thread> threads;
+
+	for (uint64 t = 1; t <= 8; t++) {
+		threads.emplace_back([&pool, &failed, t]() {
+			std::vector<uint64*> owned;
+			uint32 seed = (uint32)t;
+			for (uint32 i = 0; i < 200000; i++) {
+				seed = seed * 1664525u + 1013904223u;
+				if (owned.size() < 32 && (owned.empty() || (seed >> 16) % 2 == 0)) {
+					uint64* slot = reinterpret_cast<uint64*>(pool.allocate());
+					*slot = t;
+					owned.push_back(slot);
+				}
+				else {
+					uint64* slot = owned[(seed >> 8) % owned.size()];
+					if (*slot != t) failed = true;
+					std::swap(slot, owned.back());
+					owned.pop_back();
+					pool.deallocate(slot);
+				}
+			}
+			for (uint64* slot : owned) {
+				if (*slot != t) failed = true;
+				pool.deallocate(slot);
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	EXPECT_FALSE(failed);
+}
+
+TEST(ConcurrentPoolAllocatorTests, ProducerConsumer) {
+	ConcurrentPoolAllocator<PoolMessage> pool(16, true);
+	const uint32 producers = 4;
+	const uint32 consumers = 4;
+	const uint32 messagesPerProducer = 50000;
+
+	std::deque<PoolMessage*> queue;
+	std::mutex queueMutex;
+	std::atomic<uint32> consumed(0);
+	std::atomic<uint32> corrupted(0);
+	std::vector<std::thread> threads;
+
+	for (uint32 p = 0; p < producers; p++) {
+		threads.emplace_back([&, p]() {
+			for (uint32 i = 0; i < messagesPerProducer; i++) {
+				PoolMessage* message = pool.create(p, i);
+				std::lock_guard<std::mutex> lock(queueMutex);
+				queue.push_back(message);
+			}
+		});
+	}
+
+	for (uint32 c = 0; c < consumers; c++) {
+		threads.emplace_back([&]() {
+			while (consumed.load() < producers * messagesPerProducer) {
+				PoolMessage* message = nullptr;
+				{
+					std::lock_guard<std::mutex> lock(queueMutex);
+					if (!queue.empty()) {
+						message = queue.front();
+						queue.pop_front();
+					}
+				}
+				if (message == nullptr) {
+					std::this_thread::yield();
+					continue;
+				}
+				if (!message->valid()) corrupted++;
+				pool.destroy(message);
+				consumed++;
+			}
+		});
+	}
+	for (std::thread& thread : threads) thread.join();
+
+	EXPECT_EQ(producers * messagesPerProducer, consumed.load());
+	EXPECT_EQ(0, corrupted.load());
+
+	// Every slot is back on the free list
+	std::vector<void*> slots;
+	for (size_t i = 0; i < pool.getCapacity(); i++) slots.push_back(pool.allocate());
+	std::set<void*> unique(slots.begin(), slots.end());
+	EXPECT_EQ(slots.size(), unique.size());
+	for (void* slot : slots) pool.deallocate(slot);
+}
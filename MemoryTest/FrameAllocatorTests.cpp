@@ -0,0 +1,63 @@
+#include "pch.h"
+
+#include "JupiterFrameAllocator.h"
+
+using namespace Jupiter;
+
+TEST(FrameAllocatorTests, Lifetime) {
+	FrameAllocator<3> allocator(1024);
+
+	// Every frame allocates from its own arena
+	uint32* frame0 = reinterpret_cast<uint32*>(allocator.allocate(sizeof(uint32)));
+	*frame0 = 0xF0;
+	allocator.beginFrame();
+	uint32* frame1 = reinterpret_cast<uint32*>(allocator.allocate(sizeof(uint32)));
+	*frame1 = 0xF1;
+	allocator.beginFrame();
+	uint32* frame2 = reinterpret_cast<uint32*>(allocator.allocate(sizeof(uint32)));
+	*frame2 = 0xF2;
+	EXPECT_TRUE(allocator.owns(frame0));
+	EXPECT_TRUE(allocator.owns(frame2));
+
+	// Blocks of the last N frames are still alive
+	EXPECT_EQ(0xF0, *frame0);
+	EXPECT_EQ(0xF1, *frame1);
+	EXPECT_EQ(2, allocator.getFrame());
+
+	// The fourth frame reuses the arena of the first frame
+	allocator.beginFrame();
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_EQ(frame0, allocator.allocate(sizeof(uint32)));
+	EXPECT_EQ(0xF1, *frame1);
+	EXPECT_EQ(0xF2, *frame2);
+
+	int value = 0;
+	EXPECT_FALSE(allocator.owns(&value));
+	EXPECT_THROW(allocator.deallocate(frame1), jpt_bad_free);
+}
+
+TEST(FrameAllocatorTests, Watermark) {
+	FrameAllocator<2> allocator(4096);
+
+	allocator.allocate(1000);
+	allocator.beginFrame();
+	EXPECT_LE(1000, allocator.getLastFrameUsedMemory());
+	size_t first = allocator.getHighWatermark();
+
+	// A smaller frame does not lower the watermark, a larger frame raises it before it has ended
+	allocator.allocate(100);
+	allocator.beginFrame();
+	EXPECT_EQ(first, allocator.getHighWatermark());
+	allocator.allocate(3000);
+	allocator.allocate(10);
+	EXPECT_LE(3010, allocator.getHighWatermark());
+	EXPECT_EQ(2, allocator.getAllocationsHighWatermark());
+
+	// A frame that does not fit its arena throws, so the watermark shows how far the budget is off
+	EXPECT_THROW(allocator.allocate(2000), std::bad_alloc);
+	EXPECT_EQ(nullptr, allocator.tryAllocate(2000));
+
+	allocator.beginFrame();
+	allocator.resetHighWatermark();
+	EXPECT_EQ(0, allocator.getHighWatermark());
+}
@@ -0,0 +1,104 @@
+#include "pch.h"
+
+#include "JupiterInlineStackAllocator.h"
+
+using namespace Jupiter;
+
+static_assert(StaticAllocator<InlineStackAllocator<256>>);
+static_assert(alignof(InlineStackAllocator<256, 64>) == 64);
+
+TEST(InlineStackAllocatorTests, Buffer) {
+	InlineStackAllocator<256> allocator;
+
+	// Blocks are taken from the embedded buffer
+	void* p0 = allocator.allocate(100, 8);
+	void* p1 = allocator.allocate(100, 16);
+	EXPECT_TRUE(allocator.owns(p0));
+	EXPECT_TRUE(allocator.owns(p1));
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p1) & 15);
+	EXPECT_EQ(0, allocator.getOverflows());
+
+	// Without a parent a full buffer throws
+	EXPECT_EQ(nullptr, allocator.tryAllocate(100));
+	EXPECT_THROW(allocator.allocate(100), std::bad_alloc);
+
+	// The most recent block is popped, so the next block takes its place
+	allocator.deallocate(p1);
+	EXPECT_EQ(1, allocator.getAllocations());
+	EXPECT_EQ(p1, allocator.allocate(100, 16));
+
+	// The most recent block can grow in place
+	EXPECT_TRUE(allocator.tryResize(p1, 120));
+	EXPECT_FALSE(allocator.tryResize(p0, 120));
+	EXPECT_FALSE(allocator.tryResize(p1, 256));
+
+	allocator.clear();
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_EQ(p0, allocator.allocate(100, 8));
+
+	int value = 0;
+	EXPECT_THROW(allocator.deallocate(&value), jpt_bad_free);
+
+	// A block of size zero does not fit when only its header would, it would start right after the buffer
+	allocator.clear();
+	void* full = allocator.allocate(InlineStackAllocator<256>::Capacity - 2 * InlineStackAllocator<256>::HeaderSize, 4);
+	EXPECT_EQ(InlineStackAllocator<256>::HeaderSize, allocator.getFreeMemory());
+	EXPECT_EQ(nullptr, allocator.tryAllocate(0));
+	EXPECT_THROW(allocator.allocate(0), std::bad_alloc);
+	allocator.deallocate(full);
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(InlineStackAllocatorTests, Lifo) {
+	InlineStackAllocator<256> allocator;
+
+	// Blocks freed in reverse order pop one after the other, the buffer is reused every iteration
+	for (uint32 i = 0; i < 1000; i++) {
+		void* a = allocator.allocate(64, 16);
+		void* b = allocator.allocate(64, 16);
+		allocator.deallocate(b);
+		allocator.deallocate(a);
+		EXPECT_EQ(0, allocator.getUsedMemory());
+		EXPECT_EQ(0, allocator.getAllocations());
+	}
+
+	// A block freed out of order is popped once the block above it is freed
+	void* a = allocator.allocate(32);
+	size_t usedByA = allocator.getUsedMemory();
+	void* b = allocator.allocate(32);
+	void* c = allocator.allocate(32);
+	size_t used = allocator.getUsedMemory();
+	allocator.deallocate(b);
+	EXPECT_EQ(used, allocator.getUsedMemory());
+	EXPECT_EQ(2, allocator.getAllocations());
+	EXPECT_THROW(allocator.deallocate(b), jpt_bad_free);
+
+	allocator.deallocate(c);
+	EXPECT_EQ(usedByA, allocator.getUsedMemory());
+	EXPECT_TRUE(allocator.tryResize(a, 64));
+	allocator.deallocate(a);
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(InlineStackAllocatorTests, Overflow) {
+	BlockAllocator parent(64 * 1024);
+	InlineStackAllocator<128> allocator(&parent);
+
+	void* p0 = allocator.allocate(100);
+	void* p1 = allocator.allocate(100);
+	EXPECT_TRUE(allocator.owns(p0));
+	EXPECT_FALSE(allocator.owns(p1));
+	EXPECT_TRUE(parent.owns(p1));
+	EXPECT_EQ(1, allocator.getOverflows());
+
+	// Blocks of the parent are resized and returned by the parent
+	EXPECT_TRUE(allocator.tryResize(p1, 1000));
+	uint8* moved = reinterpret_cast<uint8*>(allocator.reallocate(p0, 100, 200));
+	EXPECT_TRUE(parent.owns(moved));
+	EXPECT_EQ(2, parent.getAllocations());
+
+	allocator.deallocate(p1);
+	allocator.deallocate(moved);
+	EXPECT_EQ(0, parent.getAllocations());
+}
@@ -0,0 +1,80 @@
+#include "pch.h"
+
+#include "JupiterMemoryResource.h"
+
+#include <memory_resource>
+#include <string>
+
+using namespace Jupiter;
+
+TEST(MemoryResourceTests, StackVector) {
+	StackAllocator allocator(64 * 1024);
+	{
+		JupiterMemoryResource resource(allocator);
+		EXPECT_EQ(EnumDeallocateRoute::Ignore, resource.getRoute());
+
+		// Growing the vector deallocates its old buffer, the stack allocator would throw if the deallocation was passed on
+		std::pmr::vector<uint32> values(&resource);
+		for (uint32 i = 0; i < 1000; i++) values.push_back(i);
+		for (uint32 i = 0; i < 1000; i++) EXPECT_EQ(i, values[i]);
+		EXPECT_LT(1000 * sizeof(uint32), allocator.getUsedMemory());
+	}
+	allocator.clear();
+	EXPECT_EQ(0, allocator.getUsedMemory());
+}
+
+TEST(MemoryResourceTests, BlockSet) {
+	BlockAllocator allocator(1024 * 1024);
+	{
+		JupiterMemoryResource resource(allocator);
+		std::pmr::set<std::pmr::string> strings(&resource);
+		for (uint32 i = 0; i < 500; i++) strings.insert(std::pmr::string("a string long enough to not fit in the small buffer " + std::to_string(i), &resource));
+		EXPECT_EQ(500, strings.size());
+		EXPECT_EQ(1, strings.count("a string long enough to not fit in the small buffer 42"));
+
+		for (uint32 i = 0; i < 500; i += 2) strings.erase(std::pmr::string("a string long enough to not fit in the small buffer " + std::to_string(i), &resource));
+		EXPECT_EQ(250, strings.size());
+	}
+	// Every node and string was passed back to the block allocator
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(MemoryResourceTests, UnsizedPool) {
+	PoolAllocator<uint64> allocator(16, false);
+	JupiterMemoryResource resource(allocator, EnumDeallocateRoute::Unsized);
+
+	void* p0 = resource.allocate(sizeof(uint64), alignof(uint64));
+	void* p1 = resource.allocate(sizeof(uint64), alignof(uint64));
+	EXPECT_EQ(2, allocator.getAllocations());
+	resource.deallocate(p0, sizeof(uint64), alignof(uint64));
+	resource.deallocate(p1, sizeof(uint64), alignof(uint64));
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(MemoryResourceTests, OverAligned) {
+	BlockAllocator allocator(1024 * 1024);
+	JupiterMemoryResource resource(allocator);
+
+	for (size_t alignment = 256; alignment <= 4096; alignment <<= 1) {
+		void* p = resource.allocate(100, alignment);
+		EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p) & (alignment - 1));
+		memset(p, 0xAB, 100);
+		resource.deallocate(p, 100, alignment);
+	}
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(MemoryResourceTests, IsEqual) {
+	BlockAllocator block(64 * 1024);
+	StackAllocator stack(64 * 1024);
+
+	JupiterMemoryResource resource0(block);
+	JupiterMemoryResource resource1(block);
+	JupiterMemoryResource resource2(block, EnumDeallocateRoute::Unsized);
+	JupiterMemoryResource resource3(stack);
+
+	EXPECT_TRUE(resource0 == resource1);
+	EXPECT_FALSE(resource0 == resource2);
+	EXPECT_FALSE(resource0 == resource3);
+	EXPECT_FALSE(resource0 == *std::pmr::new_delete_resource());
+}
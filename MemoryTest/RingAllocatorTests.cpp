@@ -0,0 +1,158 @@
+#include "pch.h"
+
+#include "JupiterRingAllocator.h"
+#include "JupiterAllocatorExceptions.h"
+#include "JupiterVirtualMemory.h"
+
+#include <thread>
+#include <vector>
+
+using namespace Jupiter;
+
+TEST(RingAllocatorTests, AllocateFree) {
+	RingAllocator allocator(virtual_memory::page_size());
+	EXPECT_EQ(virtual_memory::page_size(), allocator.getCapacity());
+
+	void* a = allocator.allocate(10);
+	void* b = allocator.allocate(100, 64);
+	void* c = allocator.allocate(8);
+	EXPECT_TRUE(allocator.owns(a));
+	EXPECT_EQ(0, (uintptr_t)a % RingAllocator::RecordAlignment);
+	EXPECT_EQ(0, (uintptr_t)b % 64);
+	EXPECT_EQ(3, allocator.getAllocations());
+
+	// Freeing a record that is not the oldest only marks it, the tail moves once the oldest record is freed
+	size_t used = allocator.getUsedMemory();
+	allocator.deallocate(b);
+	EXPECT_EQ(used, allocator.getUsedMemory());
+	allocator.deallocate(a);
+	EXPECT_EQ(RingAllocator::HeaderSize + 8, allocator.getUsedMemory());
+	allocator.deallocate(c);
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_EQ(0, allocator.getAllocations());
+
+	EXPECT_THROW(allocator.deallocate(c), jpt_bad_free);
+	int onStack = 0;
+	EXPECT_THROW(allocator.deallocate(&onStack), jpt_bad_free);
+
+	// The address right after the ring is not a record of it
+	uint8* start = reinterpret_cast<uint8*>(a) - RingAllocator::HeaderSize;
+	EXPECT_THROW(allocator.deallocate(start + allocator.getCapacity()), jpt_bad_free);
+}
+
+TEST(RingAllocatorTests, Wrap) {
+	const size_t capacity = virtual_memory::page_size();
+	RingAllocator allocator(capacity);
+	uint8* start = nullptr;			// The first record starts at the start of the ring
+
+	// Records of an odd size go around the ring many times, no record ever crosses the end
+	std::vector<std::pair<uint8*, size_t>> records;
+	for (uint32 i = 0; i < 1000; i++) {
+		size_t size = 24 + (i * 37) % 300;
+		uint8* p = reinterpret_cast<uint8*>(allocator.tryAllocate(size));
+		while (p == nullptr) {
+			allocator.deallocate(records.front().first);
+			records.erase(records.begin());
+			p = reinterpret_cast<uint8*>(allocator.tryAllocate(size));
+		}
+		if (i == 0) start = p - RingAllocator::HeaderSize;
+		EXPECT_GE(p, start + RingAllocator::HeaderSize);
+		EXPECT_LE(p + size, start + capacity);
+		memset(p, (int)(i & 0xFF), size);
+		records.push_back({ p, size });
+	}
+
+	for (auto& record : records) allocator.deallocate(record.first);
+	EXPECT_EQ(0, allocator.getUsedMemory());
+
+	// A record of size zero with the head in the last bytes of the ring starts over at the start, its payload lies inside of the ring
+	allocator.clear();
+	allocator.deallocate(allocator.allocate(capacity - 2 * RingAllocator::HeaderSize));
+	void* empty = allocator.allocate(0);
+	EXPECT_TRUE(allocator.owns(empty));
+	EXPECT_EQ(start + RingAllocator::HeaderSize, empty);
+	allocator.deallocate(empty);
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(RingAllocatorTests, Full) {
+	RingAllocator allocator(virtual_memory::page_size());
+	size_t size = allocator.getCapacity() / 4 - RingAllocator::HeaderSize;
+
+	void* records[4];
+	for (void*& record : records) record = allocator.allocate(size);
+	EXPECT_EQ(allocator.getCapacity(), allocator.getUsedMemory());
+	EXPECT_EQ(nullptr, allocator.tryAllocate(1));
+	EXPECT_THROW(allocator.allocate(1), std::bad_alloc);
+	EXPECT_EQ(nullptr, allocator.tryAllocate(allocator.getCapacity()));
+
+	// Room freed at the tail is reused once the head wraps around
+	allocator.deallocate(records[0]);
+	EXPECT_EQ(records[0], allocator.allocate(size));
+
+	allocator.clear();
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_EQ(0, allocator.getAllocations());
+#ifdef MEMORY_ALLOCATOR_STATS
+	EXPECT_EQ(0, allocator.getStats()->getCurrentBytes());
+	EXPECT_EQ(0, allocator.getStats()->getCurrentAllocations());
+#endif //MEMORY_ALLOCATOR_STATS
+}
+
+TEST(RingAllocatorTests, SingleProducerSingleConsumer) {
+	SpscRingAllocator allocator(16 * 1024);
+	const uint32 messages = 200000;
+
+	// An empty message with the head in the last bytes of the ring is received inside of the ring
+	size_t size;
+	void* large = allocator.allocate(allocator.getCapacity() - 2 * RingAllocator::HeaderSize);
+	allocator.publish();
+	EXPECT_EQ(large, allocator.receive(size));
+	allocator.deallocate(large);
+	void* empty = allocator.allocate(0);
+	allocator.publish();
+	EXPECT_EQ(empty, allocator.receive(size));
+	EXPECT_EQ(0, size);
+	EXPECT_TRUE(allocator.owns(empty));
+	allocator.deallocate(empty);
+
+	// Every message carries its sequence number and a size derived from it, the consumer checks both
+	std::thread producer([&allocator, messages]() {
+		for (uint32 i = 0; i < messages; i++) {
+			size_t size = sizeof(uint32) * (1 + i % 61);
+			void* p;
+			while ((p = allocator.tryAllocate(size)) == nullptr) {
+				allocator.publish();
+				std::this_thread::yield();
+			}
+			uint32* words = reinterpret_cast<uint32*>(p);
+			for (size_t w = 0; w < size / sizeof(uint32); w++) words[w] = i;
+			if (i % 8 == 0) allocator.publish();
+		}
+		allocator.publish();
+	});
+
+	uint32 received = 0;
+	bool ordered = true;
+	while (received < messages) {
+		size_t size;
+		void* p = allocator.receive(size);
+		if (p == nullptr) {
+			std::this_thread::yield();
+			continue;
+		}
+
+		const uint32* words = reinterpret_cast<const uint32*>(p);
+		if (size != sizeof(uint32) * (1 + received % 61)) ordered = false;
+		for (size_t w = 0; w < size / sizeof(uint32); w++) {
+			if (words[w] != received) ordered = false;
+		}
+		allocator.deallocate(p);
+		received++;
+	}
+	producer.join();
+
+	EXPECT_TRUE(ordered);
+	EXPECT_EQ(nullptr, allocator.receive(size));
+}
@@ -0,0 +1,96 @@
+#include "pch.h"
+
+#include "JupiterScratchArena.h"
+
+#include <thread>
+
+using namespace Jupiter;
+
+// Sums the values in a temporary copy, allocated on the arena passed in
+static uint64 sumCopy(StackAllocator& arena, const uint32* values, size_t count) {
+	ScratchScope scope(arena);
+	uint32* copy = reinterpret_cast<uint32*>(scope.allocate(count * sizeof(uint32), 4));
+	uint64 sum = 0;
+	for (size_t i = 0; i < count; i++) copy[i] = values[i];
+	for (size_t i = 0; i < count; i++) sum += copy[i];
+	return sum;
+}
+
+TEST(ScratchArenaTests, NestedScopes) {
+	StackAllocator& arena = scratch_arena::get();
+	void* top = arena.getState().top;
+
+	{
+		ScratchScope outer;
+		void* p0 = outer.allocate(1000, 16);
+		EXPECT_TRUE(arena.owns(p0));
+
+		{
+			ScratchScope inner(outer.getArena());
+			void* p1 = inner.allocate(1000, 16);
+			EXPECT_LT(p0, p1);
+			EXPECT_EQ(2, arena.getAllocations());
+		}
+
+		// The inner scope freed its block without leaving a gap, the next block takes its place
+		EXPECT_EQ(1, arena.getAllocations());
+		void* p2 = outer.allocate(1000, 16);
+		{
+			ScratchScope inner;
+			EXPECT_LT(p2, inner.allocate(16));
+		}
+	}
+
+	EXPECT_EQ(top, arena.getState().top);
+	EXPECT_EQ(0, arena.getUsedMemory());
+}
+
+TEST(ScratchArenaTests, ResizeInsideScope) {
+	StackAllocator arena(4096);
+	uint8* p = reinterpret_cast<uint8*>(arena.allocate(16, 16));
+
+	// A block allocated before the scope cannot grow inside of it, the scope would hand the grown part out again
+	{
+		ScratchScope scope(arena);
+		EXPECT_FALSE(arena.tryResize(p, 256));
+	}
+	uint8* q = reinterpret_cast<uint8*>(arena.allocate(64));
+	EXPECT_LE(p + 16, q);
+
+	// Closing the scope makes the block the most recent allocation again, so it grows once nothing lies after it
+	uint8* r;
+	{
+		ScratchScope scope(arena);
+		r = reinterpret_cast<uint8*>(arena.allocate(16, 16));
+	}
+	EXPECT_TRUE(arena.tryResize(q, 128));
+	EXPECT_LE(q + 128, reinterpret_cast<uint8*>(arena.allocate(16)));
+	EXPECT_LE(q + 64, r);
+	arena.clear();
+}
+
+TEST(ScratchArenaTests, PassThrough) {
+	uint32 values[256];
+	for (uint32 i = 0; i < 256; i++) values[i] = i;
+
+	ScratchScope scope;
+	size_t used = scope.getArena().getUsedMemory();
+	EXPECT_EQ(255 * 256 / 2, sumCopy(scope.getArena(), values, 256));
+	EXPECT_EQ(used, scope.getArena().getUsedMemory());
+}
+
+TEST(ScratchArenaTests, PerThread) {
+	StackAllocator* mainArena = &scratch_arena::get();
+	StackAllocator* threadArena = nullptr;
+
+	std::thread thread([&]() {
+		ScratchScope scope;
+		threadArena = &scope.getArena();
+		scope.allocate(1024);
+	});
+	thread.join();
+
+	EXPECT_NE(nullptr, threadArena);
+	EXPECT_NE(mainArena, threadArena);
+	EXPECT_EQ(0, mainArena->getAllocations());
+}
@@ -0,0 +1,118 @@
+#include "pch.h"
+
+#include "JupiterSlabAllocator.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace Jupiter;
+
+TEST(SlabAllocatorTests, SizeClasses) {
+	EXPECT_EQ(0, SlabAllocator::sizeClassIndex(1));
+	EXPECT_EQ(0, SlabAllocator::sizeClassIndex(8));
+	EXPECT_EQ(1, SlabAllocator::sizeClassIndex(9));
+	EXPECT_EQ(4, SlabAllocator::sizeClassIndex(33));
+	EXPECT_EQ(SlabAllocator::SizeClassCount - 1, SlabAllocator::sizeClassIndex(512));
+
+	// Every size maps to the smallest class it fits in
+	for (size_t size = 1; size <= SlabAllocator::MaxSize; size++) {
+		uint32 sizeClass = SlabAllocator::sizeClassIndex(size);
+		EXPECT_LE(size, SlabAllocator::sizeClassSize(sizeClass));
+		if (sizeClass > 0) {
+			EXPECT_GT(size, SlabAllocator::sizeClassSize(sizeClass - 1));
+		}
+	}
+}
+
+TEST(SlabAllocatorTests, AllocateDeallocate) {
+	SlabAllocator allocator;
+
+	void* p0 = allocator.allocate(20, 4);
+	void* p1 = allocator.allocate(20, 4);
+	void* p2 = allocator.allocate(300, 8);
+	EXPECT_EQ(2, allocator.getSlabCount());
+	EXPECT_EQ(24 + 24 + 320, allocator.getUsedMemory());
+	EXPECT_EQ(24, reinterpret_cast<uint8*>(p1) - reinterpret_cast<uint8*>(p0));
+	EXPECT_TRUE(allocator.owns(p0));
+	EXPECT_TRUE(allocator.owns(p2));
+
+	int value = 0;
+	EXPECT_FALSE(allocator.owns(&value));
+	EXPECT_THROW(allocator.allocate(513), std::bad_alloc);
+	EXPECT_EQ(nullptr, allocator.tryAllocate(513));
+
+	// A freed slot is handed out again first
+	allocator.deallocate(p1);
+	EXPECT_EQ(p1, allocator.allocate(24));
+
+	allocator.deallocate(p0, 20);
+	allocator.deallocate(p1);
+	allocator.deallocate(p2, 300);
+	EXPECT_EQ(0, allocator.getAllocations());
+	EXPECT_EQ(0, allocator.getUsedMemory());
+	EXPECT_THROW(allocator.deallocate(p2, 1024), jpt_bad_free);
+}
+
+TEST(SlabAllocatorTests, Alignment) {
+	SlabAllocator allocator;
+
+	// A 24 byte request aligned to 16 moves up to the 32 byte class, cache line alignment needs a multiple of 64
+	void* p0 = allocator.allocate(24, 16);
+	void* p1 = allocator.allocate(24, 16);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p0) & 15);
+	EXPECT_EQ(32, reinterpret_cast<uint8*>(p1) - reinterpret_cast<uint8*>(p0));
+
+	void* p2 = allocator.allocate(10, 64);
+	EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p2) & 63);
+	EXPECT_EQ(nullptr, allocator.tryAllocate(10, 128));
+
+	allocator.deallocate(p0);
+	allocator.deallocate(p1);
+	allocator.deallocate(p2);
+}
+
+TEST(SlabAllocatorTests, ReleaseEmptySlabs) {
+	SlabAllocator allocator;
+	std::vector<void*> blocks;
+
+	// Fill a couple of slabs of a single size class
+	size_t perSlab = (SlabAllocator::SlabSize - SlabAllocator::SlabAlignment) / 64;
+	for (size_t i = 0; i < perSlab * 4; i++) {
+		void* p = allocator.allocate(64);
+		memset(p, 0xCD, 64);
+		blocks.push_back(p);
+	}
+	EXPECT_EQ(4, allocator.getSlabCount());
+
+	// Free everything in random order, all slabs but the last one are returned to the system
+	std::shuffle(blocks.begin(), blocks.end(), std::mt19937(42));
+	for (void* p : blocks) allocator.deallocate(p);
+	EXPECT_EQ(1, allocator.getSlabCount());
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(SlabAllocatorTests, MixedSizes) {
+	SlabAllocator allocator;
+	std::mt19937 random(7);
+	std::vector<std::pair<uint8*, size_t>> blocks;
+
+	for (uint32 i = 0; i < 100000; i++) {
+		if (blocks.empty() || random() % 3 != 0) {
+			size_t size = 1 + random() % SlabAllocator::MaxSize;
+			uint8* p = reinterpret_cast<uint8*>(allocator.allocate(size));
+			memset(p, (int)(size & 0xFF), size);
+			blocks.push_back({ p, size });
+		}
+		else {
+			size_t index = random() % blocks.size();
+			auto [p, size] = blocks[index];
+			for (size_t k = 0; k < size; k++) ASSERT_EQ((uint8)(size & 0xFF), p[k]);
+			allocator.deallocate(p, size);
+			blocks[index] = blocks.back();
+			blocks.pop_back();
+		}
+	}
+	EXPECT_EQ(blocks.size(), allocator.getAllocations());
+	for (auto [p, size] : blocks) allocator.deallocate(p, size);
+	EXPECT_EQ(0, allocator.getAllocations());
+}
@@ -0,0 +1,110 @@
+#include "pch.h"
+
+#include "JupiterSlotMap.h"
+
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace Jupiter;
+
+TEST(SlotMapTests, InsertErase) {
+	MallocAllocator heap;
+	SlotMap<int> map(heap);
+
+	slot_handle a = map.insert(1);
+	slot_handle b = map.insert(2);
+	slot_handle c = map.insert(3);
+	EXPECT_EQ(3, map.size());
+	EXPECT_EQ(1, *map.get(a));
+	EXPECT_EQ(3, *map.get(c));
+	EXPECT_FALSE(map.contains(slot_handle()));
+
+	// The last object moves into the hole, the dense array stays without gaps
+	EXPECT_TRUE(map.erase(a));
+	EXPECT_EQ(2, map.size());
+	EXPECT_EQ(3, map[0]);
+	EXPECT_EQ(2, map[1]);
+	EXPECT_EQ(c, map.handleAt(0));
+	EXPECT_EQ(3, *map.get(c));
+	EXPECT_EQ(2, *map.get(b));
+
+	// A stale handle no longer matches, not even once its slot is reused
+	EXPECT_EQ(nullptr, map.get(a));
+	EXPECT_FALSE(map.erase(a));
+	slot_handle d = map.insert(4);
+	EXPECT_EQ(a.index, d.index);
+	EXPECT_NE(a.generation, d.generation);
+	EXPECT_EQ(nullptr, map.get(a));
+	EXPECT_EQ(4, *map.get(d));
+
+	int sum = 0;
+	for (int value : map) sum += value;
+	EXPECT_EQ(2 + 3 + 4, sum);
+
+	map.clear();
+	EXPECT_TRUE(map.empty());
+	EXPECT_FALSE(map.contains(b));
+	EXPECT_FALSE(map.contains(d));
+}
+
+TEST(SlotMapTests, Objects) {
+	struct counted {
+		std::string name;
+		int* alive;
+
+		counted(const std::string& name, int* alive) : name(name), alive(alive) { (*alive)++; }
+		counted(counted&& other) noexcept : name(std::move(other.name)), alive(other.alive) { (*alive)++; }
+		counted& operator=(counted&& other) noexcept { name = std::move(other.name); return *this; }
+		~counted() { (*alive)--; }
+	};
+
+	int alive = 0;
+	BlockAllocator allocator(1024 * 1024);
+	{
+		SlotMap<counted> map(allocator, 4);
+		std::vector<slot_handle> handles;
+		for (int i = 0; i < 100; i++) handles.push_back(map.emplace("object " + std::to_string(i), &alive));
+		EXPECT_EQ(100, alive);
+		EXPECT_LE(100, map.capacity());
+
+		// Growing moved the objects, every handle still finds its own object
+		for (int i = 0; i < 100; i++) EXPECT_EQ("object " + std::to_string(i), map.get(handles[i])->name);
+
+		for (int i = 0; i < 100; i += 3) map.erase(handles[i]);
+		EXPECT_EQ(66, alive);
+		EXPECT_EQ(66, map.size());
+	}
+	EXPECT_EQ(0, alive);
+	EXPECT_EQ(0, allocator.getAllocations());
+}
+
+TEST(SlotMapTests, Random) {
+	MallocAllocator heap;
+	SlotMap<uint64> map(heap);
+	std::unordered_map<uint64, slot_handle> expected;
+	std::vector<slot_handle> erased;
+	std::mt19937 random(5);
+
+	for (uint64 i = 0; i < 20000; i++) {
+		if (expected.empty() || random() % 3 != 0) {
+			expected[i] = map.insert(i);
+		}
+		else {
+			auto it = std::next(expected.begin(), random() % expected.size());
+			EXPECT_TRUE(map.erase(it->second));
+			erased.push_back(it->second);
+			expected.erase(it);
+		}
+	}
+
+	EXPECT_EQ(expected.size(), map.size());
+	for (auto [value, handle] : expected) {
+		ASSERT_NE(nullptr, map.get(handle));
+		EXPECT_EQ(value, *map.get(handle));
+	}
+	for (slot_handle handle : erased) EXPECT_FALSE(map.contains(handle));
+
+	// Every object in the dense array is reachable through its handle
+	for (size_t i = 0; i < map.size(); i++) EXPECT_EQ(&map[i], map.get(map.handleAt(i)));
+}
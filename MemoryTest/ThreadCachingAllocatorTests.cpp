@@ -0,0 +1,116 @@
+#include "pch.h"
+
+#include "JupiterThreadCachingAllocator.h"
+
+#include <thread>
+
+using namespace Jupiter;
+
+TEST(ThreadCachingAllocatorTests, SizeClasses) {
+	EXPECT_EQ(0, ThreadCachingAllocator::sizeClassIndex(1));
+	EXPECT_EQ(0, ThreadCachingAllocator::sizeClassIndex(16));
+	EXPECT_EQ(1, ThreadCachingAllocator::sizeClassIndex(17));
+	EXPECT_EQ(15, ThreadCachingAllocator::sizeClassIndex(256));
+	EXPECT_EQ(16, ThreadCachingAllocator::sizeClassIndex(257));
+	EXPECT_EQ(ThreadCachingAllocator::SizeClassCount - 1, ThreadCachingAllocator::sizeClassIndex(ThreadCachingAllocator::MaxCachedSize));
+
+	// Every size fits in its class, and does not fit in the class before it
+	for (size_t size = 1; size <= ThreadCachingAllocator::MaxCachedSize; size++) {
+		uint32 sizeClass = ThreadCachingAllocator::sizeClassIndex(size);
+		ASSERT_LE(size, ThreadCachingAllocator::sizeClassSize(sizeClass));
+		if (sizeClass > 0) {
+			ASSERT_GT(size, ThreadCachingAllocator::sizeClassSize(sizeClass - 1));
+		}
+	}
+}
+
+TEST(ThreadCachingAllocatorTests, AllocateDeallocate) {
+	BlockAllocator backend(4 * 1024 * 1024);
+	{
+		ThreadCachingAllocator allocator(backend);
+
+		void* p0 = allocator.allocate(24);
+		void* p1 = allocator.allocate(1000);
+		void* p2 = allocator.allocate(100 * 1024);
+		void* p3 = allocator.allocate(64, 128);
+		EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p0) % ThreadCachingAllocator::HeaderSize);
+		EXPECT_EQ(0, reinterpret_cast<uintptr_t>(p3) % 128);
+
+		// A deallocated block is handed out again by the same thread
+		allocator.deallocate(p0);
+		EXPECT_EQ(p0, allocator.allocate(20));
+
+		allocator.deallocate(p0);
+		allocator.deallocate(p1, 1000);
+		allocator.deallocate(p2);
+		allocator.deallocate(p3);
+	}
+
+	// Every block is returned to the backend when the allocator is destroyed
+	EXPECT_EQ(0, backend.getAllocations());
+}
+
+TEST(ThreadCachingAllocatorTests, RemoteFree) {
+	BlockAllocator backend(16 * 1024 * 1024);
+	{
+		ThreadCachingAllocator allocator(backend);
+		const size_t count = 10000;
+		std::vector<void*> blocks(count);
+
+		// Allocate on another thread and free on this one, the blocks go through the remote free queue
+		std::thread producer([&]() {
+			for (size_t i = 0; i < count; i++) {
+				blocks[i] = allocator.allocate(16 + (i % 64) * 8);
+				memset(blocks[i], (int)(i & 0xFF), 16);
+			}
+		});
+		producer.join();
+
+		for (size_t i = 0; i < count; i++) {
+			EXPECT_EQ((uint8)(i & 0xFF), *reinterpret_cast<uint8*>(blocks[i]));
+			allocator.deallocate(blocks[i]);
+		}
+
+		// A new thread adopts the cache left behind and picks up the remote frees
+		std::thread adopter([&]() {
+			void* p = allocator.allocate(16);
+			allocator.deallocate(p);
+		});
+		adopter.join();
+	}
+	EXPECT_EQ(0, backend.getAllocations());
+}
+
+TEST(ThreadCachingAllocatorTests, MultiThreaded) {
+	BlockAllocator backend(64 * 1024 * 1024);
+	{
+		ThreadCachingAllocator allocator(backend);
+		const uint32 threadCount = 8;
+		std::vector<std::thread> threads;
+
+		for (uint32 t = 0; t < threadCount; t++) {
+			threads.emplace_back([&allocator, t]() {
+				std::vector<std::pair<uint8*, size_t>> blocks;
+				uint32 seed = t + 1;
+				for (uint32 i = 0; i < 20000; i++) {
+					seed = seed * 1664525u + 1013904223u;
+					if (blocks.size() < 256 && (blocks.empty() || (seed >> 16) % 2 == 0)) {
+						size_t size = 1 + (seed >> 8) % 2048;
+						uint8* p = reinterpret_cast<uint8*>(allocator.allocate(size));
+						memset(p, (int)t, size);
+						blocks.push_back({ p, size });
+					}
+					else {
+						auto block = blocks.back();
+						blocks.pop_back();
+						for (size_t j = 0; j < block.second; j++) ASSERT_EQ((uint8)t, block.first[j]);
+						allocator.deallocate(block.first);
+					}
+				}
+				for (auto& block : blocks) allocator.deallocate(block.first);
+			});
+		}
+		for (std::thread& thread : threads) thread.join();
+	}
+	EXPECT_EQ(0, backend.getAllocations());
+}
@@ -0,0 +1,155 @@
+#include "pch.h"
+
+#include "JupiterTrackingAllocator.h"
+
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+using namespace Jupiter;
+
+namespace {
+
+	std::string s_LastReport;
+
+	void record_report(const TrackingAllocator& allocator) {
+		std::ostringstream stream;
+		allocator.dumpLeaks(stream);
+		s_LastReport = stream.str();
+	}
+}
+
+TEST(TrackingAllocatorTests, Records) {
+	BlockAllocator block(64 * 1024);
+	TrackingAllocator allocator(block);
+
+	uint32 line = __LINE__ + 1;
+	void* p0 = allocator.allocate(100, 8, "physics");
+	void* p1 = allocator.allocate(200);
+
+	const TrackingAllocator::allocation_record* record = allocator.find(p0);
+	ASSERT_NE(nullptr, record);
+	EXPECT_STREQ("physics", record->tag);
+	EXPECT_EQ(100, record->size);
+	EXPECT_EQ(line, record->line);
+	EXPECT_NE(nullptr, strstr(record->file, "TrackingAllocatorTests"));
+
+	// Blocks allocated through the IAllocator interface get the current tag and no call site
+	EXPECT_STREQ(TrackingAllocator::DefaultTag, allocator.find(p1)->tag);
+	EXPECT_EQ(0, allocator.find(p1)->line);
+	EXPECT_EQ(2, allocator.getLiveAllocations());
+	EXPECT_EQ(300, allocator.getLiveBytes());
+
+	allocator.deallocate(p0);
+	allocator.deallocate(p1, 200);
+	EXPECT_EQ(nullptr, allocator.find(p0));
+	EXPECT_EQ(0, allocator.getLiveAllocations());
+	EXPECT_EQ(0, allocator.getLiveBytes());
+	EXPECT_EQ(0, block.getAllocations());
+}
+
+TEST(TrackingAllocatorTests, BadFree) {
+	BlockAllocator block(64 * 1024);
+	TrackingAllocator allocator(block);
+
+	// Blocks of the wrapped allocator that did not go through the tracker are rejected, and left alone
+	void* untracked = block.allocate(64);
+	EXPECT_THROW(allocator.deallocate(untracked), jpt_bad_free);
+	EXPECT_EQ(1, block.getAllocations());
+	block.deallocate(untracked);
+}
+
+TEST(TrackingAllocatorTests, Resize) {
+	BlockAllocator block(64 * 1024);
+	TrackingAllocator allocator(block);
+
+	void* p = allocator.allocate(64, 8, "strings");
+	void* next = allocator.allocate(64, 8, "strings");
+	if (allocator.tryResize(p, 32)) {
+		EXPECT_EQ(32, allocator.find(p)->size);
+	}
+
+	// A moved block keeps its tag and call site
+	uint32 line = allocator.find(p)->line;
+	void* moved = allocator.reallocate(p, allocator.find(p)->size, 4096, 8);
+	EXPECT_EQ(4096, allocator.find(moved)->size);
+	EXPECT_EQ(line, allocator.find(moved)->line);
+	EXPECT_STREQ("strings", allocator.find(moved)->tag);
+	EXPECT_EQ(2, allocator.getLiveAllocations());
+
+	allocator.deallocate(moved);
+	allocator.deallocate(next);
+	EXPECT_EQ(0, block.getAllocations());
+}
+
+TEST(TrackingAllocatorTests, Table) {
+	MallocAllocator heap;
+	TrackingAllocator allocator(heap, 4);
+	std::unordered_map<void*, size_t> live;
+	std::mt19937 random(7);
+
+	// Grow the table and free in random order, every live block stays findable after the records shift around
+	std::vector<void*> blocks;
+	for (uint32 i = 0; i < 50000; i++) {
+		if (blocks.empty() || random() % 3 != 0) {
+			size_t size = 1 + random() % 128;
+			void* p = allocator.allocate(size, 8, "table");
+			blocks.push_back(p);
+			live[p] = size;
+		}
+		else {
+			size_t index = random() % blocks.size();
+			allocator.deallocate(blocks[index]);
+			live.erase(blocks[index]);
+			blocks[index] = blocks.back();
+			blocks.pop_back();
+		}
+	}
+
+	EXPECT_EQ(live.size(), allocator.getLiveAllocations());
+	for (auto [p, size] : live) {
+		ASSERT_NE(nullptr, allocator.find(p));
+		EXPECT_EQ(size, allocator.find(p)->size);
+	}
+	for (void* p : blocks) allocator.deallocate(p);
+	EXPECT_EQ(0, allocator.getLiveAllocations());
+}
+
+TEST(TrackingAllocatorTests, LeakReport) {
+	allocator_tracking::report_handler previous = allocator_tracking::setReportHandler(record_report);
+	allocator_stats::leak_handler previousLeak = allocator_stats::setLeakHandler(nullptr);
+	s_LastReport.clear();
+	{
+		StackAllocator stack(4096);
+		TrackingAllocator allocator(stack);
+		for (uint32 i = 0; i < 3; i++) allocator.allocate(100, 4, "audio");
+		allocator.allocate(500, 4, "render");
+		allocator.setTag("ui");
+		allocator.allocate(10);
+
+		// Sorted from the most bytes to the least
+		std::vector<TrackingAllocator::tag_summary> summaries = allocator.summarize();
+		ASSERT_EQ(3, summaries.size());
+		EXPECT_STREQ("render", summaries[0].tag);
+		EXPECT_STREQ("audio", summaries[1].tag);
+		EXPECT_EQ(3, summaries[1].allocations);
+		EXPECT_EQ(300, summaries[1].bytes);
+		EXPECT_STREQ("ui", summaries[2].tag);
+	}
+	EXPECT_NE(std::string::npos, s_LastReport.find("5 live allocations (810 bytes)"));
+	EXPECT_NE(std::string::npos, s_LastReport.find("audio: 3 allocations (300 bytes)"));
+	EXPECT_NE(std::string::npos, s_LastReport.find("unknown call site: 1 allocations (10 bytes)"));
+	EXPECT_LT(s_LastReport.find("render"), s_LastReport.find("audio"));
+
+	// A tracker without live blocks does not report anything
+	s_LastReport.clear();
+	{
+		MallocAllocator heap;
+		TrackingAllocator allocator(heap);
+		allocator.deallocate(allocator.allocate(10, 4, "audio"));
+	}
+	EXPECT_TRUE(s_LastReport.empty());
+
+	allocator_stats::setLeakHandler(previousLeak);
+	allocator_tracking::setReportHandler(previous);
+}
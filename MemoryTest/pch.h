@@ -9,3 +9,7 @@
 #include "JupiterAllocator.h"
 
 #include <cstdio>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>